@@ -8,10 +8,12 @@
 #include "Components/ResourceStorageComponent.h"
 #include "Data/DepositDefinition.h"
 #include "Core/DataTableManager.h"
+#include "Core/DepositRegistry.h"
+#include "Core/DepositExtractionManager.h"
+#include "Core/DepositMeshStreamer.h"
 #include "Engine/Engine.h"
 #include "DrawDebugHelpers.h"
 #include "Engine/World.h"  // ✅ DODANO
-#include "EngineUtils.h"  // ✅ DODANO: Required for TActorIterator
 
 AResourceDeposit::AResourceDeposit()
 {
@@ -40,6 +42,7 @@ AResourceDeposit::AResourceDeposit()
     LastExtractionTime = 0.0f;
     bAutoExtractToStorage = true;
     ExtractionTickRate = 1.0f;
+    ExtractionMode = EDepositExtractionMode::Batched;
     bShowDebugInfo = false;
     TimeSinceLastExtraction = 0.0f;
     bHasBeenInitialized = false;
@@ -62,13 +65,40 @@ void AResourceDeposit::BeginPlay()
     {
         InitializeWithDefinition(DepositDefinition);
     }
+    
+    RegisterWithDepositRegistry();
+    NotifyExtractionStateChanged();
+}
+
+void AResourceDeposit::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    UnregisterFromDepositRegistry();
+    UnregisterFromExtractionManager();
+
+    if (StorageComponent)
+    {
+        StorageComponent->StopLazyProduction();
+        StorageComponent->OnStorageContentsChanged.Remove(StorageContentsChangedHandle);
+    }
+    
+    Super::EndPlay(EndPlayReason);
+}
+
+void AResourceDeposit::Destroyed()
+{
+    // Złoże zarejestrowane w InitializeWithDefinition przed BeginPlay nie dostaje EndPlay
+    UnregisterFromDepositRegistry();
+    UnregisterFromExtractionManager();
+    
+    Super::Destroyed();
 }
 
 void AResourceDeposit::Tick(float DeltaTime)
 {
     Super::Tick(DeltaTime);
 
-    if (bHasBeenInitialized && !IsDepleted())
+    // W trybach Batched/Lazy aktor tickuje tylko dla debugu
+    if (ExtractionMode == EDepositExtractionMode::ActorTick && bHasBeenInitialized && !IsDepleted())
     {
         TickAutoExtraction(DeltaTime);
     }
@@ -102,12 +132,6 @@ void AResourceDeposit::InitializeWithDefinition(UDepositDefinition* DepositDef)
     CurrentReserves = DepositDef->TotalReserves;
     CurrentLevel = 1;
 
-    // Set mesh from definition
-    if (DepositDef->BaseMesh.LoadSynchronous())
-    {
-        DepositMesh->SetStaticMesh(DepositDef->BaseMesh.LoadSynchronous());
-    }
-
     // Initialize storage component
     if (StorageComponent)
     {
@@ -130,7 +154,11 @@ void AResourceDeposit::InitializeWithDefinition(UDepositDefinition* DepositDef)
     UpdateCollisionSize();
 
     bHasBeenInitialized = true;
+    TimeSinceLastExtraction = 0.0f;
+    ExtractionAccumulator.Reset(GetCurrentExtractionRate());
     UpdateVisualMesh();
+    RegisterWithDepositRegistry();
+    NotifyExtractionStateChanged();
 
     UE_LOG(LogTemp, Log, TEXT("ResourceDeposit: Initialized %s with %d reserves"), 
            *DepositDef->DepositName.ToString(), CurrentReserves);
@@ -145,9 +173,40 @@ void AResourceDeposit::InitializeFromSpawn(UDepositDefinition* DepositDef, int32
         CurrentLevel = InitialLevel;
         UpdateVisualMesh();
         UpdateCollisionSize();  // ✅ DODANO
+        NotifyExtractionStateChanged();
     }
 }
 
+void AResourceDeposit::RestoreSimulationState(int32 Level, int32 Reserves, int32 StoredAmount)
+{
+    if (!bHasBeenInitialized || !DepositDefinition)
+    {
+        UE_LOG(LogTemp, Error, TEXT("ResourceDeposit: Cannot restore simulation state before InitializeWithDefinition"));
+        return;
+    }
+
+    // Produkcja od InitializeWithDefinition nie może potem zejść z odtworzonych rezerw
+    SyncLazyExtraction();
+
+    CurrentLevel = FMath::Clamp(Level, 1, FMath::Max(GetMaxLevel(), 1));
+    UpdateVisualMesh();
+    UpdateCollisionSize();
+
+    if (StorageComponent)
+    {
+        StorageComponent->SetMaxCapacity(GetCurrentLevelData().MaxStorage);
+        StorageComponent->ClearAllResources();
+        if (StoredAmount > 0)
+        {
+            StorageComponent->SetInitialResource(GetResourceType(), StoredAmount);
+        }
+    }
+
+    CurrentReserves = FMath::Max(0, Reserves);
+    ExtractionAccumulator.Reset(GetCurrentExtractionRate());
+    NotifyExtractionStateChanged();
+}
+
 int32 AResourceDeposit::ExtractResource(int32 RequestedAmount)
 {
     if (!bHasBeenInitialized || IsDepleted() || RequestedAmount <= 0)
@@ -155,6 +214,9 @@ int32 AResourceDeposit::ExtractResource(int32 RequestedAmount)
         return 0;
     }
 
+    // Lazy: dotychczasowe wydobycie musi zejść z rezerw, zanim odejmiemy kolejne
+    SyncLazyExtraction();
+
     // Calculate actual amount that can be extracted
     int32 AvailableAmount = GetAvailableResource();
     int32 ActualAmount = FMath::Min(RequestedAmount, AvailableAmount);
@@ -166,6 +228,7 @@ int32 AResourceDeposit::ExtractResource(int32 RequestedAmount)
         {
             CurrentReserves -= ActualAmount;
             CurrentReserves = FMath::Max(0, CurrentReserves);
+            NotifyExtractionStateChanged();
         }
         else
         {
@@ -187,6 +250,55 @@ int32 AResourceDeposit::ExtractResource(int32 RequestedAmount)
     return ActualAmount;
 }
 
+int32 AResourceDeposit::CatchUpExtraction()
+{
+    if (ExtractionMode == EDepositExtractionMode::Batched)
+    {
+        UDepositExtractionManager* ExtractionManager = GetWorld() ? GetWorld()->GetSubsystem<UDepositExtractionManager>() : nullptr;
+        return ExtractionManager ? ExtractionManager->CatchUpDeposit(this) : 0;
+    }
+
+    if (ExtractionMode == EDepositExtractionMode::Lazy)
+    {
+        const int64 PreviousTotal = LastSeenLazyProducedTotal;
+        SyncLazyExtraction();
+        return static_cast<int32>(LastSeenLazyProducedTotal - PreviousTotal);
+    }
+
+    // ActorTick: czas do teraz jest już w akumulatorze (TickAutoExtraction)
+    return StoreAccumulatedExtraction();
+}
+
+int32 AResourceDeposit::AdvanceExtraction(float DeltaSeconds)
+{
+    // Batched / Lazy liczą do teraz własnym zegarem; w ActorTick ten czas i tak trafi do akumulatora
+    const int32 CaughtUpAmount = ExtractionMode != EDepositExtractionMode::ActorTick ? CatchUpExtraction() : 0;
+
+    if (!IsAutoExtractionActive() || !StorageComponent)
+    {
+        return CaughtUpAmount;
+    }
+
+    ExtractionAccumulator.AddTime(FMath::Max(0.0f, DeltaSeconds));
+    return CaughtUpAmount + StoreAccumulatedExtraction();
+}
+
+int32 AResourceDeposit::StoreAccumulatedExtraction()
+{
+    if (!IsAutoExtractionActive() || !StorageComponent)
+    {
+        return 0;
+    }
+
+    // Nadwyżka ponad rezerwy/miejsce w magazynie przepada jak w zwykłym ticku
+    const int64 Produced = ExtractionAccumulator.Collect();
+    const int64 Limit = FMath::Min<int64>(StorageComponent->GetAvailableSpace(GetResourceType()),
+                                          IsRenewable() ? MAX_int32 : CurrentReserves);
+    const int32 Amount = static_cast<int32>(FMath::Clamp<int64>(Produced, 0, Limit));
+
+    return (Amount > 0 && ApplyBatchedExtraction(Amount)) ? Amount : 0;
+}
+
 bool AResourceDeposit::CanExtractResource(int32 RequestedAmount) const
 {
     if (!bHasBeenInitialized || IsDepleted())
@@ -228,7 +340,7 @@ int32 AResourceDeposit::GetAvailableResource() const
     else
     {
         // For non-renewable, return remaining reserves
-        return CurrentReserves;
+        return GetRemainingReserves();
     }
 }
 
@@ -261,6 +373,8 @@ bool AResourceDeposit::UpgradeToLevel(int32 TargetLevel)
         StorageComponent->SetMaxCapacity(LevelData.MaxStorage);
     }
 
+    NotifyExtractionStateChanged();
+
     OnDepositLevelChanged.Broadcast(this, CurrentLevel);
     OnDepositLevelChanged_BP(CurrentLevel);
 
@@ -359,7 +473,7 @@ bool AResourceDeposit::IsDepleted() const
         return false; // Renewable resources never deplete completely
     }
 
-    return CurrentReserves <= 0;
+    return GetRemainingReserves() <= 0;
 }
 
 float AResourceDeposit::GetDepletionPercentage() const
@@ -370,7 +484,7 @@ float AResourceDeposit::GetDepletionPercentage() const
     }
 
     float OriginalReserves = static_cast<float>(DepositDefinition->TotalReserves);
-    float RemainingReserves = static_cast<float>(CurrentReserves);
+    float RemainingReserves = static_cast<float>(GetRemainingReserves());
 
     if (OriginalReserves <= 0.0f)
     {
@@ -425,22 +539,14 @@ bool AResourceDeposit::IsLocationTooCloseToOthers(const FVector& TestLocation, f
         return true;
     }
 
-    // Check distance to other deposits
-    UClass* DepositClass = AResourceDeposit::StaticClass();
-    for (TActorIterator<AResourceDeposit> ActorItr(GetWorld()); ActorItr; ++ActorItr)
+    // Check distance to other deposits (registry spatial index - only neighbouring cells)
+    const UDepositRegistry* DepositRegistry = GetWorld()->GetSubsystem<UDepositRegistry>();
+    if (!DepositRegistry)
     {
-        AResourceDeposit* OtherDeposit = *ActorItr;
-        if (OtherDeposit && OtherDeposit != this)
-        {
-            float Distance = FVector::Dist(OtherDeposit->GetActorLocation(), TestLocation);
-            if (Distance < MinDistance)
-            {
-                return true;
-            }
-        }
+        return false;
     }
 
-    return false;
+    return DepositRegistry->IsAnyDepositWithinRadius(TestLocation, MinDistance, this);
 }
 
 float AResourceDeposit::GetCollisionRadius() const
@@ -448,6 +554,63 @@ float AResourceDeposit::GetCollisionRadius() const
     return CollisionRadius;
 }
 
+bool AResourceDeposit::IsAutoExtractionActive() const
+{
+    return bAutoExtractToStorage && bHasBeenInitialized && !IsDepleted();
+}
+
+bool AResourceDeposit::ApplyBatchedExtraction(int32 Amount)
+{
+    if (Amount <= 0 || !StorageComponent)
+    {
+        return false;
+    }
+
+    // Najpierw magazyn - rezerwy schodzą tylko o to, co faktycznie do niego trafiło
+    if (!StorageComponent->AddResource(GetResourceType(), Amount))
+    {
+        return false;
+    }
+
+    if (!IsRenewable())
+    {
+        CurrentReserves = FMath::Max(0, CurrentReserves - Amount);
+    }
+
+    LastExtractionTime = GetWorld()->GetTimeSeconds();
+    BroadcastExtractionEvent(Amount);
+    CheckForDepletion();
+
+    return true;
+}
+
+void AResourceDeposit::NotifyExtractionStateChanged()
+{
+    // Czas do teraz zostaje policzony starym tempem, dalej obowiązuje nowe
+    ExtractionAccumulator.SetRate(GetCurrentExtractionRate());
+
+    // RegisterDeposit jest idempotentne - ponownie czyta stan złoża
+    if (ExtractionMode == EDepositExtractionMode::Batched)
+    {
+        RegisterWithExtractionManager();
+    }
+    else
+    {
+        UnregisterFromExtractionManager();
+    }
+
+    if (ExtractionMode == EDepositExtractionMode::Lazy)
+    {
+        RestartLazyExtraction();
+    }
+    else if (StorageComponent && StorageComponent->IsLazyProductionActive())
+    {
+        StorageComponent->StopLazyProduction();
+    }
+
+    UpdateActorTickEnabled();
+}
+
 void AResourceDeposit::UpdateVisualMesh()
 {
     if (!DepositDefinition || !DepositMesh)
@@ -460,6 +623,137 @@ void AResourceDeposit::UpdateVisualMesh()
 
 // === PRIVATE FUNCTIONS ===
 
+void AResourceDeposit::RegisterWithDepositRegistry()
+{
+    if (UWorld* World = GetWorld())
+    {
+        if (UDepositRegistry* DepositRegistry = World->GetSubsystem<UDepositRegistry>())
+        {
+            DepositRegistry->RegisterDeposit(this);
+        }
+    }
+}
+
+void AResourceDeposit::UnregisterFromDepositRegistry()
+{
+    if (UWorld* World = GetWorld())
+    {
+        if (UDepositRegistry* DepositRegistry = World->GetSubsystem<UDepositRegistry>())
+        {
+            DepositRegistry->UnregisterDeposit(this);
+        }
+    }
+}
+
+void AResourceDeposit::RegisterWithExtractionManager()
+{
+    if (ExtractionMode != EDepositExtractionMode::Batched || !bHasBeenInitialized)
+    {
+        return;
+    }
+
+    if (UWorld* World = GetWorld())
+    {
+        if (UDepositExtractionManager* ExtractionManager = World->GetSubsystem<UDepositExtractionManager>())
+        {
+            ExtractionManager->RegisterDeposit(this);
+        }
+    }
+}
+
+void AResourceDeposit::UnregisterFromExtractionManager()
+{
+    if (UWorld* World = GetWorld())
+    {
+        if (UDepositExtractionManager* ExtractionManager = World->GetSubsystem<UDepositExtractionManager>())
+        {
+            ExtractionManager->UnregisterDeposit(this);
+        }
+    }
+}
+
+void AResourceDeposit::UpdateActorTickEnabled()
+{
+    if (!HasActorBegunPlay())
+    {
+        return;
+    }
+
+    SetActorTickEnabled(ExtractionMode == EDepositExtractionMode::ActorTick || bShowDebugInfo || bShowCollisionRadius);
+}
+
+void AResourceDeposit::RestartLazyExtraction()
+{
+    if (!StorageComponent)
+    {
+        return;
+    }
+
+    if (!StorageContentsChangedHandle.IsValid())
+    {
+        StorageContentsChangedHandle = StorageComponent->OnStorageContentsChanged.AddUObject(this, &AResourceDeposit::HandleStorageContentsChanged);
+    }
+
+    if (!IsAutoExtractionActive())
+    {
+        StorageComponent->StopLazyProduction();
+        return;
+    }
+
+    // StartLazyProduction najpierw zapisuje dotychczasową produkcję (handler zdejmie ją z rezerw),
+    // więc limit liczymy dopiero po synchronizacji
+    SyncLazyExtraction();
+
+    const int32 ProductionLimit = IsRenewable() ? -1 : CurrentReserves;
+    StorageComponent->StartLazyProduction(GetResourceType(), GetCurrentExtractionRate(), ProductionLimit);
+}
+
+void AResourceDeposit::SyncLazyExtraction()
+{
+    if (ExtractionMode == EDepositExtractionMode::Lazy && StorageComponent)
+    {
+        // Materializacja wywoła HandleStorageContentsChanged, jeśli coś przybyło
+        StorageComponent->MaterializeLazyProduction();
+    }
+}
+
+void AResourceDeposit::HandleStorageContentsChanged(UResourceStorageComponent* Storage, const FDataTableRowHandle& ResourceType)
+{
+    const int64 ProducedTotal = Storage->GetLazyMaterializedTotal();
+    const int32 Amount = static_cast<int32>(ProducedTotal - LastSeenLazyProducedTotal);
+    if (Amount <= 0)
+    {
+        return;
+    }
+
+    LastSeenLazyProducedTotal = ProducedTotal;
+
+    if (!IsRenewable())
+    {
+        CurrentReserves = FMath::Max(0, CurrentReserves - Amount);
+    }
+
+    LastExtractionTime = GetWorld() ? GetWorld()->GetTimeSeconds() : 0.0f;
+    BroadcastExtractionEvent(Amount);
+
+    // Limit produkcji w magazynie to dokładnie rezerwy, więc timer odpala w chwili wyczerpania
+    if (!IsRenewable() && CurrentReserves <= 0)
+    {
+        CheckForDepletion();
+    }
+}
+
+int32 AResourceDeposit::GetRemainingReserves() const
+{
+    // Lazy: część rezerw mogła już zostać wydobyta, ale jeszcze nie zapisana w magazynie
+    if (ExtractionMode == EDepositExtractionMode::Lazy && StorageComponent && !IsRenewable())
+    {
+        return FMath::Max(0, CurrentReserves - StorageComponent->GetLazyPendingAmount());
+    }
+
+    return CurrentReserves;
+}
+
 void AResourceDeposit::SetupCollision()
 {
     if (!CollisionComponent)
@@ -514,39 +808,14 @@ void AResourceDeposit::TickAutoExtraction(float DeltaTime)
         return;
     }
 
+    // Czas trafia do akumulatora co klatkę (zmiana poziomu liczy się od właściwej chwili),
+    // a ułamki w nim zostają - ExtractionTickRate zmienia tylko częstotliwość, nie sumę wydobycia
+    ExtractionAccumulator.AddTime(DeltaTime);
     TimeSinceLastExtraction += DeltaTime;
 
     if (TimeSinceLastExtraction >= ExtractionTickRate)
     {
-        float ExtractionRate = GetCurrentExtractionRate();
-        int32 ExtractAmount = FMath::RoundToInt(ExtractionRate * ExtractionTickRate);
-
-        if (ExtractAmount > 0 && StorageComponent)
-        {
-            // For renewable resources, generate directly to storage
-            if (IsRenewable())
-            {
-                // Check if we have space in storage
-                int32 SpaceAvailable = StorageComponent->GetAvailableSpace(GetResourceType());
-                int32 ActualAmount = FMath::Min(ExtractAmount, SpaceAvailable);
-                
-                if (ActualAmount > 0)
-                {
-                    StorageComponent->AddResource(GetResourceType(), ActualAmount);
-                    BroadcastExtractionEvent(ActualAmount);
-                }
-            }
-            else
-            {
-                // For non-renewable, extract from reserves to storage
-                int32 ActualExtracted = ExtractResource(ExtractAmount);
-                if (ActualExtracted > 0)
-                {
-                    StorageComponent->AddResource(GetResourceType(), ActualExtracted);
-                }
-            }
-        }
-
+        CatchUpExtraction();
         TimeSinceLastExtraction = 0.0f;
     }
 
@@ -560,22 +829,42 @@ void AResourceDeposit::UpdateMeshForLevel()
         return;
     }
 
-    // Get level-specific mesh if available
-    if (CurrentLevel <= DepositDefinition->DepositLevels.Num())
+    // Level mesh if available, otherwise base mesh
+    const TSoftObjectPtr<UStaticMesh> LevelMesh = DepositDefinition->GetLevelMesh(CurrentLevel);
+    if (LevelMesh.IsNull())
     {
-        const FDepositLevel& LevelData = DepositDefinition->DepositLevels[CurrentLevel - 1];
-        if (LevelData.LevelMesh.LoadSynchronous())
-        {
-            DepositMesh->SetStaticMesh(LevelData.LevelMesh.LoadSynchronous());
-            return;
-        }
+        return;
     }
 
-    // Fallback to base mesh
-    if (DepositDefinition->BaseMesh.LoadSynchronous())
+    UWorld* World = GetWorld();
+    UDepositMeshStreamer* MeshStreamer = World ? World->GetSubsystem<UDepositMeshStreamer>() : nullptr;
+    if (!MeshStreamer)
     {
-        DepositMesh->SetStaticMesh(DepositDefinition->BaseMesh.LoadSynchronous());
+        // Bez świata (np. CDO / edytor) nie ma streamera - ładujemy synchronicznie jak dawniej
+        DepositMesh->SetStaticMesh(LevelMesh.LoadSynchronous());
+        return;
+    }
+
+    if (UStaticMesh* LoadedMesh = LevelMesh.Get())
+    {
+        DepositMesh->SetStaticMesh(LoadedMesh);
+        return;
+    }
+
+    if (MeshStreamer->AreDefinitionMeshesLoaded(DepositDefinition))
+    {
+        // Ładowanie zakończone, a mesha nadal brak (zła ścieżka) - base mesh albo placeholder, bez ponawiania
+        UStaticMesh* FallbackMesh = DepositDefinition->BaseMesh.Get();
+        DepositMesh->SetStaticMesh(FallbackMesh ? FallbackMesh : MeshStreamer->GetPlaceholderMesh());
+        return;
     }
+
+    // Placeholder do czasu załadowania - żądania są deduplikowane per definicja
+    DepositMesh->SetStaticMesh(MeshStreamer->GetPlaceholderMesh());
+    MeshStreamer->RequestDefinitionMeshes(DepositDefinition, FSimpleDelegate::CreateWeakLambda(this, [this]()
+    {
+        UpdateMeshForLevel();
+    }));
 }
 
 void AResourceDeposit::RegenerateResource(float DeltaTime)
@@ -585,19 +874,12 @@ void AResourceDeposit::RegenerateResource(float DeltaTime)
 
 FDepositLevel AResourceDeposit::GetCurrentLevelData() const
 {
-    if (!DepositDefinition || CurrentLevel <= 0 || CurrentLevel > DepositDefinition->DepositLevels.Num())
+    if (!DepositDefinition)
     {
-        // Return default level data
-        FDepositLevel DefaultLevel;
-        DefaultLevel.Level = 1;
-        DefaultLevel.ExtractionRate = 1.0f;
-        DefaultLevel.MaxStorage = 100;
-        DefaultLevel.EnergyConsumption = 1.0f;
-        DefaultLevel.UpgradeCost = 1000.0f;
-        return DefaultLevel;
+        return FDepositLevel();
     }
 
-    return DepositDefinition->DepositLevels[CurrentLevel - 1];
+    return DepositDefinition->GetLevelData(CurrentLevel);
 }
 
 void AResourceDeposit::BroadcastExtractionEvent(int32 Amount)
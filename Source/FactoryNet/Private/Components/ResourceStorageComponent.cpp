@@ -3,8 +3,10 @@
 
 #include "Components/ResourceStorageComponent.h"
 #include "Core/DataTableManager.h"
+#include "Core/StorageEventSubsystem.h"
 #include "Engine/Engine.h"
 #include "Engine/World.h"
+#include "TimerManager.h"
 
 UResourceStorageComponent::UResourceStorageComponent()
 {
@@ -15,26 +17,54 @@ UResourceStorageComponent::UResourceStorageComponent()
     bAllowOverflow = false;
 }
 
+void UResourceStorageComponent::PostLoad()
+{
+    Super::PostLoad();
+    RebuildSlotIndex();
+}
+
+void UResourceStorageComponent::PostDuplicate(bool bDuplicateForPIE)
+{
+    Super::PostDuplicate(bDuplicateForPIE);
+    RebuildSlotIndex();
+}
+
+void UResourceStorageComponent::PostEditImport()
+{
+    Super::PostEditImport();
+    RebuildSlotIndex();
+}
+
 void UResourceStorageComponent::BeginPlay()
 {
     Super::BeginPlay();
     
+    // Indeks i suma nie są serializowane - odbuduj z tablic slotów
+    RebuildSlotIndex();
+    
     // Initialize with default resource if set
     if (bSingleResourceMode && IsValidResourceReference(StoredResourceType))
     {
         // Ensure we have an entry for the stored resource type
-        if (FindResourceIndex(StoredResourceType) == INDEX_NONE)
-        {
-            FStoredResource NewResource;
-            NewResource.ResourceReference = StoredResourceType;
-            NewResource.Quantity = 0;
-            StoredResources.Add(NewResource);
-        }
+        FindOrAddSlot(StoredResourceType);
+    }
+}
+
+void UResourceStorageComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (UWorld* World = GetWorld())
+    {
+        World->GetTimerManager().ClearTimer(LazyProductionTimer);
+        World->GetTimerManager().ClearTimer(BatchChangedTimer);
     }
+
+    Super::EndPlay(EndPlayReason);
 }
 
 bool UResourceStorageComponent::AddResource(const FDataTableRowHandle& ResourceType, int32 Amount)
 {
+    MaterializeLazyProduction();
+
     if (Amount <= 0 || !IsValidResourceReference(ResourceType))
     {
         return false;
@@ -47,26 +77,8 @@ bool UResourceStorageComponent::AddResource(const FDataTableRowHandle& ResourceT
         return false;
     }
 
-    int32 ResourceIndex = FindResourceIndex(ResourceType);
-    int32 OldAmount = 0;
-    
-    if (ResourceIndex == INDEX_NONE)
-    {
-        // Create new resource entry
-        FStoredResource NewResource;
-        NewResource.ResourceReference = ResourceType;
-        NewResource.Quantity = 0;
-        StoredResources.Add(NewResource);
-        ResourceIndex = StoredResources.Num() - 1;
-    }
-    else
-    {
-        OldAmount = StoredResources[ResourceIndex].Quantity;
-    }
-
     // Check capacity constraints
-    int32 CurrentTotal = GetTotalStoredResources();
-    int32 AvailableSpace = MaxCapacity - CurrentTotal;
+    int32 AvailableSpace = MaxCapacity - StoredTotal;
     
     if (!bAllowOverflow && Amount > AvailableSpace)
     {
@@ -79,8 +91,10 @@ bool UResourceStorageComponent::AddResource(const FDataTableRowHandle& ResourceT
     }
 
     // Add the resource
-    StoredResources[ResourceIndex].Quantity += Amount;
-    int32 NewAmount = StoredResources[ResourceIndex].Quantity;
+    const int32 Slot = FindOrAddSlot(ResourceType);
+    int32 OldAmount = SlotAmounts[Slot];
+    int32 NewAmount = OldAmount + Amount;
+    SetSlotAmount(Slot, NewAmount);
 
     // Broadcast events
     BroadcastStorageEvents(ResourceType, OldAmount, NewAmount, true);
@@ -93,18 +107,20 @@ bool UResourceStorageComponent::AddResource(const FDataTableRowHandle& ResourceT
 
 int32 UResourceStorageComponent::RemoveResource(const FDataTableRowHandle& ResourceType, int32 Amount)
 {
+    MaterializeLazyProduction();
+
     if (Amount <= 0 || !IsValidResourceReference(ResourceType))
     {
         return 0;
     }
 
-    int32 ResourceIndex = FindResourceIndex(ResourceType);
-    if (ResourceIndex == INDEX_NONE)
+    const int32 Slot = FindSlot(ResourceType);
+    if (Slot == INDEX_NONE)
     {
         return 0;
     }
 
-    int32 OldAmount = StoredResources[ResourceIndex].Quantity;
+    int32 OldAmount = SlotAmounts[Slot];
     int32 ActualRemoved = FMath::Min(Amount, OldAmount);
     
     if (ActualRemoved <= 0)
@@ -112,13 +128,13 @@ int32 UResourceStorageComponent::RemoveResource(const FDataTableRowHandle& Resou
         return 0;
     }
 
-    StoredResources[ResourceIndex].Quantity -= ActualRemoved;
-    int32 NewAmount = StoredResources[ResourceIndex].Quantity;
+    int32 NewAmount = OldAmount - ActualRemoved;
+    SetSlotAmount(Slot, NewAmount);
 
     // Remove entry if empty and not in single resource mode
     if (NewAmount <= 0 && !bSingleResourceMode)
     {
-        StoredResources.RemoveAt(ResourceIndex);
+        RemoveSlot(Slot);
         NewAmount = 0;
     }
 
@@ -150,8 +166,7 @@ bool UResourceStorageComponent::CanStoreResource(const FDataTableRowHandle& Reso
         return true;
     }
 
-    int32 CurrentTotal = GetTotalStoredResources();
-    return (CurrentTotal + Amount) <= MaxCapacity;
+    return (GetTotalStoredResources() + Amount) <= MaxCapacity;
 }
 
 bool UResourceStorageComponent::HasResource(const FDataTableRowHandle& ResourceType, int32 Amount) const
@@ -161,12 +176,14 @@ bool UResourceStorageComponent::HasResource(const FDataTableRowHandle& ResourceT
 
 int32 UResourceStorageComponent::GetCurrentAmount(const FDataTableRowHandle& ResourceType) const
 {
-    int32 ResourceIndex = FindResourceIndex(ResourceType);
-    if (ResourceIndex != INDEX_NONE)
+    const int32 Slot = FindSlot(ResourceType);
+    int32 Amount = Slot != INDEX_NONE ? SlotAmounts[Slot] : 0;
+
+    if (bLazyProductionActive && LazyResourceType.RowName == ResourceType.RowName)
     {
-        return StoredResources[ResourceIndex].Quantity;
+        Amount += GetLazyPendingAmount();
     }
-    return 0;
+    return Amount;
 }
 
 int32 UResourceStorageComponent::GetAvailableSpace(const FDataTableRowHandle& ResourceType) const
@@ -181,23 +198,51 @@ int32 UResourceStorageComponent::GetAvailableSpace(const FDataTableRowHandle& Re
         return INT32_MAX;
     }
 
-    int32 CurrentTotal = GetTotalStoredResources();
-    return FMath::Max(0, MaxCapacity - CurrentTotal);
+    return FMath::Max(0, MaxCapacity - GetTotalStoredResources());
 }
 
 int32 UResourceStorageComponent::GetTotalStoredResources() const
 {
-    int32 Total = 0;
-    for (const FStoredResource& Resource : StoredResources)
+    // StoredTotal jest utrzymywany przy każdej zmianie slotu - bez sumowania
+    return StoredTotal + GetLazyPendingAmount();
+}
+
+TArray<FStoredResource> UResourceStorageComponent::GetStoredResources() const
+{
+    TArray<FStoredResource> Result;
+    Result.Reserve(SlotResources.Num());
+
+    for (int32 Slot = 0; Slot < SlotResources.Num(); ++Slot)
     {
-        Total += Resource.Quantity;
+        FStoredResource& Resource = Result.AddDefaulted_GetRef();
+        Resource.ResourceReference = SlotResources[Slot];
+        Resource.Quantity = SlotAmounts[Slot];
     }
-    return Total;
+
+    return Result;
 }
 
 TArray<FStoredResource> UResourceStorageComponent::GetAllStoredResources() const
 {
-    return StoredResources;
+    TArray<FStoredResource> Result = GetStoredResources();
+
+    const int32 PendingAmount = GetLazyPendingAmount();
+    if (PendingAmount > 0)
+    {
+        const int32 LazySlot = FindSlot(LazyResourceType);
+        if (LazySlot != INDEX_NONE)
+        {
+            Result[LazySlot].Quantity += PendingAmount;
+        }
+        else
+        {
+            FStoredResource& Resource = Result.AddDefaulted_GetRef();
+            Resource.ResourceReference = LazyResourceType;
+            Resource.Quantity = PendingAmount;
+        }
+    }
+
+    return Result;
 }
 
 bool UResourceStorageComponent::IsEmpty() const
@@ -216,7 +261,11 @@ bool UResourceStorageComponent::IsFull() const
 
 void UResourceStorageComponent::SetMaxCapacity(int32 NewMaxCapacity)
 {
+    // Produkcja do tej chwili liczy się jeszcze ze starą pojemnością
+    MaterializeLazyProduction();
+
     MaxCapacity = FMath::Max(0, NewMaxCapacity);
+    NotifyContentsChanged(FDataTableRowHandle());
     
     UE_LOG(LogTemp, Log, TEXT("ResourceStorageComponent: Set max capacity to %d"), MaxCapacity);
 }
@@ -229,21 +278,26 @@ void UResourceStorageComponent::SetResourceType(const FDataTableRowHandle& NewRe
         return;
     }
 
+    if (bLazyProductionActive && LazyResourceType.RowName != NewResourceType.RowName)
+    {
+        StopLazyProduction();
+    }
+    MaterializeLazyProduction();
+
     StoredResourceType = NewResourceType;
     
     // Clear existing resources and add new type
-    StoredResources.Empty();
+    ResetSlots();
     
     if (IsValidResourceReference(NewResourceType))
     {
-        FStoredResource NewResource;
-        NewResource.ResourceReference = NewResourceType;
-        NewResource.Quantity = 0;
-        StoredResources.Add(NewResource);
+        FindOrAddSlot(NewResourceType);
         
         UE_LOG(LogTemp, Log, TEXT("ResourceStorageComponent: Set resource type to %s"), 
                *NewResourceType.RowName.ToString());
     }
+
+    NotifyContentsChanged(FDataTableRowHandle());
 }
 
 void UResourceStorageComponent::SetSingleResourceMode(bool bSingleResource)
@@ -253,19 +307,24 @@ void UResourceStorageComponent::SetSingleResourceMode(bool bSingleResource)
         return;
     }
 
+    MaterializeLazyProduction();
+
     bSingleResourceMode = bSingleResource;
     
     if (bSingleResourceMode)
     {
         // Keep only the first resource
-        if (StoredResources.Num() > 1)
+        if (SlotResources.Num() > 1)
         {
-            FStoredResource FirstResource = StoredResources[0];
-            StoredResources.Empty();
-            StoredResources.Add(FirstResource);
-            StoredResourceType = FirstResource.ResourceReference;
+            const FDataTableRowHandle FirstResource = SlotResources[0];
+            const int32 FirstAmount = SlotAmounts[0];
+            ResetSlots();
+            SetSlotAmount(FindOrAddSlot(FirstResource), FirstAmount);
+            StoredResourceType = FirstResource;
         }
     }
+
+    NotifyContentsChanged(FDataTableRowHandle());
     
     UE_LOG(LogTemp, Log, TEXT("ResourceStorageComponent: Set single resource mode to %s"), 
            bSingleResource ? TEXT("true") : TEXT("false"));
@@ -275,28 +334,38 @@ void UResourceStorageComponent::SetSingleResourceMode(bool bSingleResource)
 
 void UResourceStorageComponent::ClearAllResources()
 {
-    TArray<FStoredResource> OldResources = StoredResources;
+    MaterializeLazyProduction();
+
+    TArray<FStoredResource> OldResources = GetAllStoredResources();
     
-    for (FStoredResource& Resource : StoredResources)
+    for (int32 Slot = 0; Slot < SlotAmounts.Num(); ++Slot)
     {
-        Resource.Quantity = 0;
+        SetSlotAmount(Slot, 0);
     }
 
     // Remove empty entries in multi-resource mode
     if (!bSingleResourceMode)
     {
-        StoredResources.Empty();
+        ResetSlots();
     }
 
     // Broadcast events for cleared resources
+    NotifyContentsChanged(FDataTableRowHandle());
+
     for (const FStoredResource& OldResource : OldResources)
     {
-        if (OldResource.Quantity > 0)
+        if (OldResource.Quantity <= 0)
+        {
+            continue;
+        }
+
+        if (bDeferStorageEvents)
         {
-            OnStorageChanged.Broadcast(OldResource.ResourceReference, 0, MaxCapacity);
-            OnResourceRemoved.Broadcast(OldResource.ResourceReference, OldResource.Quantity);
-            OnStorageChanged_BP(OldResource.ResourceReference, 0, MaxCapacity);
-            OnResourceRemoved_BP(OldResource.ResourceReference, OldResource.Quantity);
+            RecordDeferredChange(OldResource.ResourceReference, OldResource.Quantity);
+        }
+        else
+        {
+            BroadcastResourceEvents(OldResource.ResourceReference, OldResource.Quantity, 0);
         }
     }
 
@@ -353,6 +422,73 @@ bool UResourceStorageComponent::TransferResourceTo(UResourceStorageComponent* Ta
     return false;
 }
 
+// === BULK TRANSFER ===
+
+bool UResourceStorageComponent::TransferManyTo(UResourceStorageComponent* TargetStorage, TArrayView<const FCargoItem> Items)
+{
+    if (!TargetStorage || TargetStorage == this)
+    {
+        return false;
+    }
+
+    // Walidacja musi widzieć aktualne ilości (także produkcję lazy)
+    MaterializeLazyProduction();
+    TargetStorage->MaterializeLazyProduction();
+
+    FMergedCargo Merged;
+    if (!MergeCargoItems(Items, Merged) || !ValidateTransfer(TargetStorage, Merged))
+    {
+        return false;
+    }
+
+    if (Merged.Num() == 0)
+    {
+        return true;
+    }
+
+    for (const FCargoItem& Item : Merged)
+    {
+        const int32 SourceSlot = FindSlot(Item.ResourceReference);
+        const int32 NewSourceAmount = SlotAmounts[SourceSlot] - Item.Quantity;
+        SetSlotAmount(SourceSlot, NewSourceAmount);
+        if (NewSourceAmount <= 0 && !bSingleResourceMode)
+        {
+            RemoveSlot(SourceSlot);
+        }
+
+        const int32 TargetSlot = TargetStorage->FindOrAddSlot(Item.ResourceReference);
+        TargetStorage->SetSlotAmount(TargetSlot, TargetStorage->SlotAmounts[TargetSlot] + Item.Quantity);
+    }
+
+    for (const FCargoItem& Item : Merged)
+    {
+        NotifyContentsChanged(Item.ResourceReference);
+        TargetStorage->NotifyContentsChanged(Item.ResourceReference);
+    }
+    QueueBatchChangedNotification();
+    TargetStorage->QueueBatchChangedNotification();
+
+    UE_LOG(LogTemp, VeryVerbose, TEXT("ResourceStorageComponent: Transferred %d resource types in one batch"), Merged.Num());
+
+    return true;
+}
+
+bool UResourceStorageComponent::TransferCargoTo(UResourceStorageComponent* TargetStorage, const TArray<FCargoItem>& Cargo)
+{
+    return TransferManyTo(TargetStorage, Cargo);
+}
+
+bool UResourceStorageComponent::CanTransferCargoTo(const UResourceStorageComponent* TargetStorage, const TArray<FCargoItem>& Cargo) const
+{
+    if (!TargetStorage || TargetStorage == this)
+    {
+        return false;
+    }
+
+    FMergedCargo Merged;
+    return MergeCargoItems(Cargo, Merged) && ValidateTransfer(TargetStorage, Merged);
+}
+
 void UResourceStorageComponent::SetInitialResource(const FDataTableRowHandle& ResourceType, int32 Amount)
 {
     if (Amount < 0 || !IsValidResourceReference(ResourceType))
@@ -360,48 +496,339 @@ void UResourceStorageComponent::SetInitialResource(const FDataTableRowHandle& Re
         return;
     }
 
+    MaterializeLazyProduction();
+
     if (bSingleResourceMode)
     {
         StoredResourceType = ResourceType;
-        StoredResources.Empty();
-        
-        FStoredResource NewResource;
-        NewResource.ResourceReference = ResourceType;
-        NewResource.Quantity = Amount;
-        StoredResources.Add(NewResource);
+        ResetSlots();
+    }
+
+    SetSlotAmount(FindOrAddSlot(ResourceType), Amount);
+
+    // W trybie jednego zasobu poprzednia zawartość zniknęła - to zmiana całego magazynu
+    NotifyContentsChanged(bSingleResourceMode ? FDataTableRowHandle() : ResourceType);
+
+    UE_LOG(LogTemp, Log, TEXT("ResourceStorageComponent: Set initial resource %s to %d"), 
+           *ResourceType.RowName.ToString(), Amount);
+}
+
+// === LAZY PRODUCTION ===
+
+void UResourceStorageComponent::StartLazyProduction(const FDataTableRowHandle& ResourceType, double RatePerSecond, int32 ProductionLimit)
+{
+    if (!IsValidResourceReference(ResourceType) || !CanAcceptResourceType(ResourceType))
+    {
+        StopLazyProduction();
+        return;
+    }
+
+    // Dotychczasowa produkcja trafia do magazynu, ułamek zostaje przy tym samym zasobie
+    MaterializeLazyProduction();
+
+    if (bLazyProductionActive && LazyResourceType.RowName == ResourceType.RowName)
+    {
+        LazyAccumulator.SetRate(RatePerSecond);
     }
     else
     {
-        int32 ResourceIndex = FindResourceIndex(ResourceType);
-        if (ResourceIndex == INDEX_NONE)
+        LazyAccumulator.Reset(RatePerSecond);
+    }
+
+    bLazyProductionActive = true;
+    LazyResourceType = ResourceType;
+    LazyLastUpdateTime = GetWorldTimeSeconds();
+    LazyLimitRemaining = ProductionLimit < 0 ? MAX_int32 : ProductionLimit;
+
+    ScheduleLazyProductionTimer();
+}
+
+void UResourceStorageComponent::StopLazyProduction()
+{
+    if (!bLazyProductionActive)
+    {
+        return;
+    }
+
+    MaterializeLazyProduction();
+
+    bLazyProductionActive = false;
+    LazyAccumulator.Reset();
+
+    if (UWorld* World = GetWorld())
+    {
+        World->GetTimerManager().ClearTimer(LazyProductionTimer);
+    }
+}
+
+void UResourceStorageComponent::MaterializeLazyProduction()
+{
+    if (!bLazyProductionActive)
+    {
+        return;
+    }
+
+    const double Now = GetWorldTimeSeconds();
+    LazyAccumulator.AddTime(Now - LazyLastUpdateTime);
+    LazyLastUpdateTime = Now;
+
+    // Nadwyżka ponad wolne miejsce przepada - tak samo jak przy wydobyciu w ticku
+    const int32 FreeSpace = bAllowOverflow ? MAX_int32 : FMath::Max(0, MaxCapacity - StoredTotal);
+    const int32 Amount = static_cast<int32>(FMath::Clamp<int64>(LazyAccumulator.Collect(), 0, FMath::Min(FreeSpace, LazyLimitRemaining)));
+    if (Amount <= 0)
+    {
+        return;
+    }
+
+    const int32 Slot = FindOrAddSlot(LazyResourceType);
+    const int32 OldAmount = SlotAmounts[Slot];
+    SetSlotAmount(Slot, OldAmount + Amount);
+    LazyLimitRemaining -= Amount;
+    LazyMaterializedTotal += Amount;
+
+    BroadcastStorageEvents(LazyResourceType, OldAmount, OldAmount + Amount, true);
+}
+
+int32 UResourceStorageComponent::GetLazyPendingAmount() const
+{
+    if (!bLazyProductionActive)
+    {
+        return 0;
+    }
+
+    const int32 FreeSpace = bAllowOverflow ? MAX_int32 : FMath::Max(0, MaxCapacity - StoredTotal);
+    const int64 Produced = LazyAccumulator.PeekUnits(GetWorldTimeSeconds() - LazyLastUpdateTime);
+    return static_cast<int32>(FMath::Clamp<int64>(Produced, 0, FMath::Min(FreeSpace, LazyLimitRemaining)));
+}
+
+// === PRIVATE HELPER FUNCTIONS ===
+
+double UResourceStorageComponent::GetWorldTimeSeconds() const
+{
+    const UWorld* World = GetWorld();
+    return World ? World->GetTimeSeconds() : 0.0;
+}
+
+void UResourceStorageComponent::ScheduleLazyProductionTimer()
+{
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        return;
+    }
+
+    FTimerManager& TimerManager = World->GetTimerManager();
+    TimerManager.ClearTimer(LazyProductionTimer);
+
+    if (!bLazyProductionActive)
+    {
+        return;
+    }
+
+    // Jedyny moment, w którym coś musi się wydarzyć bez odczytu: magazyn pełny albo limit wyczerpany
+    const int32 FreeSpace = bAllowOverflow ? MAX_int32 : FMath::Max(0, MaxCapacity - StoredTotal);
+    const int32 StopAmount = FMath::Min(FreeSpace, LazyLimitRemaining);
+    if (StopAmount <= 0 || StopAmount == MAX_int32)
+    {
+        return;
+    }
+
+    const double ElapsedSinceUpdate = GetWorldTimeSeconds() - LazyLastUpdateTime;
+    const double SecondsUntilStop = LazyAccumulator.GetSecondsUntilUnits(StopAmount) - ElapsedSinceUpdate;
+    if (SecondsUntilStop >= static_cast<double>(MAX_flt))
+    {
+        return;
+    }
+
+    TimerManager.SetTimer(LazyProductionTimer, this, &UResourceStorageComponent::HandleLazyProductionTimer,
+                          FMath::Max(static_cast<float>(SecondsUntilStop), KINDA_SMALL_NUMBER), false);
+}
+
+void UResourceStorageComponent::HandleLazyProductionTimer()
+{
+    MaterializeLazyProduction();
+
+    // Timer mógł odpalić odrobinę za wcześnie - wtedy ustawiamy go ponownie na resztę
+    ScheduleLazyProductionTimer();
+}
+
+bool UResourceStorageComponent::MergeCargoItems(TArrayView<const FCargoItem> Items, FMergedCargo& OutMerged) const
+{
+    OutMerged.Reset();
+
+    for (const FCargoItem& Item : Items)
+    {
+        if (Item.Quantity < 0 || (Item.Quantity > 0 && !IsValidResourceReference(Item.ResourceReference)))
         {
-            FStoredResource NewResource;
-            NewResource.ResourceReference = ResourceType;
-            NewResource.Quantity = Amount;
-            StoredResources.Add(NewResource);
+            return false;
+        }
+
+        if (Item.Quantity == 0)
+        {
+            continue;
+        }
+
+        // Manifesty są krótkie - liniowe scalanie duplikatów wystarcza
+        FCargoItem* Existing = OutMerged.FindByPredicate([&Item](const FCargoItem& MergedItem)
+        {
+            return MergedItem.ResourceReference.RowName == Item.ResourceReference.RowName;
+        });
+
+        if (Existing)
+        {
+            Existing->Quantity += Item.Quantity;
         }
         else
         {
-            StoredResources[ResourceIndex].Quantity = Amount;
+            OutMerged.Add(Item);
         }
     }
 
-    UE_LOG(LogTemp, Log, TEXT("ResourceStorageComponent: Set initial resource %s to %d"), 
-           *ResourceType.RowName.ToString(), Amount);
+    return true;
 }
 
-// === PRIVATE HELPER FUNCTIONS ===
+bool UResourceStorageComponent::ValidateTransfer(const UResourceStorageComponent* TargetStorage, const FMergedCargo& Merged) const
+{
+    int64 IncomingTotal = 0;
+
+    for (const FCargoItem& Item : Merged)
+    {
+        if (GetCurrentAmount(Item.ResourceReference) < Item.Quantity)
+        {
+            return false;
+        }
+
+        if (!TargetStorage->CanAcceptResourceType(Item.ResourceReference))
+        {
+            return false;
+        }
+
+        IncomingTotal += Item.Quantity;
+    }
+
+    // Single resource mode przyjmuje jeden typ - kilka różnych pozycji to błąd
+    if (TargetStorage->bSingleResourceMode && TargetStorage->StoredResourceType.RowName.IsNone() && Merged.Num() > 1)
+    {
+        return false;
+    }
 
-int32 UResourceStorageComponent::FindResourceIndex(const FDataTableRowHandle& ResourceType) const
+    return TargetStorage->bAllowOverflow || IncomingTotal <= TargetStorage->MaxCapacity - TargetStorage->GetTotalStoredResources();
+}
+
+void UResourceStorageComponent::QueueBatchChangedNotification()
 {
-    for (int32 i = 0; i < StoredResources.Num(); ++i)
+    if (bBatchChangedPending)
+    {
+        return;
+    }
+
+    UWorld* World = GetWorld();
+    if (!World)
     {
-        if (StoredResources[i].ResourceReference.RowName == ResourceType.RowName)
+        FlushBatchChangedNotification();
+        return;
+    }
+
+    // Jedna notyfikacja na komponent na klatkę, niezależnie od liczby transferów
+    bBatchChangedPending = true;
+    BatchChangedTimer = World->GetTimerManager().SetTimerForNextTick(this, &UResourceStorageComponent::FlushBatchChangedNotification);
+}
+
+void UResourceStorageComponent::FlushBatchChangedNotification()
+{
+    bBatchChangedPending = false;
+
+    OnStorageBatchChanged.Broadcast(this);
+    OnStorageBatchChanged_BP();
+}
+
+void UResourceStorageComponent::NotifyContentsChanged(const FDataTableRowHandle& ResourceType)
+{
+    ScheduleLazyProductionTimer();
+    OnStorageContentsChanged.Broadcast(this, ResourceType);
+}
+
+int32 UResourceStorageComponent::FindSlot(const FDataTableRowHandle& ResourceType) const
+{
+    const int32* Slot = SlotByResource.Find(ResourceType.RowName);
+    return Slot ? *Slot : INDEX_NONE;
+}
+
+int32 UResourceStorageComponent::FindOrAddSlot(const FDataTableRowHandle& ResourceType)
+{
+    if (const int32* ExistingSlot = SlotByResource.Find(ResourceType.RowName))
+    {
+        return *ExistingSlot;
+    }
+
+    const int32 Slot = SlotResources.Add(ResourceType);
+    SlotAmounts.Add(0);
+    SlotByResource.Add(ResourceType.RowName, Slot);
+    return Slot;
+}
+
+void UResourceStorageComponent::RebuildSlotIndex()
+{
+    // Stare zapisy mogą mieć tablice różnej długości albo zduplikowane sloty - scal je
+    const int32 NumSlots = FMath::Min(SlotResources.Num(), SlotAmounts.Num());
+    SlotResources.SetNum(NumSlots);
+    SlotAmounts.SetNum(NumSlots);
+
+    SlotByResource.Reset();
+    StoredTotal = 0;
+
+    int32 NumKept = 0;
+    for (int32 Slot = 0; Slot < NumSlots; ++Slot)
+    {
+        const int32 Amount = FMath::Max(0, SlotAmounts[Slot]);
+        if (const int32* ExistingSlot = SlotByResource.Find(SlotResources[Slot].RowName))
+        {
+            SlotAmounts[*ExistingSlot] += Amount;
+        }
+        else
         {
-            return i;
+            SlotResources[NumKept] = SlotResources[Slot];
+            SlotAmounts[NumKept] = Amount;
+            SlotByResource.Add(SlotResources[NumKept].RowName, NumKept);
+            ++NumKept;
         }
+        StoredTotal += Amount;
+    }
+
+    SlotResources.SetNum(NumKept, EAllowShrinking::No);
+    SlotAmounts.SetNum(NumKept, EAllowShrinking::No);
+}
+
+void UResourceStorageComponent::SetSlotAmount(int32 Slot, int32 NewAmount)
+{
+    StoredTotal += NewAmount - SlotAmounts[Slot];
+    SlotAmounts[Slot] = NewAmount;
+}
+
+void UResourceStorageComponent::RemoveSlot(int32 Slot)
+{
+    StoredTotal -= SlotAmounts[Slot];
+    SlotByResource.Remove(SlotResources[Slot].RowName);
+
+    // Swap-remove: ostatni slot przechodzi na miejsce usuniętego
+    const int32 LastSlot = SlotResources.Num() - 1;
+    if (Slot != LastSlot)
+    {
+        SlotResources[Slot] = SlotResources[LastSlot];
+        SlotAmounts[Slot] = SlotAmounts[LastSlot];
+        SlotByResource[SlotResources[Slot].RowName] = Slot;
     }
-    return INDEX_NONE;
+
+    SlotResources.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+    SlotAmounts.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+}
+
+void UResourceStorageComponent::ResetSlots()
+{
+    SlotResources.Reset();
+    SlotAmounts.Reset();
+    SlotByResource.Reset();
+    StoredTotal = 0;
 }
 
 bool UResourceStorageComponent::IsValidResourceReference(const FDataTableRowHandle& ResourceType) const
@@ -428,6 +855,22 @@ void UResourceStorageComponent::BroadcastStorageEvents(const FDataTableRowHandle
                                                      int32 NewAmount, 
                                                      bool bWasAdded)
 {
+    // Native listeners (lustra stanu w managerach) zawsze dostają zmianę od razu
+    NotifyContentsChanged(ResourceType);
+
+    if (bDeferStorageEvents)
+    {
+        RecordDeferredChange(ResourceType, OldAmount);
+        return;
+    }
+
+    BroadcastResourceEvents(ResourceType, OldAmount, NewAmount);
+}
+
+void UResourceStorageComponent::BroadcastResourceEvents(const FDataTableRowHandle& ResourceType, int32 OldAmount, int32 NewAmount)
+{
+    const bool bWasAdded = NewAmount >= OldAmount;
+
     // Broadcast C++ events
     OnStorageChanged.Broadcast(ResourceType, NewAmount, MaxCapacity);
     
@@ -451,4 +894,74 @@ void UResourceStorageComponent::BroadcastStorageEvents(const FDataTableRowHandle
     {
         OnResourceRemoved_BP(ResourceType, OldAmount - NewAmount);
     }
-}
\ No newline at end of file
+}
+
+// === DEFERRED EVENTS ===
+
+void UResourceStorageComponent::SetDeferStorageEvents(bool bDefer)
+{
+    if (bDeferStorageEvents == bDefer)
+    {
+        return;
+    }
+
+    bDeferStorageEvents = bDefer;
+
+    if (!bDeferStorageEvents)
+    {
+        FlushDeferredStorageEvents();
+    }
+}
+
+void UResourceStorageComponent::RecordDeferredChange(const FDataTableRowHandle& ResourceType, int32 OldAmount)
+{
+    // Tylko pierwsza zmiana w klatce zapisuje stan "przed" - kolejne tylko go nadpisałyby
+    if (DeferredChanges.Contains(ResourceType.RowName))
+    {
+        return;
+    }
+
+    if (DeferredChanges.Num() == 0)
+    {
+        UWorld* World = GetWorld();
+        UStorageEventSubsystem* EventSubsystem = World ? World->GetSubsystem<UStorageEventSubsystem>() : nullptr;
+        if (!EventSubsystem)
+        {
+            // Bez świata nie ma kto zrobić flusha - zachowujemy się jak bez odroczenia
+            const int32 Slot = FindSlot(ResourceType);
+            BroadcastResourceEvents(ResourceType, OldAmount, Slot != INDEX_NONE ? SlotAmounts[Slot] : 0);
+            return;
+        }
+
+        EventSubsystem->QueueStorage(this);
+    }
+
+    FDeferredStorageChange& Change = DeferredChanges.Add(ResourceType.RowName);
+    Change.ResourceType = ResourceType;
+    Change.AmountBeforeChange = OldAmount;
+}
+
+void UResourceStorageComponent::FlushDeferredStorageEvents()
+{
+    if (DeferredChanges.Num() == 0)
+    {
+        return;
+    }
+
+    // Handlery mogą znowu modyfikować magazyn - te zmiany trafią do następnego flusha
+    TArray<FDeferredStorageChange, TInlineAllocator<8>> Changes;
+    DeferredChanges.GenerateValueArray(Changes);
+    DeferredChanges.Reset();
+
+    for (const FDeferredStorageChange& Change : Changes)
+    {
+        // Tylko zapisane ilości - produkcja lazy ma własne eventy przy materializacji
+        const int32 Slot = FindSlot(Change.ResourceType);
+        const int32 NewAmount = Slot != INDEX_NONE ? SlotAmounts[Slot] : 0;
+
+        if (NewAmount != Change.AmountBeforeChange)
+        {
+            BroadcastResourceEvents(Change.ResourceType, Change.AmountBeforeChange, NewAmount);
+        }
+    }
+}
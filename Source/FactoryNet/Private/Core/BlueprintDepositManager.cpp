@@ -3,6 +3,7 @@
 
 #include "Core/BlueprintDepositManager.h"
 #include "Core/DepositSpawnManager.h"
+#include "Core/DepositRegistry.h"
 #include "Buildings/Base/ResourceDeposit.h"
 #include "Components/BillboardComponent.h"
 #include "Components/BoxComponent.h"
@@ -30,7 +31,13 @@ ABlueprintDepositManager::ABlueprintDepositManager()
     SpawnTrigger = ESpawnTriggerType::OnBeginPlay;
     DelayTime = 2.0f;
     DepositDensity = EDepositDensity::Normal;
+    PlacementMode = EDepositPlacementMode::JitteredGrid;
+    SpawnSeed = 0;
+    bRandomizeSeed = true;
+    bSpawnAsSimulationRecords = false;
     bAutoGenerateOnBeginPlay = true;
+    bUseAsyncGeneration = true;
+    AsyncSpawnBudgetMs = 2.0f;
     bUseDefaultSpawnRules = true;
     bLogSpawnProcess = true;
     bShowSpawnArea = true;
@@ -115,8 +122,16 @@ void ABlueprintDepositManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
     // Unbind events
     if (SpawnManager)
     {
+        // Generacja zlecona przez ten manager nie może przeżyć aktora
+        if (SpawnManager->IsGeneratingDeposits())
+        {
+            SpawnManager->CancelDepositGeneration();
+        }
+
         SpawnManager->OnDepositSpawned.RemoveDynamic(this, &ABlueprintDepositManager::OnDepositSpawned);
         SpawnManager->OnAllDepositsSpawned.RemoveDynamic(this, &ABlueprintDepositManager::OnAllDepositsSpawned);
+        SpawnManager->OnAllDepositsCleared.RemoveDynamic(this, &ABlueprintDepositManager::OnAllDepositsCleared);
+        SpawnManager->OnDepositGenerationProgress.RemoveDynamic(this, &ABlueprintDepositManager::OnGenerationProgressChanged);
     }
 
     Super::EndPlay(EndPlayReason);
@@ -151,15 +166,30 @@ void ABlueprintDepositManager::GenerateDeposits()
         UE_LOG(LogTemp, Warning, TEXT("=== END PROBABILITY TEST ==="));
     }
 
-    // Apply deposit density to spawn manager
+    // Apply deposit density, placement mode and seed to spawn manager
     SpawnManager->SetDepositDensity(DepositDensity);
+    SpawnManager->SetPlacementMode(PlacementMode);
+    SpawnManager->SetSpawnSeed(SpawnSeed, bRandomizeSeed);
+    SpawnManager->SetSpawnAsSimulationRecords(bSpawnAsSimulationRecords);
 
     // ✅ DODANO: Notify Blueprint przed rozpoczęciem spawnu
     OnDepositGenerationStarted_BP();
 
     // Generate deposits
-    SpawnManager->GenerateDepositsOnMap();
     bHasGenerated = true;
+    if (bUseAsyncGeneration)
+    {
+        // Koniec sygnalizuje OnAllDepositsSpawned - BeginPlay i Delayed nie blokują game thread
+        SpawnManager->GenerateDepositsOnMapAsync(AsyncSpawnBudgetMs);
+
+        if (bLogSpawnProcess)
+        {
+            UE_LOG(LogTemp, Log, TEXT("BlueprintDepositManager: Async deposit generation started"));
+        }
+        return;
+    }
+
+    SpawnManager->GenerateDepositsOnMap();
 
     if (bLogSpawnProcess)
     {
@@ -180,13 +210,24 @@ void ABlueprintDepositManager::RegenerateDeposits()
         UE_LOG(LogTemp, Log, TEXT("BlueprintDepositManager: Regenerating deposits..."));
     }
 
-    // Clear existing deposits
-    SpawnManager->ClearAllSpawnedDeposits();
+    // Clear existing deposits (async generation clears them in per-frame budgets itself)
+    if (!bUseAsyncGeneration)
+    {
+        SpawnManager->ClearAllSpawnedDeposits();
+    }
 
     // Reset flag and regenerate
     bHasGenerated = false;
+    bClearPending = false;
     GenerateDeposits();
 
+    // Async: Blueprint dostaje event dopiero po spawnie ostatniego złoża (OnAllDepositsSpawned)
+    if (bUseAsyncGeneration)
+    {
+        bRegeneratePending = SpawnManager->IsGeneratingDeposits();
+        return;
+    }
+
     // Notify Blueprint
     OnDepositsRegenerated_BP();
 }
@@ -204,8 +245,18 @@ void ABlueprintDepositManager::ClearAllDeposits()
         UE_LOG(LogTemp, Log, TEXT("BlueprintDepositManager: Clearing all deposits..."));
     }
 
-    SpawnManager->ClearAllSpawnedDeposits();
     bHasGenerated = false;
+    bRegeneratePending = false;
+
+    // Async: Blueprint dostaje event dopiero po usunięciu ostatniego złoża (OnAllDepositsCleared)
+    if (bUseAsyncGeneration)
+    {
+        SpawnManager->ClearAllSpawnedDepositsAsync(AsyncSpawnBudgetMs);
+        bClearPending = SpawnManager->IsGeneratingDeposits();
+        return;
+    }
+
+    SpawnManager->ClearAllSpawnedDeposits();
 
     // Notify Blueprint
     OnDepositsCleared_BP();
@@ -255,6 +306,34 @@ FDepositInfo ABlueprintDepositManager::GetDepositInfo(UDepositDefinition* Deposi
     return DepositInfo;
 }
 
+void ABlueprintDepositManager::CancelGeneration()
+{
+    if (!SpawnManager || !SpawnManager->IsGeneratingDeposits())
+    {
+        return;
+    }
+
+    SpawnManager->CancelDepositGeneration();
+    bHasGenerated = false;
+    bRegeneratePending = false;
+    bClearPending = false;
+
+    if (bLogSpawnProcess)
+    {
+        UE_LOG(LogTemp, Log, TEXT("BlueprintDepositManager: Deposit generation cancelled"));
+    }
+}
+
+bool ABlueprintDepositManager::IsGenerating() const
+{
+    return SpawnManager && SpawnManager->IsGeneratingDeposits();
+}
+
+int32 ABlueprintDepositManager::GetLastGenerationSeed() const
+{
+    return SpawnManager ? SpawnManager->GetLastGenerationSeed() : SpawnSeed;
+}
+
 TArray<AResourceDeposit*> ABlueprintDepositManager::GetAllSpawnedDeposits()
 {
     if (!SpawnManager)
@@ -277,12 +356,14 @@ TArray<AResourceDeposit*> ABlueprintDepositManager::GetDepositsByType(UDepositDe
 
 AResourceDeposit* ABlueprintDepositManager::GetNearestDeposit(const FVector& Location, UDepositDefinition* DepositType)
 {
-    if (!SpawnManager)
+    // Rejestr obejmuje wszystkie złoża w świecie (także postawione ręcznie w levelu)
+    const UDepositRegistry* DepositRegistry = GetWorld() ? GetWorld()->GetSubsystem<UDepositRegistry>() : nullptr;
+    if (!DepositRegistry)
     {
         return nullptr;
     }
 
-    return SpawnManager->GetNearestDepositOfType(Location, DepositType);
+    return DepositRegistry->FindNearestDeposit(Location, DepositType);
 }
 
 // === PRIVATE FUNCTIONS ===
@@ -298,6 +379,8 @@ void ABlueprintDepositManager::InitializeSpawnManager()
             // ✅ NAPRAWIONE: Prawidłowe bindowanie eventów
             SpawnManager->OnDepositSpawned.AddDynamic(this, &ABlueprintDepositManager::OnDepositSpawned);
             SpawnManager->OnAllDepositsSpawned.AddDynamic(this, &ABlueprintDepositManager::OnAllDepositsSpawned);
+            SpawnManager->OnAllDepositsCleared.AddDynamic(this, &ABlueprintDepositManager::OnAllDepositsCleared);
+            SpawnManager->OnDepositGenerationProgress.AddDynamic(this, &ABlueprintDepositManager::OnGenerationProgressChanged);
             
             if (bLogSpawnProcess)
             {
@@ -500,6 +583,33 @@ void ABlueprintDepositManager::OnAllDepositsSpawned(const TArray<FSpawnedDeposit
 
     // Notify Blueprint
     OnAllDepositsSpawned_BP(SpawnedDeposits);
+
+    if (bRegeneratePending)
+    {
+        bRegeneratePending = false;
+        OnDepositsRegenerated_BP();
+    }
+}
+
+void ABlueprintDepositManager::OnAllDepositsCleared()
+{
+    // Tylko czyszczenie zlecone przez ten manager
+    if (bClearPending)
+    {
+        bClearPending = false;
+        OnDepositsCleared_BP();
+    }
+}
+
+void ABlueprintDepositManager::OnGenerationProgressChanged(float Progress, int32 SpawnedCount)
+{
+    if (bLogSpawnProcess)
+    {
+        UE_LOG(LogTemp, Verbose, TEXT("BlueprintDepositManager: Generation progress %.0f%% (%d spawned)"), Progress * 100.0f, SpawnedCount);
+    }
+
+    OnGenerationProgress.Broadcast(Progress, SpawnedCount);
+    OnDepositGenerationProgress_BP(Progress, SpawnedCount);
 }
 
 void ABlueprintDepositManager::UpdateSpawnAreaVisualization()
@@ -901,6 +1011,15 @@ void ABlueprintDepositManager::LogConfigurationSummary() const
     UE_LOG(LogTemp, Log, TEXT("📊 Deposit Density: %s"), 
            *UEnum::GetValueAsString(DepositDensity));
            
+    UE_LOG(LogTemp, Log, TEXT("🗺️ Placement Mode: %s"), 
+           *UEnum::GetValueAsString(PlacementMode));
+           
+    UE_LOG(LogTemp, Log, TEXT("🎲 Spawn Seed: %s"), 
+           bRandomizeSeed ? TEXT("Random") : *FString::FromInt(SpawnSeed));
+           
+    UE_LOG(LogTemp, Log, TEXT("🧊 Simulation Records: %s"), 
+           bSpawnAsSimulationRecords ? TEXT("✅ Yes") : TEXT("❌ No"));
+           
     UE_LOG(LogTemp, Log, TEXT("📋 Use Default Rules: %s"), 
            bUseDefaultSpawnRules ? TEXT("✅ Yes") : TEXT("❌ No"));
            
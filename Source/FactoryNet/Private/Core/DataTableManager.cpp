@@ -10,6 +10,200 @@
 #include "Data/DemandDefinition.h"
 #include "Data/UpgradeData.h"
 #include "Engine/World.h"
+#include "Engine/AssetManager.h"
+
+namespace
+{
+    // Lookup helper for the secondary row indexes - returns a shared empty array on miss
+    template <typename KeyType, typename RowType>
+    const TArray<const RowType*>& FindIndexedRows(const TMap<KeyType, TArray<const RowType*>>& Index, const KeyType& Key)
+    {
+        static const TArray<const RowType*> EmptyRows;
+        const TArray<const RowType*>* Rows = Index.Find(Key);
+        return Rows ? *Rows : EmptyRows;
+    }
+
+    // Collects definitions that pass the unlock predicate, skipping null entries
+    template <typename DefinitionType, typename PredicateType>
+    TArray<DefinitionType*> FilterDefinitions(const TArray<DefinitionType*>& Definitions, PredicateType Predicate)
+    {
+        TArray<DefinitionType*> Result;
+        for (DefinitionType* Definition : Definitions)
+        {
+            if (Definition && Predicate(Definition))
+            {
+                Result.Add(Definition);
+            }
+        }
+        return Result;
+    }
+
+    // Loads every primary asset of the definition's type and appends the ones not assigned by hand
+    template <typename DefinitionType>
+    int32 DiscoverDefinitions(UAssetManager& AssetManager, TArray<DefinitionType*>& Definitions)
+    {
+        TArray<FSoftObjectPath> AssetPaths;
+        AssetManager.GetPrimaryAssetPathList(DefinitionType::PrimaryAssetType, AssetPaths);
+
+        TSet<DefinitionType*> KnownDefinitions(Definitions);
+        int32 NumAdded = 0;
+        for (const FSoftObjectPath& AssetPath : AssetPaths)
+        {
+            // Małe DataAssety, ładowane raz przy starcie - reguły spawnu potrzebują ich od razu
+            DefinitionType* Definition = Cast<DefinitionType>(AssetPath.TryLoad());
+            if (Definition && !KnownDefinitions.Contains(Definition))
+            {
+                KnownDefinitions.Add(Definition);
+                Definitions.Add(Definition);
+                ++NumAdded;
+            }
+        }
+        return NumAdded;
+    }
+
+    // First definition with a given name wins - same result as the old linear scan.
+    // OutIndexedDefinitions keeps the array the index was built from, to detect later changes.
+    template <typename DefinitionType, typename NameGetterType>
+    void BuildNameIndex(const TArray<DefinitionType*>& Definitions, TMap<FString, DefinitionType*>& OutIndex,
+                        TArray<DefinitionType*>& OutIndexedDefinitions, NameGetterType GetName)
+    {
+        OutIndexedDefinitions = Definitions;
+        OutIndex.Reset();
+        OutIndex.Reserve(Definitions.Num());
+        for (DefinitionType* Definition : Definitions)
+        {
+            if (Definition)
+            {
+                const FString Name = GetName(Definition);
+                if (!OutIndex.Contains(Name))
+                {
+                    OutIndex.Add(Name, Definition);
+                }
+            }
+        }
+    }
+
+    template <typename DefinitionType, typename NameGetterType>
+    DefinitionType* FindDefinitionByName(TMap<FString, DefinitionType*>& Index, TArray<DefinitionType*>& IndexedDefinitions,
+                                         const TArray<DefinitionType*>& Definitions, const FString& Name, NameGetterType GetName)
+    {
+        // Tablice są BlueprintReadWrite - dopisanie, usunięcie albo podmiana wpisu przebudowuje indeks.
+        // Porównanie wskaźników zamiast skanu po nazwach przy każdym chybieniu.
+        if (IndexedDefinitions != Definitions)
+        {
+            BuildNameIndex(Definitions, Index, IndexedDefinitions, GetName);
+        }
+
+        DefinitionType* const* Found = Index.Find(Name);
+        return Found ? *Found : nullptr;
+    }
+
+    // Tarjan's SCC over resource -> input resource edges. Components finish dependencies-first, so a
+    // component's closure is its raw members plus the already final closures of the components it uses.
+    // Recursion depth is bounded by the longest production chain.
+    struct FRawMaterialClosureBuilder
+    {
+        const TArray<TArray<int32>>& Successors;
+        const TArray<bool>& IsRaw;
+        TArray<TArray<int32>>& Closures;
+
+        TArray<int32> DiscoveryIndex;
+        TArray<int32> LowLink;
+        TArray<bool> OnStack;
+        TArray<int32> Stack;
+        int32 NextIndex = 0;
+
+        FRawMaterialClosureBuilder(const TArray<TArray<int32>>& InSuccessors, const TArray<bool>& InIsRaw, TArray<TArray<int32>>& OutClosures)
+            : Successors(InSuccessors)
+            , IsRaw(InIsRaw)
+            , Closures(OutClosures)
+        {
+            const int32 NumNodes = Successors.Num();
+            DiscoveryIndex.Init(INDEX_NONE, NumNodes);
+            LowLink.Init(0, NumNodes);
+            OnStack.Init(false, NumNodes);
+            Closures.Reset();
+            Closures.SetNum(NumNodes);
+        }
+
+        void Build()
+        {
+            for (int32 Node = 0; Node < Successors.Num(); ++Node)
+            {
+                if (DiscoveryIndex[Node] == INDEX_NONE)
+                {
+                    Visit(Node);
+                }
+            }
+        }
+
+        void Visit(int32 Node)
+        {
+            DiscoveryIndex[Node] = NextIndex;
+            LowLink[Node] = NextIndex;
+            ++NextIndex;
+            Stack.Push(Node);
+            OnStack[Node] = true;
+
+            for (const int32 Successor : Successors[Node])
+            {
+                if (DiscoveryIndex[Successor] == INDEX_NONE)
+                {
+                    Visit(Successor);
+                    LowLink[Node] = FMath::Min(LowLink[Node], LowLink[Successor]);
+                }
+                else if (OnStack[Successor])
+                {
+                    LowLink[Node] = FMath::Min(LowLink[Node], DiscoveryIndex[Successor]);
+                }
+            }
+
+            if (LowLink[Node] != DiscoveryIndex[Node])
+            {
+                return;
+            }
+
+            TArray<int32, TInlineAllocator<8>> Members;
+            int32 Member = INDEX_NONE;
+            do
+            {
+                Member = Stack.Pop(EAllowShrinking::No);
+                OnStack[Member] = false;
+                Members.Add(Member);
+            }
+            while (Member != Node);
+
+            // Closures of members are still empty here, so edges inside the component add nothing
+            TSet<int32> RawMaterials;
+            for (const int32 ComponentMember : Members)
+            {
+                if (IsRaw[ComponentMember])
+                {
+                    RawMaterials.Add(ComponentMember);
+                }
+
+                for (const int32 Successor : Successors[ComponentMember])
+                {
+                    RawMaterials.Append(Closures[Successor]);
+                }
+            }
+
+            TArray<int32> SortedRawMaterials = RawMaterials.Array();
+            SortedRawMaterials.Sort();
+            for (const int32 ComponentMember : Members)
+            {
+                Closures[ComponentMember] = SortedRawMaterials;
+            }
+        }
+    };
+
+    const auto GetFactoryName = [](const UFactoryDefinition* Definition) { return Definition->FactoryName.ToString(); };
+    const auto GetHubName = [](const UHubDefinition* Definition) { return Definition->HubName.ToString(); };
+    const auto GetVehicleName = [](const UVehicleDefinition* Definition) { return Definition->VehicleName.ToString(); };
+    const auto GetRoadName = [](const URoadDefinition* Definition) { return Definition->RoadName.ToString(); };
+    const auto GetDepositName = [](const UDepositDefinition* Definition) { return Definition->DepositName.ToString(); };
+    const auto GetDemandName = [](const UDemandDefinition* Definition) { return Definition->DemandPointName.ToString(); };
+}
 
 UDataTableManager::UDataTableManager()
 {
@@ -45,6 +239,11 @@ void UDataTableManager::Deinitialize()
     bDataTablesLoaded = false;
     bDataAssetsLoaded = false;
     
+    InvalidateDefinitionNameIndexes();
+    InvalidateRowIndexes();
+    InvalidateTechIndex();
+    InvalidateRecipeGraph();
+    
     Super::Deinitialize();
 }
 
@@ -61,6 +260,9 @@ void UDataTableManager::LoadAllDataTables()
         UE_LOG(LogTemp, Log, TEXT("DataTableManager: DataTables loaded successfully"));
         
         LoadDataAssets();
+        BuildRowIndexes();
+        BuildTechIndex();
+        BuildRecipeGraph();
         ValidateDataIntegrity();
         LogDataTableStats();
         OnDataTablesLoaded.Broadcast();
@@ -77,10 +279,54 @@ void UDataTableManager::LoadAllDataTables()
 
 void UDataTableManager::LoadDataAssets()
 {
-    UE_LOG(LogTemp, Log, TEXT("DataTableManager: DataAssets are directly assigned as arrays"));
+    // Definicje przypisane ręcznie zostają; Asset Manager dokłada resztę po typie primary asset
+    if (UAssetManager* AssetManager = UAssetManager::GetIfInitialized())
+    {
+        int32 NumDiscovered = 0;
+        NumDiscovered += DiscoverDefinitions(*AssetManager, FactoryDefinitions);
+        NumDiscovered += DiscoverDefinitions(*AssetManager, HubDefinitions);
+        NumDiscovered += DiscoverDefinitions(*AssetManager, VehicleDefinitions);
+        NumDiscovered += DiscoverDefinitions(*AssetManager, RoadDefinitions);
+        NumDiscovered += DiscoverDefinitions(*AssetManager, DepositDefinitions);
+        NumDiscovered += DiscoverDefinitions(*AssetManager, DemandDefinitions);
+
+        UE_LOG(LogTemp, Log, TEXT("DataTableManager: Asset Manager discovered %d definition assets"), NumDiscovered);
+    }
+    else
+    {
+        UE_LOG(LogTemp, Warning, TEXT("DataTableManager: Asset Manager not initialized - using directly assigned DataAssets only"));
+    }
+
+    BuildDefinitionNameIndexes();
     bDataAssetsLoaded = true;
 }
 
+void UDataTableManager::BuildDefinitionNameIndexes()
+{
+    BuildNameIndex(FactoryDefinitions, FactoryDefinitionsByName, IndexedFactoryDefinitions, GetFactoryName);
+    BuildNameIndex(HubDefinitions, HubDefinitionsByName, IndexedHubDefinitions, GetHubName);
+    BuildNameIndex(VehicleDefinitions, VehicleDefinitionsByName, IndexedVehicleDefinitions, GetVehicleName);
+    BuildNameIndex(RoadDefinitions, RoadDefinitionsByName, IndexedRoadDefinitions, GetRoadName);
+    BuildNameIndex(DepositDefinitions, DepositDefinitionsByName, IndexedDepositDefinitions, GetDepositName);
+    BuildNameIndex(DemandDefinitions, DemandDefinitionsByName, IndexedDemandDefinitions, GetDemandName);
+}
+
+void UDataTableManager::InvalidateDefinitionNameIndexes()
+{
+    FactoryDefinitionsByName.Empty();
+    IndexedFactoryDefinitions.Empty();
+    HubDefinitionsByName.Empty();
+    IndexedHubDefinitions.Empty();
+    VehicleDefinitionsByName.Empty();
+    IndexedVehicleDefinitions.Empty();
+    RoadDefinitionsByName.Empty();
+    IndexedRoadDefinitions.Empty();
+    DepositDefinitionsByName.Empty();
+    IndexedDepositDefinitions.Empty();
+    DemandDefinitionsByName.Empty();
+    IndexedDemandDefinitions.Empty();
+}
+
 // === EXISTING FUNCTIONS (from previous implementation) ===
 bool UDataTableManager::GetResourceDataByReference(const FDataTableRowHandle& ResourceReference, FResourceTableRow& OutResourceData)
 {
@@ -117,15 +363,14 @@ TArray<FResourceTableRow> UDataTableManager::GetAllResources()
 
 TArray<FResourceTableRow> UDataTableManager::GetResourcesByType(EResourceType ResourceType)
 {
+    const TArray<const FResourceTableRow*>& IndexedRows = GetResourceRowsByType(ResourceType);
+    
     TArray<FResourceTableRow> FilteredResources;
-    TArray<FResourceTableRow> AllResources = GetAllResources();
+    FilteredResources.Reserve(IndexedRows.Num());
     
-    for (const FResourceTableRow& Resource : AllResources)
+    for (const FResourceTableRow* Resource : IndexedRows)
     {
-        if (Resource.ResourceType == ResourceType)
-        {
-            FilteredResources.Add(Resource);
-        }
+        FilteredResources.Add(*Resource);
     }
     
     return FilteredResources;
@@ -204,21 +449,49 @@ TArray<FProductionRecipe> UDataTableManager::GetRecipesForFactory(UFactoryDefini
 
 TArray<FProductionRecipe> UDataTableManager::GetRecipesByOutputResource(const FDataTableRowHandle& ResourceReference)
 {
+    const TArray<int32>& RecipeIds = GetProducingRecipeIds(GetResourceId(ResourceReference));
+    
     TArray<FProductionRecipe> OutputRecipes;
-    TArray<FProductionRecipe> AllRecipes = GetAllRecipes();
+    OutputRecipes.Reserve(RecipeIds.Num());
     
-    for (const FProductionRecipe& Recipe : AllRecipes)
+    for (const int32 RecipeId : RecipeIds)
     {
-        if (Recipe.OutputResourceReference.RowName == ResourceReference.RowName && 
-            Recipe.OutputResourceReference.DataTable == ResourceReference.DataTable)
-        {
-            OutputRecipes.Add(Recipe);
-        }
+        OutputRecipes.Add(*RecipeNodes[RecipeId].Row);
     }
     
     return OutputRecipes;
 }
 
+TArray<FProductionRecipe> UDataTableManager::GetRecipesByInputResource(const FDataTableRowHandle& ResourceReference)
+{
+    const TArray<int32>& RecipeIds = GetConsumingRecipeIds(GetResourceId(ResourceReference));
+    
+    TArray<FProductionRecipe> InputRecipes;
+    InputRecipes.Reserve(RecipeIds.Num());
+    
+    for (const int32 RecipeId : RecipeIds)
+    {
+        InputRecipes.Add(*RecipeNodes[RecipeId].Row);
+    }
+    
+    return InputRecipes;
+}
+
+TArray<FDataTableRowHandle> UDataTableManager::GetRawMaterialsForResource(const FDataTableRowHandle& ResourceReference)
+{
+    const TArray<int32>& RawMaterialIds = GetRawMaterialIds(GetResourceId(ResourceReference));
+    
+    TArray<FDataTableRowHandle> RawMaterials;
+    RawMaterials.Reserve(RawMaterialIds.Num());
+    
+    for (const int32 ResourceId : RawMaterialIds)
+    {
+        RawMaterials.Add(ResourceNodes[ResourceId].Reference);
+    }
+    
+    return RawMaterials;
+}
+
 FString UDataTableManager::GetRecipeNameFromReference(const FDataTableRowHandle& RecipeReference)
 {
     FProductionRecipe* RecipeData = GetProductionRecipeInternal(RecipeReference);
@@ -271,15 +544,14 @@ TArray<FTransportRoute> UDataTableManager::GetAllRoutes()
 
 TArray<FTransportRoute> UDataTableManager::GetRoutesFromHub(UHubDefinition* HubDef)
 {
+    const TArray<const FTransportRoute*>& IndexedRows = GetRouteRowsFromHub(HubDef);
+    
     TArray<FTransportRoute> FromRoutes;
-    TArray<FTransportRoute> AllRoutes = GetAllRoutes();
+    FromRoutes.Reserve(IndexedRows.Num());
     
-    for (const FTransportRoute& Route : AllRoutes)
+    for (const FTransportRoute* Route : IndexedRows)
     {
-        if (Route.StartHubReference.Get() == HubDef)
-        {
-            FromRoutes.Add(Route);
-        }
+        FromRoutes.Add(*Route);
     }
     
     return FromRoutes;
@@ -287,15 +559,14 @@ TArray<FTransportRoute> UDataTableManager::GetRoutesFromHub(UHubDefinition* HubD
 
 TArray<FTransportRoute> UDataTableManager::GetRoutesToHub(UHubDefinition* HubDef)
 {
+    const TArray<const FTransportRoute*>& IndexedRows = GetRouteRowsToHub(HubDef);
+    
     TArray<FTransportRoute> ToRoutes;
-    TArray<FTransportRoute> AllRoutes = GetAllRoutes();
+    ToRoutes.Reserve(IndexedRows.Num());
     
-    for (const FTransportRoute& Route : AllRoutes)
+    for (const FTransportRoute* Route : IndexedRows)
     {
-        if (Route.EndHubReference.Get() == HubDef)
-        {
-            ToRoutes.Add(Route);
-        }
+        ToRoutes.Add(*Route);
     }
     
     return ToRoutes;
@@ -337,15 +608,14 @@ TArray<FUpgradeTableRow> UDataTableManager::GetAllUpgrades()
 
 TArray<FUpgradeTableRow> UDataTableManager::GetUpgradesByCategory(EUpgradeCategory Category)
 {
+    const TArray<const FUpgradeTableRow*>& IndexedRows = GetUpgradeRowsByCategory(Category);
+    
     TArray<FUpgradeTableRow> FilteredUpgrades;
-    TArray<FUpgradeTableRow> AllUpgrades = GetAllUpgrades();
+    FilteredUpgrades.Reserve(IndexedRows.Num());
     
-    for (const FUpgradeTableRow& Upgrade : AllUpgrades)
+    for (const FUpgradeTableRow* Upgrade : IndexedRows)
     {
-        if (Upgrade.UpgradeCategory == Category)
-        {
-            FilteredUpgrades.Add(Upgrade);
-        }
+        FilteredUpgrades.Add(*Upgrade);
     }
     
     return FilteredUpgrades;
@@ -353,15 +623,14 @@ TArray<FUpgradeTableRow> UDataTableManager::GetUpgradesByCategory(EUpgradeCatego
 
 TArray<FUpgradeTableRow> UDataTableManager::GetUpgradesByType(EUpgradeType Type)
 {
+    const TArray<const FUpgradeTableRow*>& IndexedRows = GetUpgradeRowsByType(Type);
+    
     TArray<FUpgradeTableRow> FilteredUpgrades;
-    TArray<FUpgradeTableRow> AllUpgrades = GetAllUpgrades();
+    FilteredUpgrades.Reserve(IndexedRows.Num());
     
-    for (const FUpgradeTableRow& Upgrade : AllUpgrades)
+    for (const FUpgradeTableRow* Upgrade : IndexedRows)
     {
-        if (Upgrade.UpgradeType == Type)
-        {
-            FilteredUpgrades.Add(Upgrade);
-        }
+        FilteredUpgrades.Add(*Upgrade);
     }
     
     return FilteredUpgrades;
@@ -369,15 +638,14 @@ TArray<FUpgradeTableRow> UDataTableManager::GetUpgradesByType(EUpgradeType Type)
 
 TArray<FUpgradeTableRow> UDataTableManager::GetUpgradesByTechLevel(int32 TechLevel)
 {
+    const TArray<const FUpgradeTableRow*>& IndexedRows = GetUpgradeRowsByTechLevel(TechLevel);
+    
     TArray<FUpgradeTableRow> FilteredUpgrades;
-    TArray<FUpgradeTableRow> AllUpgrades = GetAllUpgrades();
+    FilteredUpgrades.Reserve(IndexedRows.Num());
     
-    for (const FUpgradeTableRow& Upgrade : AllUpgrades)
+    for (const FUpgradeTableRow* Upgrade : IndexedRows)
     {
-        if (Upgrade.TechLevel == TechLevel)
-        {
-            FilteredUpgrades.Add(Upgrade);
-        }
+        FilteredUpgrades.Add(*Upgrade);
     }
     
     return FilteredUpgrades;
@@ -401,6 +669,13 @@ FString UDataTableManager::GetUpgradeNameFromReference(const FDataTableRowHandle
 
 bool UDataTableManager::AreUpgradePrerequisitesMet(const FDataTableRowHandle& UpgradeReference, const TArray<FDataTableRowHandle>& CompletedUpgrades)
 {
+    // Szybka ścieżka: prekompilowana maska wymaganych prerequisite
+    const FTechUnlockSet* PrerequisiteMask = FindPrerequisiteMask(UpgradeReference);
+    if (PrerequisiteMask && !PrerequisiteMask->HasUnresolvedTechs())
+    {
+        return MakeTechUnlockSet(CompletedUpgrades).ContainsAll(*PrerequisiteMask);
+    }
+    
     FUpgradeTableRow* UpgradeData = GetUpgradeDataInternal(UpgradeReference);
     if (!UpgradeData)
     {
@@ -446,19 +721,15 @@ TArray<FDataTableRowHandle> UDataTableManager::GetMissingTechnologies(
 {
     TArray<FDataTableRowHandle> MissingTechs;
     
+    // Technologie bez ID nie mogą być w zestawie bitowym - porównaj je z listą bezpośrednio
+    const FTechUnlockSet UnlockedSet = MakeTechUnlockSet(UnlockedTechs);
+    
     for (const FDataTableRowHandle& RequiredTech : RequiredTechs)
     {
-        bool bTechFound = false;
-        
-        for (const FDataTableRowHandle& UnlockedTech : UnlockedTechs)
-        {
-            if (RequiredTech.RowName == UnlockedTech.RowName && 
-                RequiredTech.DataTable == UnlockedTech.DataTable)
-            {
-                bTechFound = true;
-                break;
-            }
-        }
+        const int32 TechId = GetTechId(RequiredTech);
+        const bool bTechFound = TechId != INDEX_NONE 
+            ? UnlockedSet.Contains(TechId) 
+            : UnlockedTechs.Contains(RequiredTech);
         
         if (!bTechFound)
         {
@@ -477,7 +748,7 @@ bool UDataTableManager::CanBuildFactory(UFactoryDefinition* FactoryDef,
         return false;
     }
     
-    return AreTechnologiesUnlockedInternal(FactoryDef->RequiredTechnologies, UnlockedTechs);
+    return IsDefinitionUnlocked(FactoryDef, FactoryDef->RequiredTechnologies, UnlockedTechs);
 }
 
 bool UDataTableManager::CanBuildDeposit(UDepositDefinition* DepositDef, 
@@ -488,7 +759,7 @@ bool UDataTableManager::CanBuildDeposit(UDepositDefinition* DepositDef,
         return false;
     }
     
-    return AreTechnologiesUnlockedInternal(DepositDef->RequiredTechnologies, UnlockedTechs);
+    return IsDefinitionUnlocked(DepositDef, DepositDef->RequiredTechnologies, UnlockedTechs);
 }
 
 bool UDataTableManager::CanBuildHub(UHubDefinition* HubDef, 
@@ -499,7 +770,7 @@ bool UDataTableManager::CanBuildHub(UHubDefinition* HubDef,
         return false;
     }
     
-    return AreTechnologiesUnlockedInternal(HubDef->RequiredTechnologies, UnlockedTechs);
+    return IsDefinitionUnlocked(HubDef, HubDef->RequiredTechnologies, UnlockedTechs);
 }
 
 bool UDataTableManager::CanBuildRoad(URoadDefinition* RoadDef, 
@@ -510,7 +781,7 @@ bool UDataTableManager::CanBuildRoad(URoadDefinition* RoadDef,
         return false;
     }
     
-    return AreTechnologiesUnlockedInternal(RoadDef->RequiredTechnologies, UnlockedTechs);
+    return IsDefinitionUnlocked(RoadDef, RoadDef->RequiredTechnologies, UnlockedTechs);
 }
 
 bool UDataTableManager::CanUseVehicle(UVehicleDefinition* VehicleDef, 
@@ -521,7 +792,7 @@ bool UDataTableManager::CanUseVehicle(UVehicleDefinition* VehicleDef,
         return false;
     }
     
-    return AreTechnologiesUnlockedInternal(VehicleDef->RequiredTechnologies, UnlockedTechs);
+    return IsDefinitionUnlocked(VehicleDef, VehicleDef->RequiredTechnologies, UnlockedTechs);
 }
 
 bool UDataTableManager::CanBuildDemandPoint(UDemandDefinition* DemandDef, 
@@ -532,12 +803,18 @@ bool UDataTableManager::CanBuildDemandPoint(UDemandDefinition* DemandDef,
         return false;
     }
     
-    return AreTechnologiesUnlockedInternal(DemandDef->RequiredTechnologies, UnlockedTechs);
+    return IsDefinitionUnlocked(DemandDef, DemandDef->RequiredTechnologies, UnlockedTechs);
 }
 
 bool UDataTableManager::CanUseRecipe(const FDataTableRowHandle& RecipeRef, 
                                     const TArray<FDataTableRowHandle>& UnlockedTechs)
 {
+    const FTechUnlockSet* RecipeMask = RecipeTechMasks.Find(RecipeRef);
+    if (RecipeMask && !RecipeMask->HasUnresolvedTechs())
+    {
+        return MakeTechUnlockSet(UnlockedTechs).ContainsAll(*RecipeMask);
+    }
+    
     FProductionRecipe Recipe;
     if (!GetProductionRecipeByReference(RecipeRef, Recipe))
     {
@@ -551,240 +828,123 @@ bool UDataTableManager::CanUseRecipe(const FDataTableRowHandle& RecipeRef,
 TArray<FUpgradeTableRow> UDataTableManager::GetAvailableResearch(
     const TArray<FDataTableRowHandle>& CompletedTechs)
 {
-    TArray<FUpgradeTableRow> AvailableResearch;
-    TArray<FUpgradeTableRow> AllUpgrades = GetAllUpgrades();
-    
-    for (const FUpgradeTableRow& Upgrade : AllUpgrades)
-    {
-        // Sprawdź czy upgrade nie jest już ukończony
-        bool bAlreadyCompleted = false;
-        for (const FDataTableRowHandle& CompletedTech : CompletedTechs)
-        {
-            FDataTableRowHandle UpgradeHandle;
-            UpgradeHandle.DataTable = UpgradeDataTable;
-            UpgradeHandle.RowName = FName(*Upgrade.UpgradeName.ToString());
-            
-            if (CompletedTech.RowName == UpgradeHandle.RowName)
-            {
-                bAlreadyCompleted = true;
-                break;
-            }
-        }
-        
-        if (bAlreadyCompleted)
-        {
-            continue;
-        }
-        
-        // Sprawdź czy prerequisites są spełnione
-        FDataTableRowHandle UpgradeRef;
-        UpgradeRef.DataTable = UpgradeDataTable;
-        UpgradeRef.RowName = FName(*Upgrade.UpgradeName.ToString());
-        
-        if (AreUpgradePrerequisitesMet(UpgradeRef, CompletedTechs))
-        {
-            AvailableResearch.Add(Upgrade);
-        }
-    }
-    
-    return AvailableResearch;
+    return GetAvailableResearch(MakeTechUnlockSet(CompletedTechs));
 }
 
 TArray<FUpgradeTableRow> UDataTableManager::GetTechsByPrerequisite(
     const FDataTableRowHandle& PrerequisiteTech)
 {
     TArray<FUpgradeTableRow> DependentTechs;
-    TArray<FUpgradeTableRow> AllUpgrades = GetAllUpgrades();
     
-    for (const FUpgradeTableRow& Upgrade : AllUpgrades)
+    const TArray<int32>& DependentIds = GetTechDependents(GetTechId(PrerequisiteTech));
+    DependentTechs.Reserve(DependentIds.Num());
+    
+    for (const int32 DependentId : DependentIds)
     {
-        for (const FUpgradeRequirement& Prereq : Upgrade.Prerequisites)
-        {
-            if (Prereq.RequiredUpgradeReference.RowName == PrerequisiteTech.RowName &&
-                Prereq.RequiredUpgradeReference.DataTable == PrerequisiteTech.DataTable)
-            {
-                DependentTechs.Add(Upgrade);
-                break;
-            }
-        }
+        DependentTechs.Add(*TechNodes[DependentId].Row);
     }
     
     return DependentTechs;
 }
 
-TArray<UFactoryDefinition*> UDataTableManager::GetUnlockedFactories(
-    const TArray<FDataTableRowHandle>& UnlockedTechs)
+TArray<FUpgradeTableRow> UDataTableManager::GetNewlyAvailableResearch(
+    const FDataTableRowHandle& CompletedTech, 
+    const TArray<FDataTableRowHandle>& CompletedTechs)
 {
-    TArray<UFactoryDefinition*> UnlockedFactories;
+    TArray<FUpgradeTableRow> NewlyAvailable;
     
-    for (UFactoryDefinition* Factory : FactoryDefinitions)
+    FTechUnlockSet CompletedSet = MakeTechUnlockSet(CompletedTechs);
+    TArray<int32> NewlyAvailableIds;
+    CompleteTechnology(GetTechId(CompletedTech), CompletedSet, NewlyAvailableIds);
+    
+    NewlyAvailable.Reserve(NewlyAvailableIds.Num());
+    for (const int32 TechId : NewlyAvailableIds)
     {
-        if (Factory && CanBuildFactory(Factory, UnlockedTechs))
-        {
-            UnlockedFactories.Add(Factory);
-        }
+        NewlyAvailable.Add(*TechNodes[TechId].Row);
     }
     
-    return UnlockedFactories;
+    return NewlyAvailable;
+}
+
+template <typename DefinitionType>
+TArray<DefinitionType*> UDataTableManager::FilterUnlockedDefinitions(const TArray<DefinitionType*>& Definitions,
+    const FTechUnlockSet& UnlockedSet, const TArray<FDataTableRowHandle>& UnlockedTechs) const
+{
+    return FilterDefinitions(Definitions, [&](const DefinitionType* Definition)
+    {
+        // Maska z nierozwiązanymi ID (definicja dodana po załadowaniu) - sprawdź listą
+        const FTechUnlockSet* TechMask = DefinitionTechMasks.Find(Definition);
+        return TechMask && !TechMask->HasUnresolvedTechs()
+            ? UnlockedSet.ContainsAll(*TechMask)
+            : IsDefinitionUnlocked(Definition, Definition->RequiredTechnologies, UnlockedTechs);
+    });
+}
+
+TArray<UFactoryDefinition*> UDataTableManager::GetUnlockedFactories(
+    const TArray<FDataTableRowHandle>& UnlockedTechs)
+{
+    return FilterUnlockedDefinitions(FactoryDefinitions, MakeTechUnlockSet(UnlockedTechs), UnlockedTechs);
 }
 
 TArray<UDepositDefinition*> UDataTableManager::GetUnlockedDeposits(
     const TArray<FDataTableRowHandle>& UnlockedTechs)
 {
-    TArray<UDepositDefinition*> UnlockedDeposits;
-    
-    for (UDepositDefinition* Deposit : DepositDefinitions)
-    {
-        if (Deposit && CanBuildDeposit(Deposit, UnlockedTechs))
-        {
-            UnlockedDeposits.Add(Deposit);
-        }
-    }
-    
-    return UnlockedDeposits;
+    return FilterUnlockedDefinitions(DepositDefinitions, MakeTechUnlockSet(UnlockedTechs), UnlockedTechs);
 }
 
 TArray<UVehicleDefinition*> UDataTableManager::GetUnlockedVehicles(
     const TArray<FDataTableRowHandle>& UnlockedTechs)
 {
-    TArray<UVehicleDefinition*> UnlockedVehicles;
-    
-    for (UVehicleDefinition* Vehicle : VehicleDefinitions)
-    {
-        if (Vehicle && CanUseVehicle(Vehicle, UnlockedTechs))
-        {
-            UnlockedVehicles.Add(Vehicle);
-        }
-    }
-    
-    return UnlockedVehicles;
+    return FilterUnlockedDefinitions(VehicleDefinitions, MakeTechUnlockSet(UnlockedTechs), UnlockedTechs);
 }
 
 TArray<URoadDefinition*> UDataTableManager::GetUnlockedRoads(
     const TArray<FDataTableRowHandle>& UnlockedTechs)
 {
-    TArray<URoadDefinition*> UnlockedRoads;
-    
-    for (URoadDefinition* Road : RoadDefinitions)
-    {
-        if (Road && CanBuildRoad(Road, UnlockedTechs))
-        {
-            UnlockedRoads.Add(Road);
-        }
-    }
-    
-    return UnlockedRoads;
+    return FilterUnlockedDefinitions(RoadDefinitions, MakeTechUnlockSet(UnlockedTechs), UnlockedTechs);
 }
 
 TArray<UHubDefinition*> UDataTableManager::GetUnlockedHubs(
     const TArray<FDataTableRowHandle>& UnlockedTechs)
 {
-    TArray<UHubDefinition*> UnlockedHubs;
-    
-    for (UHubDefinition* Hub : HubDefinitions)
-    {
-        if (Hub && CanBuildHub(Hub, UnlockedTechs))
-        {
-            UnlockedHubs.Add(Hub);
-        }
-    }
-    
-    return UnlockedHubs;
+    return FilterUnlockedDefinitions(HubDefinitions, MakeTechUnlockSet(UnlockedTechs), UnlockedTechs);
 }
 
 TArray<UDemandDefinition*> UDataTableManager::GetUnlockedDemandPoints(
     const TArray<FDataTableRowHandle>& UnlockedTechs)
 {
-    TArray<UDemandDefinition*> UnlockedDemandPoints;
-    
-    for (UDemandDefinition* DemandPoint : DemandDefinitions)
-    {
-        if (DemandPoint && CanBuildDemandPoint(DemandPoint, UnlockedTechs))
-        {
-            UnlockedDemandPoints.Add(DemandPoint);
-        }
-    }
-    
-    return UnlockedDemandPoints;
+    return FilterUnlockedDefinitions(DemandDefinitions, MakeTechUnlockSet(UnlockedTechs), UnlockedTechs);
 }
 
 // === DATAASSET FUNCTIONS ===
 UFactoryDefinition* UDataTableManager::GetFactoryDefinitionByName(const FString& FactoryName)
 {
-    for (UFactoryDefinition* Factory : FactoryDefinitions)
-    {
-        if (Factory && Factory->FactoryName.ToString() == FactoryName)
-        {
-            return Factory;
-        }
-    }
-    
-    return nullptr;
+    return FindDefinitionByName(FactoryDefinitionsByName, IndexedFactoryDefinitions, FactoryDefinitions, FactoryName, GetFactoryName);
 }
 
 UHubDefinition* UDataTableManager::GetHubDefinitionByName(const FString& HubName)
 {
-    for (UHubDefinition* Hub : HubDefinitions)
-    {
-        if (Hub && Hub->HubName.ToString() == HubName)
-        {
-            return Hub;
-        }
-    }
-    
-    return nullptr;
+    return FindDefinitionByName(HubDefinitionsByName, IndexedHubDefinitions, HubDefinitions, HubName, GetHubName);
 }
 
 UVehicleDefinition* UDataTableManager::GetVehicleDefinitionByName(const FString& VehicleName)
 {
-    for (UVehicleDefinition* Vehicle : VehicleDefinitions)
-    {
-        if (Vehicle && Vehicle->VehicleName.ToString() == VehicleName)
-        {
-            return Vehicle;
-        }
-    }
-    
-    return nullptr;
+    return FindDefinitionByName(VehicleDefinitionsByName, IndexedVehicleDefinitions, VehicleDefinitions, VehicleName, GetVehicleName);
 }
 
 URoadDefinition* UDataTableManager::GetRoadDefinitionByName(const FString& RoadName)
 {
-    for (URoadDefinition* Road : RoadDefinitions)
-    {
-        if (Road && Road->RoadName.ToString() == RoadName)
-        {
-            return Road;
-        }
-    }
-    
-    return nullptr;
+    return FindDefinitionByName(RoadDefinitionsByName, IndexedRoadDefinitions, RoadDefinitions, RoadName, GetRoadName);
 }
 
 UDepositDefinition* UDataTableManager::GetDepositDefinitionByName(const FString& DepositName)
 {
-    for (UDepositDefinition* Deposit : DepositDefinitions)
-    {
-        if (Deposit && Deposit->DepositName.ToString() == DepositName)
-        {
-            return Deposit;
-        }
-    }
-    
-    return nullptr;
+    return FindDefinitionByName(DepositDefinitionsByName, IndexedDepositDefinitions, DepositDefinitions, DepositName, GetDepositName);
 }
 
 UDemandDefinition* UDataTableManager::GetDemandDefinitionByName(const FString& DemandName)
 {
-    for (UDemandDefinition* Demand : DemandDefinitions)
-    {
-        if (Demand && Demand->DemandPointName.ToString() == DemandName)
-        {
-            return Demand;
-        }
-    }
-    
-    return nullptr;
+    return FindDefinitionByName(DemandDefinitionsByName, IndexedDemandDefinitions, DemandDefinitions, DemandName, GetDemandName);
 }
 
 // === UTILITY FUNCTIONS ===
@@ -796,6 +956,9 @@ bool UDataTableManager::AreDataTablesLoaded() const
 void UDataTableManager::RefreshDataTables()
 {
     UE_LOG(LogTemp, Log, TEXT("DataTableManager: Refreshing data tables..."));
+    InvalidateRowIndexes();
+    InvalidateTechIndex();
+    InvalidateRecipeGraph();
     LoadAllDataTables();
 }
 
@@ -943,6 +1106,28 @@ void UDataTableManager::PrintTechnologyTree(const TArray<FDataTableRowHandle>& U
             AvailableTech.TechLevel);
     }
     
+    // Pełne drzewo w kolejności topologicznej (prerequisite zawsze przed zależnymi)
+    const FTechUnlockSet UnlockedSet = MakeTechUnlockSet(UnlockedTechs);
+    UE_LOG(LogTemp, Log, TEXT("Research Order: %d"), TechTopologicalOrder.Num());
+    for (const int32 TechId : TechTopologicalOrder)
+    {
+        const FTechNode& Node = TechNodes[TechId];
+        if (!Node.Row)
+        {
+            continue;
+        }
+        
+        const TCHAR* Status = UnlockedSet.Contains(TechId) ? TEXT("✓") 
+            : (IsTechAvailable(TechId, UnlockedSet) ? TEXT("→") : TEXT("✗"));
+        
+        UE_LOG(LogTemp, Log, TEXT("  %s %s (Level: %d, Prerequisites: %d, Unlocks: %d)"), 
+            Status,
+            *Node.Row->UpgradeName.ToString(),
+            Node.Row->TechLevel,
+            Node.Prerequisites.Num(),
+            Node.Dependents.Num());
+    }
+    
     UE_LOG(LogTemp, Log, TEXT("Unlocked Buildings:"));
     TArray<UFactoryDefinition*> UnlockedFactories = GetUnlockedFactories(UnlockedTechs);
     UE_LOG(LogTemp, Log, TEXT("  Factories: %d"), UnlockedFactories.Num());
@@ -980,6 +1165,11 @@ void UDataTableManager::ValidateDataIntegrity()
         bValid = false;
     }
     
+    if (!ValidateTechTreeGraph())
+    {
+        bValid = false;
+    }
+    
     if (bValid)
     {
         UE_LOG(LogTemp, Log, TEXT("DataTableManager: Data integrity validation PASSED"));
@@ -990,6 +1180,356 @@ void UDataTableManager::ValidateDataIntegrity()
     }
 }
 
+// === INDEXED ROW VIEWS ===
+const TArray<const FResourceTableRow*>& UDataTableManager::GetResourceRowsByType(EResourceType ResourceType)
+{
+    EnsureRowIndexes();
+    return FindIndexedRows(ResourcesByType, ResourceType);
+}
+
+const TArray<const FProductionRecipe*>& UDataTableManager::GetRecipeRowsByOutputResource(const FDataTableRowHandle& ResourceReference) const
+{
+    static const TArray<const FProductionRecipe*> NoRecipes;
+    const int32 ResourceId = GetResourceId(ResourceReference);
+    return ResourceNodes.IsValidIndex(ResourceId) ? ResourceNodes[ResourceId].ProducingRecipeRows : NoRecipes;
+}
+
+const TArray<const FUpgradeTableRow*>& UDataTableManager::GetUpgradeRowsByCategory(EUpgradeCategory Category)
+{
+    EnsureRowIndexes();
+    return FindIndexedRows(UpgradesByCategory, Category);
+}
+
+const TArray<const FUpgradeTableRow*>& UDataTableManager::GetUpgradeRowsByType(EUpgradeType Type)
+{
+    EnsureRowIndexes();
+    return FindIndexedRows(UpgradesByType, Type);
+}
+
+const TArray<const FUpgradeTableRow*>& UDataTableManager::GetUpgradeRowsByTechLevel(int32 TechLevel)
+{
+    EnsureRowIndexes();
+    return FindIndexedRows(UpgradesByTechLevel, TechLevel);
+}
+
+const TArray<const FTransportRoute*>& UDataTableManager::GetRouteRowsFromHub(const UHubDefinition* HubDef)
+{
+    EnsureRowIndexes();
+    return FindIndexedRows(RoutesByStartHub, FSoftObjectPath(HubDef));
+}
+
+const TArray<const FTransportRoute*>& UDataTableManager::GetRouteRowsToHub(const UHubDefinition* HubDef)
+{
+    EnsureRowIndexes();
+    return FindIndexedRows(RoutesByEndHub, FSoftObjectPath(HubDef));
+}
+
+// === TECHNOLOGY UNLOCK SETS ===
+int32 UDataTableManager::GetTechId(const FDataTableRowHandle& TechReference) const
+{
+    const int32* TechId = TechIdByReference.Find(TechReference);
+    return TechId ? *TechId : INDEX_NONE;
+}
+
+FDataTableRowHandle UDataTableManager::GetTechReference(int32 TechId) const
+{
+    return TechReferences.IsValidIndex(TechId) ? TechReferences[TechId] : FDataTableRowHandle();
+}
+
+FTechUnlockSet UDataTableManager::MakeTechUnlockSet(const TArray<FDataTableRowHandle>& UnlockedTechs) const
+{
+    // Nieznane technologie pomijamy - żadna prekompilowana maska ich nie wymaga
+    FTechUnlockSet UnlockedSet;
+    for (const FDataTableRowHandle& UnlockedTech : UnlockedTechs)
+    {
+        UnlockedSet.Add(GetTechId(UnlockedTech));
+    }
+    return UnlockedSet;
+}
+
+FTechUnlockSet UDataTableManager::MakeTechRequirementSet(const TArray<FDataTableRowHandle>& RequiredTechs) const
+{
+    FTechUnlockSet RequiredSet;
+    for (const FDataTableRowHandle& RequiredTech : RequiredTechs)
+    {
+        const int32 TechId = GetTechId(RequiredTech);
+        if (TechId == INDEX_NONE)
+        {
+            RequiredSet.MarkUnresolved();
+            continue;
+        }
+        RequiredSet.Add(TechId);
+    }
+    return RequiredSet;
+}
+
+bool UDataTableManager::AreTechnologiesUnlocked(const FTechUnlockSet& RequiredTechs, const FTechUnlockSet& UnlockedTechs) const
+{
+    return UnlockedTechs.ContainsAll(RequiredTechs);
+}
+
+TArray<FDataTableRowHandle> UDataTableManager::GetMissingTechnologies(const TArray<FDataTableRowHandle>& RequiredTechs, 
+                                                                     const FTechUnlockSet& UnlockedTechs) const
+{
+    TArray<FDataTableRowHandle> MissingTechs;
+    
+    for (const FDataTableRowHandle& RequiredTech : RequiredTechs)
+    {
+        if (!UnlockedTechs.Contains(GetTechId(RequiredTech)))
+        {
+            MissingTechs.Add(RequiredTech);
+        }
+    }
+    
+    return MissingTechs;
+}
+
+bool UDataTableManager::AreUpgradePrerequisitesMet(const FDataTableRowHandle& UpgradeReference, const FTechUnlockSet& CompletedUpgrades)
+{
+    if (const FTechUnlockSet* PrerequisiteMask = FindPrerequisiteMask(UpgradeReference))
+    {
+        return CompletedUpgrades.ContainsAll(*PrerequisiteMask);
+    }
+    
+    FUpgradeTableRow* UpgradeData = GetUpgradeDataInternal(UpgradeReference);
+    if (!UpgradeData)
+    {
+        return false;
+    }
+    
+    for (const FUpgradeRequirement& Prerequisite : UpgradeData->Prerequisites)
+    {
+        if (!Prerequisite.IsOptional && !CompletedUpgrades.Contains(GetTechId(Prerequisite.RequiredUpgradeReference)))
+        {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+bool UDataTableManager::CanBuildFactory(const UFactoryDefinition* FactoryDef, const FTechUnlockSet& UnlockedTechs) const
+{
+    return FactoryDef && IsDefinitionUnlocked(FactoryDef, FactoryDef->RequiredTechnologies, UnlockedTechs);
+}
+
+bool UDataTableManager::CanBuildDeposit(const UDepositDefinition* DepositDef, const FTechUnlockSet& UnlockedTechs) const
+{
+    return DepositDef && IsDefinitionUnlocked(DepositDef, DepositDef->RequiredTechnologies, UnlockedTechs);
+}
+
+bool UDataTableManager::CanBuildHub(const UHubDefinition* HubDef, const FTechUnlockSet& UnlockedTechs) const
+{
+    return HubDef && IsDefinitionUnlocked(HubDef, HubDef->RequiredTechnologies, UnlockedTechs);
+}
+
+bool UDataTableManager::CanBuildRoad(const URoadDefinition* RoadDef, const FTechUnlockSet& UnlockedTechs) const
+{
+    return RoadDef && IsDefinitionUnlocked(RoadDef, RoadDef->RequiredTechnologies, UnlockedTechs);
+}
+
+bool UDataTableManager::CanUseVehicle(const UVehicleDefinition* VehicleDef, const FTechUnlockSet& UnlockedTechs) const
+{
+    return VehicleDef && IsDefinitionUnlocked(VehicleDef, VehicleDef->RequiredTechnologies, UnlockedTechs);
+}
+
+bool UDataTableManager::CanBuildDemandPoint(const UDemandDefinition* DemandDef, const FTechUnlockSet& UnlockedTechs) const
+{
+    return DemandDef && IsDefinitionUnlocked(DemandDef, DemandDef->RequiredTechnologies, UnlockedTechs);
+}
+
+bool UDataTableManager::CanUseRecipe(const FDataTableRowHandle& RecipeRef, const FTechUnlockSet& UnlockedTechs)
+{
+    if (const FTechUnlockSet* RecipeMask = RecipeTechMasks.Find(RecipeRef))
+    {
+        return UnlockedTechs.ContainsAll(*RecipeMask);
+    }
+    
+    FProductionRecipe* Recipe = GetProductionRecipeInternal(RecipeRef);
+    if (!Recipe)
+    {
+        return false;
+    }
+    
+    return UnlockedTechs.ContainsAll(MakeTechRequirementSet(Recipe->RequiredUpgrades));
+}
+
+TArray<FUpgradeTableRow> UDataTableManager::GetAvailableResearch(const FTechUnlockSet& CompletedTechs)
+{
+    TArray<FUpgradeTableRow> AvailableResearch;
+    
+    if (!UpgradeDataTable)
+    {
+        return AvailableResearch;
+    }
+    
+    // Uchwyty budujemy z nazw wierszy tabeli (nie z UpgradeName)
+    for (const TPair<FName, uint8*>& RowPair : UpgradeDataTable->GetRowMap())
+    {
+        FDataTableRowHandle UpgradeRef;
+        UpgradeRef.DataTable = UpgradeDataTable;
+        UpgradeRef.RowName = RowPair.Key;
+        
+        if (CompletedTechs.Contains(GetTechId(UpgradeRef)))
+        {
+            continue;
+        }
+        
+        if (AreUpgradePrerequisitesMet(UpgradeRef, CompletedTechs))
+        {
+            AvailableResearch.Add(*reinterpret_cast<const FUpgradeTableRow*>(RowPair.Value));
+        }
+    }
+    
+    return AvailableResearch;
+}
+
+TArray<UFactoryDefinition*> UDataTableManager::GetUnlockedFactories(const FTechUnlockSet& UnlockedTechs) const
+{
+    return FilterDefinitions(FactoryDefinitions, [&](const UFactoryDefinition* Definition) { return CanBuildFactory(Definition, UnlockedTechs); });
+}
+
+TArray<UDepositDefinition*> UDataTableManager::GetUnlockedDeposits(const FTechUnlockSet& UnlockedTechs) const
+{
+    return FilterDefinitions(DepositDefinitions, [&](const UDepositDefinition* Definition) { return CanBuildDeposit(Definition, UnlockedTechs); });
+}
+
+TArray<UVehicleDefinition*> UDataTableManager::GetUnlockedVehicles(const FTechUnlockSet& UnlockedTechs) const
+{
+    return FilterDefinitions(VehicleDefinitions, [&](const UVehicleDefinition* Definition) { return CanUseVehicle(Definition, UnlockedTechs); });
+}
+
+TArray<URoadDefinition*> UDataTableManager::GetUnlockedRoads(const FTechUnlockSet& UnlockedTechs) const
+{
+    return FilterDefinitions(RoadDefinitions, [&](const URoadDefinition* Definition) { return CanBuildRoad(Definition, UnlockedTechs); });
+}
+
+TArray<UHubDefinition*> UDataTableManager::GetUnlockedHubs(const FTechUnlockSet& UnlockedTechs) const
+{
+    return FilterDefinitions(HubDefinitions, [&](const UHubDefinition* Definition) { return CanBuildHub(Definition, UnlockedTechs); });
+}
+
+TArray<UDemandDefinition*> UDataTableManager::GetUnlockedDemandPoints(const FTechUnlockSet& UnlockedTechs) const
+{
+    return FilterDefinitions(DemandDefinitions, [&](const UDemandDefinition* Definition) { return CanBuildDemandPoint(Definition, UnlockedTechs); });
+}
+
+// === TECH TREE GRAPH ===
+const TArray<int32>& UDataTableManager::GetTechDependents(int32 TechId) const
+{
+    static const TArray<int32> NoTechs;
+    return TechNodes.IsValidIndex(TechId) ? TechNodes[TechId].Dependents : NoTechs;
+}
+
+const TArray<int32>& UDataTableManager::GetTechPrerequisites(int32 TechId) const
+{
+    static const TArray<int32> NoTechs;
+    return TechNodes.IsValidIndex(TechId) ? TechNodes[TechId].Prerequisites : NoTechs;
+}
+
+const FUpgradeTableRow* UDataTableManager::GetTechRow(int32 TechId) const
+{
+    return TechNodes.IsValidIndex(TechId) ? TechNodes[TechId].Row : nullptr;
+}
+
+bool UDataTableManager::IsTechAvailable(int32 TechId, const FTechUnlockSet& CompletedTechs) const
+{
+    if (!TechNodes.IsValidIndex(TechId) || !TechNodes[TechId].Row || CompletedTechs.Contains(TechId))
+    {
+        return false;
+    }
+    
+    return CompletedTechs.ContainsAll(TechNodes[TechId].MandatoryPrerequisites);
+}
+
+bool UDataTableManager::CompleteTechnology(int32 TechId, FTechUnlockSet& InOutCompletedTechs, 
+                                           TArray<int32>& OutNewlyAvailableTechIds) const
+{
+    OutNewlyAvailableTechIds.Reset();
+    
+    if (!TechNodes.IsValidIndex(TechId) || !TechNodes[TechId].Row)
+    {
+        return false;
+    }
+    
+    // Ponowne ukończenie nic nie odblokowuje - inaczej dostępni, nieukończeni następnicy wróciliby jako "nowi"
+    if (InOutCompletedTechs.Contains(TechId))
+    {
+        return true;
+    }
+    
+    InOutCompletedTechs.Add(TechId);
+    
+    // Tylko bezpośredni następnicy mogą zmienić stan - reszta drzewa jest nietknięta.
+    // Krawędź opcjonalna nie zmienia dostępności, więc wymagamy jej w masce obowiązkowej.
+    for (const int32 DependentId : TechNodes[TechId].Dependents)
+    {
+        if (TechNodes[DependentId].MandatoryPrerequisites.Contains(TechId) && 
+            IsTechAvailable(DependentId, InOutCompletedTechs))
+        {
+            OutNewlyAvailableTechIds.Add(DependentId);
+        }
+    }
+    
+    return true;
+}
+
+// === RECIPE GRAPH ===
+int32 UDataTableManager::GetResourceId(const FDataTableRowHandle& ResourceReference) const
+{
+    const int32* ResourceId = ResourceIdByReference.Find(ResourceReference);
+    return ResourceId ? *ResourceId : INDEX_NONE;
+}
+
+FDataTableRowHandle UDataTableManager::GetResourceReference(int32 ResourceId) const
+{
+    return ResourceNodes.IsValidIndex(ResourceId) ? ResourceNodes[ResourceId].Reference : FDataTableRowHandle();
+}
+
+FDataTableRowHandle UDataTableManager::GetRecipeReference(int32 RecipeId) const
+{
+    return RecipeNodes.IsValidIndex(RecipeId) ? RecipeNodes[RecipeId].Reference : FDataTableRowHandle();
+}
+
+const FProductionRecipe* UDataTableManager::GetRecipeRow(int32 RecipeId) const
+{
+    return RecipeNodes.IsValidIndex(RecipeId) ? RecipeNodes[RecipeId].Row : nullptr;
+}
+
+const TArray<int32>& UDataTableManager::GetProducingRecipeIds(int32 ResourceId) const
+{
+    static const TArray<int32> NoRecipes;
+    return ResourceNodes.IsValidIndex(ResourceId) ? ResourceNodes[ResourceId].ProducingRecipes : NoRecipes;
+}
+
+const TArray<int32>& UDataTableManager::GetConsumingRecipeIds(int32 ResourceId) const
+{
+    static const TArray<int32> NoRecipes;
+    return ResourceNodes.IsValidIndex(ResourceId) ? ResourceNodes[ResourceId].ConsumingRecipes : NoRecipes;
+}
+
+const TArray<int32>& UDataTableManager::GetRecipeInputResourceIds(int32 RecipeId) const
+{
+    static const TArray<int32> NoResources;
+    return RecipeNodes.IsValidIndex(RecipeId) ? RecipeNodes[RecipeId].InputResources : NoResources;
+}
+
+int32 UDataTableManager::GetRecipeOutputResourceId(int32 RecipeId) const
+{
+    return RecipeNodes.IsValidIndex(RecipeId) ? RecipeNodes[RecipeId].OutputResource : INDEX_NONE;
+}
+
+const TArray<int32>& UDataTableManager::GetRawMaterialIds(int32 ResourceId) const
+{
+    static const TArray<int32> NoResources;
+    return ResourceNodes.IsValidIndex(ResourceId) ? ResourceNodes[ResourceId].RawMaterials : NoResources;
+}
+
+bool UDataTableManager::IsRawMaterial(int32 ResourceId) const
+{
+    return ResourceNodes.IsValidIndex(ResourceId) && ResourceNodes[ResourceId].bIsRawMaterial;
+}
+
 // === PRIVATE HELPER FUNCTIONS ===
 FResourceTableRow* UDataTableManager::GetResourceDataInternal(const FDataTableRowHandle& ResourceReference)
 {
@@ -1028,6 +1568,18 @@ bool UDataTableManager::IsDataTableRowHandleValid(const FDataTableRowHandle& Han
 
 bool UDataTableManager::AreTechnologiesUnlockedInternal(const TArray<FDataTableRowHandle>& RequiredTechs, 
                                                        const TArray<FDataTableRowHandle>& UnlockedTechs) const
+{
+    const FTechUnlockSet RequiredSet = MakeTechRequirementSet(RequiredTechs);
+    if (RequiredSet.HasUnresolvedTechs())
+    {
+        return AreTechnologiesUnlockedLinear(RequiredTechs, UnlockedTechs);
+    }
+    
+    return MakeTechUnlockSet(UnlockedTechs).ContainsAll(RequiredSet);
+}
+
+bool UDataTableManager::AreTechnologiesUnlockedLinear(const TArray<FDataTableRowHandle>& RequiredTechs, 
+                                                     const TArray<FDataTableRowHandle>& UnlockedTechs) const
 {
     for (const FDataTableRowHandle& RequiredTech : RequiredTechs)
     {
@@ -1263,6 +1815,501 @@ bool UDataTableManager::ValidateTechnologyReferences()
     return bValid;
 }
 
+void UDataTableManager::BuildRowIndexes()
+{
+    InvalidateRowIndexes();
+    
+    // Edycja / reimport tabeli przepisuje RowMap - wskaźniki w indeksach trzeba wtedy odbudować
+    IndexedResourceTable = ResourceDataTable;
+    IndexedUpgradeTable = UpgradeDataTable;
+    IndexedTransportTable = TransportDataTable;
+    for (UDataTable* DataTable : { ResourceDataTable, UpgradeDataTable, TransportDataTable })
+    {
+        if (DataTable)
+        {
+            DataTable->OnDataTableChanged().AddUObject(this, &UDataTableManager::HandleIndexedDataTableChanged);
+        }
+    }
+    
+    if (ResourceDataTable)
+    {
+        TArray<FResourceTableRow*> RowPointers;
+        ResourceDataTable->GetAllRows<FResourceTableRow>(TEXT("BuildRowIndexes"), RowPointers);
+        
+        for (const FResourceTableRow* Row : RowPointers)
+        {
+            if (Row)
+            {
+                ResourcesByType.FindOrAdd(Row->ResourceType).Add(Row);
+            }
+        }
+    }
+    
+    if (UpgradeDataTable)
+    {
+        TArray<FUpgradeTableRow*> RowPointers;
+        UpgradeDataTable->GetAllRows<FUpgradeTableRow>(TEXT("BuildRowIndexes"), RowPointers);
+        
+        for (const FUpgradeTableRow* Row : RowPointers)
+        {
+            if (Row)
+            {
+                UpgradesByCategory.FindOrAdd(Row->UpgradeCategory).Add(Row);
+                UpgradesByType.FindOrAdd(Row->UpgradeType).Add(Row);
+                UpgradesByTechLevel.FindOrAdd(Row->TechLevel).Add(Row);
+            }
+        }
+    }
+    
+    if (TransportDataTable)
+    {
+        TArray<FTransportRoute*> RowPointers;
+        TransportDataTable->GetAllRows<FTransportRoute>(TEXT("BuildRowIndexes"), RowPointers);
+        
+        for (const FTransportRoute* Row : RowPointers)
+        {
+            if (Row)
+            {
+                RoutesByStartHub.FindOrAdd(Row->StartHubReference.ToSoftObjectPath()).Add(Row);
+                RoutesByEndHub.FindOrAdd(Row->EndHubReference.ToSoftObjectPath()).Add(Row);
+            }
+        }
+    }
+    
+    bRowIndexesBuilt = true;
+    
+    UE_LOG(LogTemp, Log, TEXT("DataTableManager: Built row indexes (%d resource types, %d tech levels, %d start hubs)"),
+        ResourcesByType.Num(), UpgradesByTechLevel.Num(), RoutesByStartHub.Num());
+}
+
+void UDataTableManager::InvalidateRowIndexes()
+{
+    for (const TWeakObjectPtr<UDataTable>& DataTable : { IndexedResourceTable, IndexedUpgradeTable, IndexedTransportTable })
+    {
+        if (DataTable.IsValid())
+        {
+            DataTable->OnDataTableChanged().RemoveAll(this);
+        }
+    }
+    IndexedResourceTable.Reset();
+    IndexedUpgradeTable.Reset();
+    IndexedTransportTable.Reset();
+    
+    ResourcesByType.Empty();
+    UpgradesByCategory.Empty();
+    UpgradesByType.Empty();
+    UpgradesByTechLevel.Empty();
+    RoutesByStartHub.Empty();
+    RoutesByEndHub.Empty();
+    
+    bRowIndexesBuilt = false;
+}
+
+void UDataTableManager::EnsureRowIndexes()
+{
+    // Właściwości tabel są BlueprintReadWrite - podmiana tabeli też unieważnia indeksy
+    const bool bTablesReassigned = IndexedResourceTable.Get() != ResourceDataTable
+        || IndexedUpgradeTable.Get() != UpgradeDataTable
+        || IndexedTransportTable.Get() != TransportDataTable;
+    
+    if (!bRowIndexesBuilt || bTablesReassigned)
+    {
+        BuildRowIndexes();
+    }
+}
+
+void UDataTableManager::HandleIndexedDataTableChanged()
+{
+    // Przebudowa leniwie, przy następnym zapytaniu - edycja w edytorze zmienia wiele wierszy naraz
+    bRowIndexesBuilt = false;
+}
+
+bool UDataTableManager::IsDefinitionUnlocked(const UObject* Definition, const TArray<FDataTableRowHandle>& RequiredTechs,
+                                             const FTechUnlockSet& UnlockedTechs) const
+{
+    if (const FTechUnlockSet* TechMask = DefinitionTechMasks.Find(Definition))
+    {
+        return UnlockedTechs.ContainsAll(*TechMask);
+    }
+    
+    return UnlockedTechs.ContainsAll(MakeTechRequirementSet(RequiredTechs));
+}
+
+bool UDataTableManager::IsDefinitionUnlocked(const UObject* Definition, const TArray<FDataTableRowHandle>& RequiredTechs,
+                                             const TArray<FDataTableRowHandle>& UnlockedTechs) const
+{
+    const FTechUnlockSet* TechMask = DefinitionTechMasks.Find(Definition);
+    if (TechMask && !TechMask->HasUnresolvedTechs())
+    {
+        return MakeTechUnlockSet(UnlockedTechs).ContainsAll(*TechMask);
+    }
+    
+    return AreTechnologiesUnlockedInternal(RequiredTechs, UnlockedTechs);
+}
+
+int32 UDataTableManager::RegisterTechId(const FDataTableRowHandle& TechReference)
+{
+    if (!IsDataTableRowHandleValid(TechReference))
+    {
+        return INDEX_NONE;
+    }
+    
+    if (const int32* ExistingId = TechIdByReference.Find(TechReference))
+    {
+        return *ExistingId;
+    }
+    
+    const int32 NewId = TechReferences.Add(TechReference);
+    TechIdByReference.Add(TechReference, NewId);
+    return NewId;
+}
+
+void UDataTableManager::BuildTechIndex()
+{
+    InvalidateTechIndex();
+    
+    // 1. ID dla każdego wiersza tabeli upgrade'ów (stała kolejność = kolejność w tabeli)
+    if (UpgradeDataTable)
+    {
+        for (const TPair<FName, uint8*>& RowPair : UpgradeDataTable->GetRowMap())
+        {
+            FDataTableRowHandle UpgradeRef;
+            UpgradeRef.DataTable = UpgradeDataTable;
+            UpgradeRef.RowName = RowPair.Key;
+            RegisterTechId(UpgradeRef);
+        }
+    }
+    
+    // 2. ID dla referencji spoza tabeli, żeby maski definicji były zawsze rozwiązane
+    auto RegisterDefinitionTechs = [this](const auto& Definitions)
+    {
+        for (const auto* Definition : Definitions)
+        {
+            if (Definition)
+            {
+                for (const FDataTableRowHandle& TechRef : Definition->RequiredTechnologies)
+                {
+                    RegisterTechId(TechRef);
+                }
+            }
+        }
+    };
+    RegisterDefinitionTechs(FactoryDefinitions);
+    RegisterDefinitionTechs(HubDefinitions);
+    RegisterDefinitionTechs(VehicleDefinitions);
+    RegisterDefinitionTechs(RoadDefinitions);
+    RegisterDefinitionTechs(DepositDefinitions);
+    RegisterDefinitionTechs(DemandDefinitions);
+    
+    TArray<TPair<FDataTableRowHandle, const FProductionRecipe*>> RecipeRows;
+    if (ProductionDataTable)
+    {
+        for (const TPair<FName, uint8*>& RowPair : ProductionDataTable->GetRowMap())
+        {
+            FDataTableRowHandle RecipeRef;
+            RecipeRef.DataTable = ProductionDataTable;
+            RecipeRef.RowName = RowPair.Key;
+            
+            const FProductionRecipe* Recipe = reinterpret_cast<const FProductionRecipe*>(RowPair.Value);
+            RecipeRows.Emplace(RecipeRef, Recipe);
+            
+            for (const FDataTableRowHandle& TechRef : Recipe->RequiredUpgrades)
+            {
+                RegisterTechId(TechRef);
+            }
+        }
+    }
+    
+    TArray<TPair<FDataTableRowHandle, const FUpgradeTableRow*>> UpgradeRows;
+    if (UpgradeDataTable)
+    {
+        for (const TPair<FName, uint8*>& RowPair : UpgradeDataTable->GetRowMap())
+        {
+            FDataTableRowHandle UpgradeRef;
+            UpgradeRef.DataTable = UpgradeDataTable;
+            UpgradeRef.RowName = RowPair.Key;
+            
+            const FUpgradeTableRow* Upgrade = reinterpret_cast<const FUpgradeTableRow*>(RowPair.Value);
+            UpgradeRows.Emplace(UpgradeRef, Upgrade);
+            
+            for (const FUpgradeRequirement& Prerequisite : Upgrade->Prerequisites)
+            {
+                RegisterTechId(Prerequisite.RequiredUpgradeReference);
+            }
+        }
+    }
+    
+    // 3. Prekompilowane maski wymagań
+    auto BuildDefinitionMasks = [this](const auto& Definitions)
+    {
+        for (const auto* Definition : Definitions)
+        {
+            if (Definition)
+            {
+                DefinitionTechMasks.Add(Definition, MakeTechRequirementSet(Definition->RequiredTechnologies));
+            }
+        }
+    };
+    BuildDefinitionMasks(FactoryDefinitions);
+    BuildDefinitionMasks(HubDefinitions);
+    BuildDefinitionMasks(VehicleDefinitions);
+    BuildDefinitionMasks(RoadDefinitions);
+    BuildDefinitionMasks(DepositDefinitions);
+    BuildDefinitionMasks(DemandDefinitions);
+    
+    for (const TPair<FDataTableRowHandle, const FProductionRecipe*>& RecipeRow : RecipeRows)
+    {
+        RecipeTechMasks.Add(RecipeRow.Key, MakeTechRequirementSet(RecipeRow.Value->RequiredUpgrades));
+    }
+    
+    // 4. Graf drzewa technologii (krawędzie prerequisite -> upgrade)
+    TechNodes.SetNum(TechReferences.Num());
+    
+    for (const TPair<FDataTableRowHandle, const FUpgradeTableRow*>& UpgradeRow : UpgradeRows)
+    {
+        const int32 UpgradeId = GetTechId(UpgradeRow.Key);
+        FTechNode& Node = TechNodes[UpgradeId];
+        Node.Row = UpgradeRow.Value;
+        
+        for (const FUpgradeRequirement& Prerequisite : UpgradeRow.Value->Prerequisites)
+        {
+            const int32 PrerequisiteId = GetTechId(Prerequisite.RequiredUpgradeReference);
+            
+            // Opcjonalne prerequisite nigdy nie blokują badania - tylko obowiązkowe trafiają do maski
+            if (!Prerequisite.IsOptional)
+            {
+                if (PrerequisiteId == INDEX_NONE)
+                {
+                    Node.MandatoryPrerequisites.MarkUnresolved();
+                }
+                else
+                {
+                    Node.MandatoryPrerequisites.Add(PrerequisiteId);
+                }
+            }
+            
+            if (PrerequisiteId != INDEX_NONE && !Node.Prerequisites.Contains(PrerequisiteId))
+            {
+                Node.Prerequisites.Add(PrerequisiteId);
+                TechNodes[PrerequisiteId].Dependents.Add(UpgradeId);
+            }
+        }
+    }
+    
+    BuildTechTopologicalOrder();
+    
+    UE_LOG(LogTemp, Log, TEXT("DataTableManager: Built tech index (%d tech IDs, %d definition masks, %d recipe masks, %d cyclic techs)"),
+        TechReferences.Num(), DefinitionTechMasks.Num(), RecipeTechMasks.Num(), TechCycleNodes.Num());
+}
+
+void UDataTableManager::BuildTechTopologicalOrder()
+{
+    // Kahn: kolejka FIFO po ID, więc kolejność jest stabilna między ładowaniami
+    TArray<int32> PendingPrerequisites;
+    PendingPrerequisites.SetNumUninitialized(TechNodes.Num());
+    
+    TArray<int32> ReadyQueue;
+    ReadyQueue.Reserve(TechNodes.Num());
+    
+    for (int32 TechId = 0; TechId < TechNodes.Num(); ++TechId)
+    {
+        PendingPrerequisites[TechId] = TechNodes[TechId].Prerequisites.Num();
+        if (PendingPrerequisites[TechId] == 0)
+        {
+            ReadyQueue.Add(TechId);
+        }
+    }
+    
+    TechTopologicalOrder.Reset(TechNodes.Num());
+    
+    for (int32 QueueIndex = 0; QueueIndex < ReadyQueue.Num(); ++QueueIndex)
+    {
+        const int32 TechId = ReadyQueue[QueueIndex];
+        TechTopologicalOrder.Add(TechId);
+        
+        for (const int32 DependentId : TechNodes[TechId].Dependents)
+        {
+            if (--PendingPrerequisites[DependentId] == 0)
+            {
+                ReadyQueue.Add(DependentId);
+            }
+        }
+    }
+    
+    // Wszystko, co nie trafiło do kolejności, leży na cyklu lub za nim
+    TechCycleNodes.Reset();
+    for (int32 TechId = 0; TechId < TechNodes.Num(); ++TechId)
+    {
+        if (PendingPrerequisites[TechId] > 0)
+        {
+            TechCycleNodes.Add(TechId);
+        }
+    }
+}
+
+void UDataTableManager::InvalidateTechIndex()
+{
+    TechIdByReference.Empty();
+    TechReferences.Empty();
+    DefinitionTechMasks.Empty();
+    RecipeTechMasks.Empty();
+    TechNodes.Empty();
+    TechTopologicalOrder.Empty();
+    TechCycleNodes.Empty();
+}
+
+int32 UDataTableManager::RegisterResourceId(const FDataTableRowHandle& ResourceReference)
+{
+    if (!IsDataTableRowHandleValid(ResourceReference))
+    {
+        return INDEX_NONE;
+    }
+    
+    if (const int32* ExistingId = ResourceIdByReference.Find(ResourceReference))
+    {
+        return *ExistingId;
+    }
+    
+    const int32 NewId = ResourceNodes.AddDefaulted();
+    ResourceNodes[NewId].Reference = ResourceReference;
+    ResourceIdByReference.Add(ResourceReference, NewId);
+    return NewId;
+}
+
+void UDataTableManager::BuildRecipeGraph()
+{
+    InvalidateRecipeGraph();
+    
+    // 1. ID dla każdego zasobu z tabeli (kolejność tabeli), potem referencje użyte tylko w recepturach
+    if (ResourceDataTable)
+    {
+        for (const TPair<FName, uint8*>& RowPair : ResourceDataTable->GetRowMap())
+        {
+            FDataTableRowHandle ResourceRef;
+            ResourceRef.DataTable = ResourceDataTable;
+            ResourceRef.RowName = RowPair.Key;
+            RegisterResourceId(ResourceRef);
+        }
+    }
+    
+    if (ProductionDataTable)
+    {
+        for (const TPair<FName, uint8*>& RowPair : ProductionDataTable->GetRowMap())
+        {
+            const FProductionRecipe* Recipe = reinterpret_cast<const FProductionRecipe*>(RowPair.Value);
+            
+            FRecipeGraphRecipe& RecipeNode = RecipeNodes.AddDefaulted_GetRef();
+            RecipeNode.Reference.DataTable = ProductionDataTable;
+            RecipeNode.Reference.RowName = RowPair.Key;
+            RecipeNode.Row = Recipe;
+            RecipeNode.OutputResource = RegisterResourceId(Recipe->OutputResourceReference);
+            
+            for (const FResourceRequirement& Input : Recipe->InputResources)
+            {
+                const int32 InputId = Input.Quantity > 0 ? RegisterResourceId(Input.ResourceReference) : INDEX_NONE;
+                if (InputId != INDEX_NONE)
+                {
+                    RecipeNode.InputResources.AddUnique(InputId);
+                }
+            }
+        }
+    }
+    
+    // 2. Listy sąsiedztwa zasób -> receptury
+    for (int32 RecipeId = 0; RecipeId < RecipeNodes.Num(); ++RecipeId)
+    {
+        const FRecipeGraphRecipe& RecipeNode = RecipeNodes[RecipeId];
+        if (RecipeNode.OutputResource != INDEX_NONE)
+        {
+            ResourceNodes[RecipeNode.OutputResource].ProducingRecipes.Add(RecipeId);
+            ResourceNodes[RecipeNode.OutputResource].ProducingRecipeRows.Add(RecipeNode.Row);
+        }
+        
+        for (const int32 InputId : RecipeNode.InputResources)
+        {
+            ResourceNodes[InputId].ConsumingRecipes.Add(RecipeId);
+        }
+    }
+    
+    // 3. Domknięcie surowców: zasób -> wejścia wszystkich receptur, które go produkują
+    TArray<bool> IsRaw;
+    TArray<TArray<int32>> Successors;
+    IsRaw.SetNumZeroed(ResourceNodes.Num());
+    Successors.SetNum(ResourceNodes.Num());
+    
+    for (int32 ResourceId = 0; ResourceId < ResourceNodes.Num(); ++ResourceId)
+    {
+        FRecipeGraphResource& ResourceNode = ResourceNodes[ResourceId];
+        const FResourceTableRow* ResourceRow = GetResourceDataInternal(ResourceNode.Reference);
+        
+        // Surowiec z typu RawMaterial zostaje liściem nawet jeśli jakaś receptura go produkuje (np. recykling)
+        ResourceNode.bIsRawMaterial = ResourceNode.ProducingRecipes.Num() == 0
+            || (ResourceRow && ResourceRow->ResourceType == EResourceType::RawMaterial);
+        IsRaw[ResourceId] = ResourceNode.bIsRawMaterial;
+        
+        if (!ResourceNode.bIsRawMaterial)
+        {
+            for (const int32 RecipeId : ResourceNode.ProducingRecipes)
+            {
+                for (const int32 InputId : RecipeNodes[RecipeId].InputResources)
+                {
+                    Successors[ResourceId].AddUnique(InputId);
+                }
+            }
+        }
+    }
+    
+    TArray<TArray<int32>> Closures;
+    FRawMaterialClosureBuilder(Successors, IsRaw, Closures).Build();
+    
+    for (int32 ResourceId = 0; ResourceId < ResourceNodes.Num(); ++ResourceId)
+    {
+        ResourceNodes[ResourceId].RawMaterials = MoveTemp(Closures[ResourceId]);
+    }
+    
+    UE_LOG(LogTemp, Log, TEXT("DataTableManager: Built recipe graph (%d resources, %d recipes)"),
+        ResourceNodes.Num(), RecipeNodes.Num());
+}
+
+void UDataTableManager::InvalidateRecipeGraph()
+{
+    ResourceIdByReference.Empty();
+    ResourceNodes.Empty();
+    RecipeNodes.Empty();
+}
+
+const FTechUnlockSet* UDataTableManager::FindPrerequisiteMask(const FDataTableRowHandle& UpgradeReference) const
+{
+    const int32 TechId = GetTechId(UpgradeReference);
+    if (!TechNodes.IsValidIndex(TechId) || !TechNodes[TechId].Row)
+    {
+        return nullptr;
+    }
+    
+    return &TechNodes[TechId].MandatoryPrerequisites;
+}
+
+bool UDataTableManager::ValidateTechTreeGraph()
+{
+    if (TechCycleNodes.Num() == 0)
+    {
+        return true;
+    }
+    
+    UE_LOG(LogTemp, Error, TEXT("DataTableManager: Technology tree has a prerequisite cycle (%d techs cannot be researched):"), 
+        TechCycleNodes.Num());
+    
+    for (const int32 TechId : TechCycleNodes)
+    {
+        const FTechNode& Node = TechNodes[TechId];
+        UE_LOG(LogTemp, Error, TEXT("  ✗ %s (%s)"), 
+            Node.Row ? *Node.Row->UpgradeName.ToString() : TEXT("Unknown Upgrade"),
+            *TechReferences[TechId].RowName.ToString());
+    }
+    
+    return false;
+}
+
 void UDataTableManager::LogDataTableStats()
 {
     UE_LOG(LogTemp, Log, TEXT("=== DATA TABLE STATISTICS (Unified Tech Reference System) ==="));
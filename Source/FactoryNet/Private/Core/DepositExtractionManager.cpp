@@ -0,0 +1,361 @@
+// DepositExtractionManager.cpp
+// Lokalizacja: Source/FactoryNet/Private/Core/DepositExtractionManager.cpp
+
+#include "Core/DepositExtractionManager.h"
+#include "Buildings/Base/ResourceDeposit.h"
+#include "Components/ResourceStorageComponent.h"
+
+UDepositExtractionManager::UDepositExtractionManager()
+{
+    TimeSliceCount = 1;
+    NextTimeSlice = 0;
+    StorageBeingWritten = nullptr;
+    LastChangedDepositCount = 0;
+}
+
+void UDepositExtractionManager::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    SimulationTime = 0.0;
+}
+
+void UDepositExtractionManager::Deinitialize()
+{
+    for (int32 Slot = 0; Slot < Deposits.Num(); ++Slot)
+    {
+        if (IsValid(Deposits[Slot]) && Deposits[Slot]->GetStorageComponent())
+        {
+            Deposits[Slot]->GetStorageComponent()->OnStorageContentsChanged.Remove(StorageHandles[Slot]);
+        }
+    }
+
+    Deposits.Empty();
+    Production.Empty();
+    LastSimulatedTimes.Empty();
+    ExtractionIntervals.Empty();
+    TimeSinceExtraction.Empty();
+    Reserves.Empty();
+    FreeSpace.Empty();
+    PendingAmounts.Empty();
+    DirtyFlags.Empty();
+    DirtySlots.Empty();
+    SlotByDeposit.Empty();
+    StorageHandles.Empty();
+
+    Super::Deinitialize();
+}
+
+TStatId UDepositExtractionManager::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UDepositExtractionManager, STATGROUP_Tickables);
+}
+
+// === TICK ===
+void UDepositExtractionManager::Tick(float DeltaTime)
+{
+    LastChangedDepositCount = 0;
+    SimulationTime += DeltaTime;
+
+    const int32 NumDeposits = Deposits.Num();
+    if (NumDeposits == 0)
+    {
+        return;
+    }
+
+    SyncDirtySlots();
+
+    // Sloty spoza bieżącego wycinka zostają w tyle - ich zegary dogonią czas przy następnej symulacji
+    const int32 Slice = NextTimeSlice;
+    NextTimeSlice = (NextTimeSlice + 1) % TimeSliceCount;
+
+    const int32 SliceSize = FMath::DivideAndRoundUp(NumDeposits, TimeSliceCount);
+    const int32 FirstSlot = FMath::Min(Slice * SliceSize, NumDeposits);
+    const int32 EndSlot = FMath::Min(FirstSlot + SliceSize, NumDeposits);
+
+    if (FirstSlot < EndSlot)
+    {
+        SimulateRange(FirstSlot, EndSlot);
+        ApplyRange(FirstSlot, EndSlot);
+    }
+}
+
+// === REGISTRATION ===
+void UDepositExtractionManager::RegisterDeposit(AResourceDeposit* Deposit)
+{
+    if (!Deposit)
+    {
+        return;
+    }
+
+    if (const int32* ExistingSlot = SlotByDeposit.Find(Deposit))
+    {
+        SyncSlot(*ExistingSlot);
+        return;
+    }
+
+    const int32 Slot = Deposits.Add(Deposit);
+    Production.AddDefaulted();
+    LastSimulatedTimes.Add(SimulationTime);
+    ExtractionIntervals.Add(1.0f);
+    TimeSinceExtraction.Add(0.0f);
+    Reserves.Add(0);
+    FreeSpace.Add(0);
+    PendingAmounts.Add(0);
+    DirtyFlags.Add(0);
+    SlotByDeposit.Add(Deposit, Slot);
+
+    FDelegateHandle StorageHandle;
+    if (UResourceStorageComponent* Storage = Deposit->GetStorageComponent())
+    {
+        StorageHandle = Storage->OnStorageContentsChanged.AddUObject(this, &UDepositExtractionManager::HandleStorageChanged);
+    }
+    StorageHandles.Add(StorageHandle);
+
+    SyncSlot(Slot);
+}
+
+void UDepositExtractionManager::UnregisterDeposit(AResourceDeposit* Deposit)
+{
+    int32 Slot = INDEX_NONE;
+    if (!SlotByDeposit.RemoveAndCopyValue(Deposit, Slot))
+    {
+        return;
+    }
+
+    if (UResourceStorageComponent* Storage = Deposit->GetStorageComponent())
+    {
+        Storage->OnStorageContentsChanged.Remove(StorageHandles[Slot]);
+    }
+
+    // Swap-remove: ostatni slot przechodzi na miejsce usuniętego - lista brudnych slotów też
+    const int32 LastSlot = Deposits.Num() - 1;
+    if (DirtyFlags[Slot])
+    {
+        DirtySlots.RemoveSingleSwap(Slot, EAllowShrinking::No);
+    }
+    if (Slot != LastSlot && DirtyFlags[LastSlot])
+    {
+        DirtySlots[DirtySlots.Find(LastSlot)] = Slot;
+    }
+
+    if (Slot != LastSlot)
+    {
+        Deposits[Slot] = Deposits[LastSlot];
+        Production[Slot] = Production[LastSlot];
+        LastSimulatedTimes[Slot] = LastSimulatedTimes[LastSlot];
+        ExtractionIntervals[Slot] = ExtractionIntervals[LastSlot];
+        TimeSinceExtraction[Slot] = TimeSinceExtraction[LastSlot];
+        Reserves[Slot] = Reserves[LastSlot];
+        FreeSpace[Slot] = FreeSpace[LastSlot];
+        PendingAmounts[Slot] = PendingAmounts[LastSlot];
+        DirtyFlags[Slot] = DirtyFlags[LastSlot];
+        StorageHandles[Slot] = StorageHandles[LastSlot];
+        SlotByDeposit[Deposits[Slot]] = Slot;
+    }
+
+    Deposits.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+    Production.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+    LastSimulatedTimes.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+    ExtractionIntervals.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+    TimeSinceExtraction.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+    Reserves.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+    FreeSpace.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+    PendingAmounts.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+    DirtyFlags.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+    StorageHandles.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+}
+
+void UDepositExtractionManager::MarkDepositDirty(const AResourceDeposit* Deposit)
+{
+    const int32* Slot = SlotByDeposit.Find(Deposit);
+    if (Slot && !DirtyFlags[*Slot])
+    {
+        DirtyFlags[*Slot] = 1;
+        DirtySlots.Add(*Slot);
+    }
+}
+
+int32 UDepositExtractionManager::CatchUpDeposit(AResourceDeposit* Deposit)
+{
+    const int32* FoundSlot = SlotByDeposit.Find(Deposit);
+    if (!FoundSlot)
+    {
+        return 0;
+    }
+
+    const int32 Slot = *FoundSlot;
+    if (DirtyFlags[Slot])
+    {
+        SyncSlot(Slot);
+    }
+
+    AdvanceSlotClock(Slot);
+    TimeSinceExtraction[Slot] = 0.0f;
+
+    const int32 Amount = static_cast<int32>(FMath::Max<int64>(0, FMath::Min3<int64>(Production[Slot].Collect(), Reserves[Slot], FreeSpace[Slot])));
+    if (Amount <= 0)
+    {
+        return 0;
+    }
+
+    FreeSpace[Slot] -= Amount;
+    Reserves[Slot] -= (Reserves[Slot] != MAX_int32) ? Amount : 0;
+
+    bool bApplied = false;
+    {
+        TGuardValue<const UResourceStorageComponent*> WriteGuard(StorageBeingWritten, Deposit->GetStorageComponent());
+        bApplied = Deposit->ApplyBatchedExtraction(Amount);
+    }
+
+    if (!bApplied)
+    {
+        MarkDepositDirty(Deposit);
+        return 0;
+    }
+
+    return Amount;
+}
+
+// === CONFIGURATION ===
+void UDepositExtractionManager::SetTimeSliceCount(int32 NewTimeSliceCount)
+{
+    NewTimeSliceCount = FMath::Max(1, NewTimeSliceCount);
+    if (NewTimeSliceCount == TimeSliceCount)
+    {
+        return;
+    }
+
+    // Zegary slotów są niezależne od wycinków - zmiana podziału niczego nie gubi
+    TimeSliceCount = NewTimeSliceCount;
+    NextTimeSlice = 0;
+}
+
+// === PRIVATE FUNCTIONS ===
+void UDepositExtractionManager::SyncSlot(int32 Slot)
+{
+    // Czas do teraz liczony jest jeszcze starym tempem - SetRate zachowuje wyprodukowany ułamek
+    AdvanceSlotClock(Slot);
+
+    const AResourceDeposit* Deposit = Deposits[Slot];
+    const UResourceStorageComponent* Storage = IsValid(Deposit) ? Deposit->GetStorageComponent() : nullptr;
+    if (!Storage || !Deposit->IsAutoExtractionActive())
+    {
+        Production[Slot].SetRate(0.0);
+        Reserves[Slot] = 0;
+        FreeSpace[Slot] = 0;
+        return;
+    }
+
+    const FDataTableRowHandle ResourceType = Deposit->GetResourceType();
+
+    Production[Slot].SetRate(Deposit->GetCurrentExtractionRate());
+    ExtractionIntervals[Slot] = FMath::Max(Deposit->GetExtractionTickRate(), KINDA_SMALL_NUMBER);
+    Reserves[Slot] = Deposit->IsRenewable() ? MAX_int32 : Deposit->GetAvailableResource();
+    FreeSpace[Slot] = Storage->GetAvailableSpace(ResourceType);
+}
+
+void UDepositExtractionManager::SyncDirtySlots()
+{
+    // Tylko zgłoszone sloty - bez przeglądania wszystkich złóż
+    for (const int32 Slot : DirtySlots)
+    {
+        DirtyFlags[Slot] = 0;
+        SyncSlot(Slot);
+    }
+
+    DirtySlots.Reset();
+}
+
+void UDepositExtractionManager::AdvanceSlotClock(int32 Slot)
+{
+    const double DeltaTime = SimulationTime - LastSimulatedTimes[Slot];
+    LastSimulatedTimes[Slot] = SimulationTime;
+
+    Production[Slot].AddTime(DeltaTime);
+    TimeSinceExtraction[Slot] += static_cast<float>(DeltaTime);
+}
+
+void UDepositExtractionManager::SimulateRange(int32 FirstSlot, int32 EndSlot)
+{
+    FExtractionAccumulator* RESTRICT Accumulators = Production.GetData();
+    double* RESTRICT LastTimes = LastSimulatedTimes.GetData();
+    const float* RESTRICT Intervals = ExtractionIntervals.GetData();
+    float* RESTRICT SinceExtraction = TimeSinceExtraction.GetData();
+    int32* RESTRICT Reserve = Reserves.GetData();
+    int32* RESTRICT Space = FreeSpace.GetData();
+    int32* RESTRICT Pending = PendingAmounts.GetData();
+    const double Now = SimulationTime;
+
+    // Bez dostępu do aktorów - tylko liczby. Ułamki zostają w akumulatorach, więc
+    // dłuższy ExtractionTickRate zmienia tylko częstotliwość eventów, nie sumę wydobycia.
+    for (int32 Slot = FirstSlot; Slot < EndSlot; ++Slot)
+    {
+        const double DeltaTime = Now - LastTimes[Slot];
+        LastTimes[Slot] = Now;
+
+        Accumulators[Slot].AddTime(DeltaTime);
+        const float Time = SinceExtraction[Slot] + static_cast<float>(DeltaTime);
+        const bool bDue = Time >= Intervals[Slot];
+
+        const int64 Produced = bDue ? Accumulators[Slot].Collect() : 0;
+        const int32 Amount = static_cast<int32>(FMath::Max<int64>(0, FMath::Min3<int64>(Produced, Reserve[Slot], Space[Slot])));
+
+        Pending[Slot] = Amount;
+        Space[Slot] -= Amount;
+        Reserve[Slot] -= (Reserve[Slot] != MAX_int32) ? Amount : 0;
+        SinceExtraction[Slot] = bDue ? 0.0f : Time;
+    }
+}
+
+void UDepositExtractionManager::ApplyRange(int32 FirstSlot, int32 EndSlot)
+{
+    // Najpierw zbieramy zmiany - handlery eventów mogą zniszczyć złoże i przesunąć sloty (swap-remove)
+    TArray<TPair<AResourceDeposit*, int32>, TInlineAllocator<64>> Changes;
+    for (int32 Slot = FirstSlot; Slot < EndSlot; ++Slot)
+    {
+        if (PendingAmounts[Slot] > 0)
+        {
+            Changes.Emplace(Deposits[Slot], PendingAmounts[Slot]);
+            PendingAmounts[Slot] = 0;
+        }
+    }
+
+    LastChangedDepositCount = Changes.Num();
+
+    // Eventy tylko dla złóż, których stan faktycznie się zmienił
+    for (const TPair<AResourceDeposit*, int32>& Change : Changes)
+    {
+        AResourceDeposit* Deposit = Change.Key;
+        if (!IsValid(Deposit))
+        {
+            continue;
+        }
+
+        bool bApplied = false;
+        {
+            // Lustro już uwzględnia ten zapis - własne powiadomienie magazynu go nie brudzi
+            TGuardValue<const UResourceStorageComponent*> WriteGuard(StorageBeingWritten, Deposit->GetStorageComponent());
+            bApplied = Deposit->ApplyBatchedExtraction(Change.Value);
+        }
+
+        if (!bApplied)
+        {
+            MarkDepositDirty(Deposit);
+        }
+    }
+}
+
+void UDepositExtractionManager::HandleStorageChanged(UResourceStorageComponent* Storage, const FDataTableRowHandle& ResourceType)
+{
+    // Nasze własne AddResource jest już w lustrze; pozostałe zmiany odświeżają je w następnym Tick
+    if (Storage == StorageBeingWritten)
+    {
+        return;
+    }
+
+    if (const AResourceDeposit* Deposit = Cast<AResourceDeposit>(Storage ? Storage->GetOwner() : nullptr))
+    {
+        MarkDepositDirty(Deposit);
+    }
+}
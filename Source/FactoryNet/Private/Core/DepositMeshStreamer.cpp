@@ -0,0 +1,154 @@
+// DepositMeshStreamer.cpp
+// Lokalizacja: Source/FactoryNet/Private/Core/DepositMeshStreamer.cpp
+
+#include "Core/DepositMeshStreamer.h"
+#include "Data/DepositDefinition.h"
+#include "Engine/StaticMesh.h"
+
+UDepositMeshStreamer::UDepositMeshStreamer()
+{
+    PlaceholderMesh = TSoftObjectPtr<UStaticMesh>(FSoftObjectPath(TEXT("/Engine/BasicShapes/Cube.Cube")));
+    LoadedPlaceholderMesh = nullptr;
+}
+
+void UDepositMeshStreamer::Deinitialize()
+{
+    for (TPair<const UDepositDefinition*, FDefinitionMeshRequest>& Pair : Requests)
+    {
+        if (Pair.Value.Handle.IsValid() && Pair.Value.Handle->IsLoadingInProgress())
+        {
+            Pair.Value.Handle->CancelHandle();
+        }
+    }
+
+    Requests.Empty();
+    LoadedPlaceholderMesh = nullptr;
+
+    Super::Deinitialize();
+}
+
+void UDepositMeshStreamer::RequestDefinitionMeshes(const UDepositDefinition* DepositDefinition, FSimpleDelegate OnLoaded)
+{
+    if (!DepositDefinition)
+    {
+        return;
+    }
+
+    if (AreDefinitionMeshesLoaded(DepositDefinition))
+    {
+        OnLoaded.ExecuteIfBound();
+        return;
+    }
+
+    // Pierwsze żądanie startuje ładowanie, kolejne tylko czekają na ten sam handle
+    PrefetchDefinitions(MakeArrayView(&DepositDefinition, 1));
+
+    if (FDefinitionMeshRequest* Request = Requests.Find(DepositDefinition))
+    {
+        if (Request->bLoaded)
+        {
+            OnLoaded.ExecuteIfBound();
+        }
+        else
+        {
+            Request->Waiters.Add(MoveTemp(OnLoaded));
+        }
+    }
+}
+
+void UDepositMeshStreamer::PrefetchDefinitions(TArrayView<const UDepositDefinition* const> DepositDefinitions)
+{
+    TArray<FSoftObjectPath> MeshPaths;
+    TArray<const UDepositDefinition*> NewDefinitions;
+
+    for (const UDepositDefinition* DepositDefinition : DepositDefinitions)
+    {
+        if (!DepositDefinition || Requests.Contains(DepositDefinition))
+        {
+            continue;
+        }
+
+        NewDefinitions.Add(DepositDefinition);
+        Requests.Add(DepositDefinition);
+        GatherMeshPaths(DepositDefinition, MeshPaths);
+    }
+
+    if (NewDefinitions.Num() == 0)
+    {
+        return;
+    }
+
+    if (MeshPaths.Num() == 0)
+    {
+        // Nic do ładowania (albo wszystko już w pamięci)
+        HandleMeshesLoaded(MoveTemp(NewDefinitions));
+        return;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("DepositMeshStreamer: Streaming %d meshes for %d deposit definitions"), MeshPaths.Num(), NewDefinitions.Num());
+
+    const TSharedPtr<FStreamableHandle> Handle = StreamableManager.RequestAsyncLoad(MeshPaths,
+        FStreamableDelegate::CreateUObject(this, &UDepositMeshStreamer::HandleMeshesLoaded, NewDefinitions));
+
+    // Handle może być już zakończony (callback poszedł synchronicznie) - wtedy tylko trzymamy referencje
+    for (const UDepositDefinition* DepositDefinition : NewDefinitions)
+    {
+        if (FDefinitionMeshRequest* Request = Requests.Find(DepositDefinition))
+        {
+            Request->Handle = Handle;
+        }
+    }
+}
+
+bool UDepositMeshStreamer::AreDefinitionMeshesLoaded(const UDepositDefinition* DepositDefinition) const
+{
+    const FDefinitionMeshRequest* Request = Requests.Find(DepositDefinition);
+    return Request && Request->bLoaded;
+}
+
+UStaticMesh* UDepositMeshStreamer::GetPlaceholderMesh()
+{
+    // Jedno synchroniczne ładowanie na świat - placeholder to mały asset z engine content
+    if (!LoadedPlaceholderMesh && !PlaceholderMesh.IsNull())
+    {
+        LoadedPlaceholderMesh = PlaceholderMesh.LoadSynchronous();
+    }
+    return LoadedPlaceholderMesh;
+}
+
+void UDepositMeshStreamer::GatherMeshPaths(const UDepositDefinition* DepositDefinition, TArray<FSoftObjectPath>& OutPaths)
+{
+    const auto AddPath = [&OutPaths](const TSoftObjectPtr<UStaticMesh>& Mesh)
+    {
+        if (!Mesh.IsNull() && !Mesh.Get())
+        {
+            OutPaths.AddUnique(Mesh.ToSoftObjectPath());
+        }
+    };
+
+    AddPath(DepositDefinition->BaseMesh);
+    for (const FDepositLevel& LevelData : DepositDefinition->DepositLevels)
+    {
+        AddPath(LevelData.LevelMesh);
+    }
+}
+
+void UDepositMeshStreamer::HandleMeshesLoaded(TArray<const UDepositDefinition*> LoadedDefinitions)
+{
+    TArray<FSimpleDelegate> Waiters;
+    for (const UDepositDefinition* DepositDefinition : LoadedDefinitions)
+    {
+        if (FDefinitionMeshRequest* Request = Requests.Find(DepositDefinition))
+        {
+            Request->bLoaded = true;
+            Waiters.Append(MoveTemp(Request->Waiters));
+            Request->Waiters.Reset();
+        }
+    }
+
+    // Callbacki po oznaczeniu wszystkich definicji - mogą od razu wysłać kolejne żądania
+    for (FSimpleDelegate& Waiter : Waiters)
+    {
+        Waiter.ExecuteIfBound();
+    }
+}
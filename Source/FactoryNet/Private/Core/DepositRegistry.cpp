@@ -0,0 +1,211 @@
+// DepositRegistry.cpp
+// Lokalizacja: Source/FactoryNet/Private/Core/DepositRegistry.cpp
+
+#include "Core/DepositRegistry.h"
+#include "Buildings/Base/ResourceDeposit.h"
+#include "Data/DepositDefinition.h"
+
+UDepositRegistry::UDepositRegistry()
+    : AllDepositsIndex(DefaultCellSize)
+{
+}
+
+void UDepositRegistry::Deinitialize()
+{
+    Deposits.Empty();
+    DepositTypes.Empty();
+    PositionsX.Empty();
+    PositionsY.Empty();
+    PositionsZ.Empty();
+    SlotByDeposit.Empty();
+    AllDepositsIndex.Reset();
+    DepositsByTypeIndex.Empty();
+    CellSizeByType.Empty();
+
+    Super::Deinitialize();
+}
+
+// === REGISTRATION ===
+void UDepositRegistry::RegisterDeposit(AResourceDeposit* Deposit)
+{
+    if (!Deposit)
+    {
+        return;
+    }
+
+    const FVector Location = Deposit->GetActorLocation();
+    const UDepositDefinition* DepositType = Deposit->GetDepositDefinition();
+
+    if (const int32* ExistingSlot = SlotByDeposit.Find(Deposit))
+    {
+        // Re-sync: typ lub pozycja mogły się zmienić od BeginPlay (InitializeWithDefinition)
+        const int32 Slot = *ExistingSlot;
+        if (DepositTypes[Slot] == DepositType && GetSlotLocation(Slot).Equals(Location, 1.0f))
+        {
+            return;
+        }
+
+        RemoveFromIndexes(Slot);
+        DepositTypes[Slot] = DepositType;
+        PositionsX[Slot] = Location.X;
+        PositionsY[Slot] = Location.Y;
+        PositionsZ[Slot] = Location.Z;
+        AddToIndexes(Slot);
+        return;
+    }
+
+    const int32 Slot = Deposits.Add(Deposit);
+    DepositTypes.Add(DepositType);
+    PositionsX.Add(Location.X);
+    PositionsY.Add(Location.Y);
+    PositionsZ.Add(Location.Z);
+    SlotByDeposit.Add(Deposit, Slot);
+
+    AddToIndexes(Slot);
+}
+
+void UDepositRegistry::UnregisterDeposit(AResourceDeposit* Deposit)
+{
+    int32 Slot = INDEX_NONE;
+    if (!SlotByDeposit.RemoveAndCopyValue(Deposit, Slot))
+    {
+        return;
+    }
+
+    RemoveFromIndexes(Slot);
+
+    // Swap-remove: ostatni slot przechodzi na miejsce usuniętego
+    const int32 LastSlot = Deposits.Num() - 1;
+    if (Slot != LastSlot)
+    {
+        RemoveFromIndexes(LastSlot);
+
+        Deposits[Slot] = Deposits[LastSlot];
+        DepositTypes[Slot] = DepositTypes[LastSlot];
+        PositionsX[Slot] = PositionsX[LastSlot];
+        PositionsY[Slot] = PositionsY[LastSlot];
+        PositionsZ[Slot] = PositionsZ[LastSlot];
+        SlotByDeposit[Deposits[Slot]] = Slot;
+
+        AddToIndexes(Slot);
+    }
+
+    Deposits.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+    DepositTypes.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+    PositionsX.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+    PositionsY.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+    PositionsZ.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+}
+
+bool UDepositRegistry::IsDepositRegistered(const AResourceDeposit* Deposit) const
+{
+    return SlotByDeposit.Contains(Deposit);
+}
+
+void UDepositRegistry::SetDepositTypeCellSize(const UDepositDefinition* DepositType, float CellSize)
+{
+    if (!DepositType || CellSize <= 0.0f)
+    {
+        return;
+    }
+
+    CellSizeByType.Add(DepositType, CellSize);
+
+    if (FDepositSpatialHash* TypeIndex = DepositsByTypeIndex.Find(DepositType))
+    {
+        TypeIndex->SetCellSize(CellSize);
+    }
+}
+
+// === QUERIES ===
+bool UDepositRegistry::IsAnyDepositWithinRadius(const FVector& Location, float Radius, const AResourceDeposit* IgnoredDeposit) const
+{
+    const int32* IgnoredSlot = IgnoredDeposit ? SlotByDeposit.Find(IgnoredDeposit) : nullptr;
+    if (!IgnoredSlot)
+    {
+        return AllDepositsIndex.AnyWithinRadius(Location, Radius);
+    }
+
+    const int32 SkipSlot = *IgnoredSlot;
+    return AllDepositsIndex.AnyWithinRadius(Location, Radius, [SkipSlot](int32 Slot) { return Slot != SkipSlot; });
+}
+
+bool UDepositRegistry::IsAnyDepositOfTypeWithinRadius(const FVector& Location, float Radius, const UDepositDefinition* DepositType) const
+{
+    const FDepositSpatialHash* TypeIndex = DepositsByTypeIndex.Find(DepositType);
+    return TypeIndex && TypeIndex->AnyWithinRadius(Location, Radius);
+}
+
+AResourceDeposit* UDepositRegistry::FindNearestDeposit(const FVector& Location, const UDepositDefinition* DepositType) const
+{
+    const FDepositSpatialHash* Index = DepositType ? DepositsByTypeIndex.Find(DepositType) : &AllDepositsIndex;
+    if (!Index)
+    {
+        return nullptr;
+    }
+
+    const int32 NearestSlot = Index->FindNearest(Location);
+    return NearestSlot != INDEX_NONE ? Deposits[NearestSlot] : nullptr;
+}
+
+TArray<AResourceDeposit*> UDepositRegistry::GetDepositsInRadius(const FVector& Location, float Radius, const UDepositDefinition* DepositType) const
+{
+    TArray<AResourceDeposit*> Result;
+
+    const FDepositSpatialHash* Index = DepositType ? DepositsByTypeIndex.Find(DepositType) : &AllDepositsIndex;
+    if (!Index)
+    {
+        return Result;
+    }
+
+    TArray<int32> Slots;
+    Index->QueryRadius(Location, Radius, Slots);
+
+    Result.Reserve(Slots.Num());
+    for (const int32 Slot : Slots)
+    {
+        Result.Add(Deposits[Slot]);
+    }
+
+    return Result;
+}
+
+// === PRIVATE FUNCTIONS ===
+FVector UDepositRegistry::GetSlotLocation(int32 Slot) const
+{
+    return FVector(PositionsX[Slot], PositionsY[Slot], PositionsZ[Slot]);
+}
+
+FDepositSpatialHash& UDepositRegistry::GetOrCreateTypeIndex(const UDepositDefinition* DepositType)
+{
+    if (FDepositSpatialHash* ExistingIndex = DepositsByTypeIndex.Find(DepositType))
+    {
+        return *ExistingIndex;
+    }
+
+    const float* CellSize = CellSizeByType.Find(DepositType);
+    return DepositsByTypeIndex.Add(DepositType, FDepositSpatialHash(CellSize ? *CellSize : DefaultCellSize));
+}
+
+void UDepositRegistry::RemoveFromIndexes(int32 Slot)
+{
+    const FVector Location = GetSlotLocation(Slot);
+    AllDepositsIndex.Remove(Slot, Location);
+
+    if (FDepositSpatialHash* TypeIndex = DepositsByTypeIndex.Find(DepositTypes[Slot]))
+    {
+        TypeIndex->Remove(Slot, Location);
+    }
+}
+
+void UDepositRegistry::AddToIndexes(int32 Slot)
+{
+    const FVector Location = GetSlotLocation(Slot);
+    AllDepositsIndex.Add(Slot, Location);
+
+    // Złoża bez definicji (przed InitializeWithDefinition) są tylko w indeksie globalnym
+    if (DepositTypes[Slot])
+    {
+        GetOrCreateTypeIndex(DepositTypes[Slot]).Add(Slot, Location);
+    }
+}
@@ -0,0 +1,495 @@
+// DepositSimulationManager.cpp
+// Lokalizacja: Source/FactoryNet/Private/Core/DepositSimulationManager.cpp
+
+#include "Core/DepositSimulationManager.h"
+#include "Core/DepositMeshStreamer.h"
+#include "Buildings/Base/ResourceDeposit.h"
+#include "Data/DepositDefinition.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Components/SceneComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+
+UDepositSimulationManager::UDepositSimulationManager()
+    : AllDepositsIndex(DefaultCellSize)
+{
+    ProxyActor = nullptr;
+}
+
+void UDepositSimulationManager::Deinitialize()
+{
+    ClearAllDeposits();
+
+    BatchComponents.Empty();
+    BatchDepositIds.Empty();
+    BatchByKey.Empty();
+    CellSizeByType.Empty();
+    ProxyActor = nullptr;
+
+    Super::Deinitialize();
+}
+
+// === RECORDS ===
+int32 UDepositSimulationManager::AddDeposit(UDepositDefinition* DepositDefinition, const FVector& Location, int32 Level)
+{
+    if (!DepositDefinition)
+    {
+        UE_LOG(LogTemp, Error, TEXT("DepositSimulationManager: DepositDefinition is null"));
+        return INDEX_NONE;
+    }
+
+    FDepositSimulationRecord Record;
+    Record.DepositDefinition = DepositDefinition;
+    Record.Location = Location;
+    Record.Level = FMath::Clamp(Level, 1, FMath::Max(DepositDefinition->MaxLevel, 1));
+    Record.LastUpdateTime = GetSimulationTime();
+    ResetExtractionState(Record);
+
+    // Ten sam stan startowy co AResourceDeposit::InitializeWithDefinition
+    Record.Reserves = DepositDefinition->TotalReserves;
+    Record.StoredAmount = DepositDefinition->IsRenewable ? FMath::RoundToInt(Record.MaxStorage * 0.1f) : 0;
+
+    const int32 DepositId = Records.Add(Record);
+    ReferencedDefinitions.Add(DepositDefinition);
+
+    AllDepositsIndex.Add(DepositId, Location);
+    FDepositSpatialHash* TypeIndex = DepositsByTypeIndex.Find(DepositDefinition);
+    if (!TypeIndex)
+    {
+        const float* CellSize = CellSizeByType.Find(DepositDefinition);
+        TypeIndex = &DepositsByTypeIndex.Add(DepositDefinition, FDepositSpatialHash(CellSize ? *CellSize : DefaultCellSize));
+    }
+    TypeIndex->Add(DepositId, Location);
+
+    AddInstance(DepositId);
+    return DepositId;
+}
+
+bool UDepositSimulationManager::RemoveDeposit(int32 DepositId)
+{
+    if (!Records.IsValidIndex(DepositId))
+    {
+        return false;
+    }
+
+    FDepositSimulationRecord& Record = Records[DepositId];
+    if (AResourceDeposit* PromotedActor = Record.PromotedActor.Get())
+    {
+        PromotedActor->OnDestroyed.RemoveDynamic(this, &UDepositSimulationManager::HandlePromotedDepositDestroyed);
+        DepositIdByActor.Remove(PromotedActor);
+        PromotedActor->Destroy();
+    }
+
+    RemoveInstance(DepositId);
+
+    AllDepositsIndex.Remove(DepositId, Record.Location);
+    if (FDepositSpatialHash* TypeIndex = DepositsByTypeIndex.Find(Record.DepositDefinition))
+    {
+        TypeIndex->Remove(DepositId, Record.Location);
+    }
+
+    Records.RemoveAt(DepositId);
+    return true;
+}
+
+void UDepositSimulationManager::ClearAllDeposits()
+{
+    UE_LOG(LogTemp, Log, TEXT("DepositSimulationManager: Clearing %d simulated deposits (%d promoted)"),
+        Records.Num(), DepositIdByActor.Num());
+
+    for (const TPair<const AResourceDeposit*, int32>& Pair : DepositIdByActor)
+    {
+        if (AResourceDeposit* PromotedActor = Records[Pair.Value].PromotedActor.Get())
+        {
+            PromotedActor->OnDestroyed.RemoveDynamic(this, &UDepositSimulationManager::HandlePromotedDepositDestroyed);
+            PromotedActor->Destroy();
+        }
+    }
+
+    // Komponenty zostają - kolejna generacja użyje tych samych batchy
+    for (int32 BatchIndex = 0; BatchIndex < BatchComponents.Num(); ++BatchIndex)
+    {
+        if (BatchComponents[BatchIndex])
+        {
+            BatchComponents[BatchIndex]->ClearInstances();
+        }
+        BatchDepositIds[BatchIndex].Reset();
+    }
+
+    Records.Empty();
+    DepositIdByActor.Empty();
+    ReferencedDefinitions.Empty();
+    AllDepositsIndex.Reset();
+    DepositsByTypeIndex.Empty();
+}
+
+const FDepositSimulationRecord* UDepositSimulationManager::GetDepositRecord(int32 DepositId)
+{
+    if (!Records.IsValidIndex(DepositId))
+    {
+        return nullptr;
+    }
+
+    FDepositSimulationRecord& Record = Records[DepositId];
+    if (!Record.PromotedActor.IsValid())
+    {
+        SyncRecord(Record, GetSimulationTime());
+    }
+    return &Record;
+}
+
+void UDepositSimulationManager::SetDepositTypeCellSize(const UDepositDefinition* DepositType, float CellSize)
+{
+    if (!DepositType)
+    {
+        return;
+    }
+
+    CellSize = FMath::Max(CellSize, 1.0f);
+    CellSizeByType.Add(DepositType, CellSize);
+
+    if (FDepositSpatialHash* TypeIndex = DepositsByTypeIndex.Find(DepositType))
+    {
+        TypeIndex->SetCellSize(CellSize);
+    }
+}
+
+// === PROMOTION ===
+AResourceDeposit* UDepositSimulationManager::PromoteDeposit(int32 DepositId)
+{
+    if (!Records.IsValidIndex(DepositId))
+    {
+        return nullptr;
+    }
+
+    FDepositSimulationRecord& Record = Records[DepositId];
+    if (AResourceDeposit* PromotedActor = Record.PromotedActor.Get())
+    {
+        return PromotedActor;
+    }
+
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        UE_LOG(LogTemp, Error, TEXT("DepositSimulationManager: World is null"));
+        return nullptr;
+    }
+
+    SyncRecord(Record, GetSimulationTime());
+
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+    AResourceDeposit* Deposit = World->SpawnActor<AResourceDeposit>(
+        AResourceDeposit::StaticClass(), Record.Location, FRotator::ZeroRotator, SpawnParams);
+    if (!Deposit)
+    {
+        UE_LOG(LogTemp, Error, TEXT("DepositSimulationManager: Failed to promote deposit %d at %s"), DepositId, *Record.Location.ToString());
+        return nullptr;
+    }
+
+    Deposit->InitializeWithDefinition(Record.DepositDefinition);
+    Deposit->RestoreSimulationState(Record.Level, Record.Reserves, Record.StoredAmount);
+    Deposit->OnDestroyed.AddDynamic(this, &UDepositSimulationManager::HandlePromotedDepositDestroyed);
+
+    RemoveInstance(DepositId);
+    Record.PromotedActor = Deposit;
+    DepositIdByActor.Add(Deposit, DepositId);
+
+    UE_LOG(LogTemp, Log, TEXT("DepositSimulationManager: Promoted deposit %d (%s, level %d, reserves %d, stored %d)"),
+        DepositId, *Record.DepositDefinition->DepositName.ToString(), Record.Level, Record.Reserves, Record.StoredAmount);
+
+    OnDepositPromoted.Broadcast(DepositId, Deposit);
+    return Deposit;
+}
+
+AResourceDeposit* UDepositSimulationManager::PromoteDepositNear(const FVector& Location, float Radius)
+{
+    const int32 DepositId = FindNearestDeposit(Location, nullptr, Radius);
+    return DepositId != INDEX_NONE ? PromoteDeposit(DepositId) : nullptr;
+}
+
+bool UDepositSimulationManager::DemoteDeposit(AResourceDeposit* Deposit)
+{
+    const int32* DepositIdPtr = DepositIdByActor.Find(Deposit);
+    if (!DepositIdPtr)
+    {
+        return false;
+    }
+
+    const int32 DepositId = *DepositIdPtr;
+    FDepositSimulationRecord& Record = Records[DepositId];
+
+    // Batched / Lazy liczą wydobycie do teraz, zanim odczytamy stan
+    Deposit->CatchUpExtraction();
+
+    Record.Level = Deposit->GetCurrentLevel();
+    Record.Reserves = Deposit->GetRemainingReserves();
+    Record.StoredAmount = Deposit->GetCurrentStoredAmount();
+    Record.MaxStorage = Deposit->GetMaxStorage();
+    Record.ExtractionRate = Deposit->IsAutoExtractionActive() ? Deposit->GetCurrentExtractionRate() : 0.0f;
+    Record.ExtractionRemainder = 0.0;
+    Record.LastUpdateTime = GetSimulationTime();
+    Record.PromotedActor.Reset();
+
+    DepositIdByActor.Remove(Deposit);
+    Deposit->OnDestroyed.RemoveDynamic(this, &UDepositSimulationManager::HandlePromotedDepositDestroyed);
+    Deposit->Destroy();
+
+    AddInstance(DepositId);
+
+    UE_LOG(LogTemp, Log, TEXT("DepositSimulationManager: Demoted deposit %d (level %d, reserves %d, stored %d)"),
+        DepositId, Record.Level, Record.Reserves, Record.StoredAmount);
+
+    OnDepositDemoted.Broadcast(DepositId);
+    return true;
+}
+
+int32 UDepositSimulationManager::FindDepositForInstance(const UPrimitiveComponent* Component, int32 InstanceIndex) const
+{
+    if (!Component)
+    {
+        return INDEX_NONE;
+    }
+
+    for (int32 BatchIndex = 0; BatchIndex < BatchComponents.Num(); ++BatchIndex)
+    {
+        if (BatchComponents[BatchIndex] == Component)
+        {
+            return BatchDepositIds[BatchIndex].IsValidIndex(InstanceIndex) ? BatchDepositIds[BatchIndex][InstanceIndex] : INDEX_NONE;
+        }
+    }
+    return INDEX_NONE;
+}
+
+int32 UDepositSimulationManager::FindDepositForActor(const AResourceDeposit* Deposit) const
+{
+    const int32* DepositId = DepositIdByActor.Find(Deposit);
+    return DepositId ? *DepositId : INDEX_NONE;
+}
+
+// === QUERIES ===
+bool UDepositSimulationManager::IsAnyDepositOfTypeWithinRadius(const FVector& Location, float Radius, const UDepositDefinition* DepositType) const
+{
+    const FDepositSpatialHash* TypeIndex = DepositsByTypeIndex.Find(DepositType);
+    return TypeIndex && TypeIndex->AnyWithinRadius(Location, Radius);
+}
+
+int32 UDepositSimulationManager::FindNearestDeposit(const FVector& Location, const UDepositDefinition* DepositType, float MaxRadius) const
+{
+    const FDepositSpatialHash* Index = DepositType ? DepositsByTypeIndex.Find(DepositType) : &AllDepositsIndex;
+    return Index ? Index->FindNearest(Location, MaxRadius) : INDEX_NONE;
+}
+
+// === PRIVATE FUNCTIONS ===
+void UDepositSimulationManager::SyncRecord(FDepositSimulationRecord& Record, double Now) const
+{
+    if (Now <= Record.LastUpdateTime)
+    {
+        return;
+    }
+
+    if (Record.ExtractionRate > 0.0f)
+    {
+        // Tempo x czas, obcięte do rezerw i miejsca w magazynie - nadwyżka przepada jak w ticku aktora
+        const double Accumulated = Record.ExtractionRemainder + Record.ExtractionRate * (Now - Record.LastUpdateTime);
+        const int64 Produced = static_cast<int64>(FMath::FloorToDouble(Accumulated));
+        const int64 Limit = FMath::Min<int64>(Record.MaxStorage - Record.StoredAmount, Record.bRenewable ? MAX_int32 : Record.Reserves);
+        const int32 Amount = static_cast<int32>(FMath::Clamp<int64>(Produced, 0, FMath::Max<int64>(Limit, 0)));
+
+        Record.StoredAmount += Amount;
+        if (!Record.bRenewable)
+        {
+            Record.Reserves -= Amount;
+        }
+        Record.ExtractionRemainder = (Amount < Produced) ? 0.0 : Accumulated - Produced;
+    }
+
+    Record.LastUpdateTime = Now;
+}
+
+void UDepositSimulationManager::ResetExtractionState(FDepositSimulationRecord& Record) const
+{
+    const FDepositLevel LevelData = Record.DepositDefinition->GetLevelData(Record.Level);
+    Record.MaxStorage = LevelData.MaxStorage;
+    Record.ExtractionRate = LevelData.ExtractionRate;
+    Record.ExtractionRemainder = 0.0;
+    Record.bRenewable = Record.DepositDefinition->IsRenewable;
+}
+
+double UDepositSimulationManager::GetSimulationTime() const
+{
+    const UWorld* World = GetWorld();
+    return World ? World->GetTimeSeconds() : 0.0;
+}
+
+int32 UDepositSimulationManager::GetOrCreateBatch(UDepositDefinition* DepositDefinition, int32 Level)
+{
+    const TPair<const UDepositDefinition*, int32> BatchKey(DepositDefinition, Level);
+    if (const int32* ExistingBatch = BatchByKey.Find(BatchKey))
+    {
+        return *ExistingBatch;
+    }
+
+    UInstancedStaticMeshComponent* Component = nullptr;
+    const TSoftObjectPtr<UStaticMesh> LevelMesh = DepositDefinition->GetLevelMesh(Level);
+    UDepositMeshStreamer* MeshStreamer = GetWorld() ? GetWorld()->GetSubsystem<UDepositMeshStreamer>() : nullptr;
+    AActor* Owner = !LevelMesh.IsNull() ? GetOrCreateProxyActor() : nullptr;
+
+    if (Owner)
+    {
+        // Placeholder do czasu załadowania - instancje dodajemy od razu, mesh podmieniamy w callbacku
+        UStaticMesh* Mesh = LevelMesh.Get();
+        if (!Mesh)
+        {
+            Mesh = MeshStreamer ? MeshStreamer->GetPlaceholderMesh() : LevelMesh.LoadSynchronous();
+        }
+
+        Component = NewObject<UInstancedStaticMeshComponent>(Owner);
+        Component->SetMobility(EComponentMobility::Static);
+        Component->SetStaticMesh(Mesh);
+
+        // Te same ustawienia co sfera kolizji aktora - trace gracza trafia w instancję (Hit.Item)
+        Component->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+        Component->SetCollisionObjectType(ECollisionChannel::ECC_WorldStatic);
+        Component->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Block);
+
+        Component->SetupAttachment(Owner->GetRootComponent());
+        Component->RegisterComponent();
+        Owner->AddInstanceComponent(Component);
+    }
+    else
+    {
+        UE_LOG(LogTemp, Warning, TEXT("DepositSimulationManager: No mesh for %s level %d - deposits stay invisible until promoted"),
+            *DepositDefinition->DepositName.ToString(), Level);
+    }
+
+    const int32 BatchIndex = BatchComponents.Add(Component);
+    BatchDepositIds.AddDefaulted();
+    BatchByKey.Add(BatchKey, BatchIndex);
+
+    if (Component && MeshStreamer && !LevelMesh.Get())
+    {
+        TWeakObjectPtr<UInstancedStaticMeshComponent> WeakComponent(Component);
+        MeshStreamer->RequestDefinitionMeshes(DepositDefinition, FSimpleDelegate::CreateWeakLambda(this, [this, WeakComponent, DepositDefinition, Level, BatchIndex]()
+        {
+            // Batch mógł zniknąć (ClearAllDeposits) w trakcie ładowania
+            UInstancedStaticMeshComponent* BatchComponent = WeakComponent.Get();
+            if (!BatchComponent || !BatchComponents.IsValidIndex(BatchIndex) || BatchComponents[BatchIndex] != BatchComponent)
+            {
+                return;
+            }
+
+            UStaticMesh* LoadedMesh = DepositDefinition->GetLevelMesh(Level).Get();
+            if (!LoadedMesh)
+            {
+                LoadedMesh = DepositDefinition->BaseMesh.Get();
+            }
+            if (LoadedMesh)
+            {
+                // Static mobility - mesh można zmienić tylko na wyrejestrowanym komponencie, instancje zostają
+                BatchComponent->UnregisterComponent();
+                BatchComponent->SetStaticMesh(LoadedMesh);
+                BatchComponent->RegisterComponent();
+            }
+        }));
+    }
+
+    return BatchIndex;
+}
+
+void UDepositSimulationManager::AddInstance(int32 DepositId)
+{
+    FDepositSimulationRecord& Record = Records[DepositId];
+
+    const int32 BatchIndex = GetOrCreateBatch(Record.DepositDefinition, Record.Level);
+    UInstancedStaticMeshComponent* Component = BatchComponents[BatchIndex];
+    if (!Component)
+    {
+        return;
+    }
+
+    Record.BatchIndex = BatchIndex;
+    Record.InstanceIndex = Component->AddInstance(FTransform(Record.Location), true);
+    check(Record.InstanceIndex == BatchDepositIds[BatchIndex].Num());
+    BatchDepositIds[BatchIndex].Add(DepositId);
+}
+
+void UDepositSimulationManager::RemoveInstance(int32 DepositId)
+{
+    FDepositSimulationRecord& Record = Records[DepositId];
+    if (Record.BatchIndex == INDEX_NONE || Record.InstanceIndex == INDEX_NONE)
+    {
+        return;
+    }
+
+    UInstancedStaticMeshComponent* Component = BatchComponents[Record.BatchIndex];
+    TArray<int32>& InstanceDepositIds = BatchDepositIds[Record.BatchIndex];
+    const int32 LastIndex = InstanceDepositIds.Num() - 1;
+
+    // RemoveInstance przesuwa wszystkie dalsze instancje - przenosimy ostatnią na zwolnione miejsce
+    if (Record.InstanceIndex != LastIndex)
+    {
+        FTransform LastTransform;
+        Component->GetInstanceTransform(LastIndex, LastTransform, true);
+        Component->UpdateInstanceTransform(Record.InstanceIndex, LastTransform, true, true);
+
+        const int32 MovedDepositId = InstanceDepositIds[LastIndex];
+        InstanceDepositIds[Record.InstanceIndex] = MovedDepositId;
+        Records[MovedDepositId].InstanceIndex = Record.InstanceIndex;
+    }
+
+    Component->RemoveInstance(LastIndex);
+    InstanceDepositIds.Pop(EAllowShrinking::No);
+
+    Record.BatchIndex = INDEX_NONE;
+    Record.InstanceIndex = INDEX_NONE;
+}
+
+AActor* UDepositSimulationManager::GetOrCreateProxyActor()
+{
+    if (IsValid(ProxyActor))
+    {
+        return ProxyActor;
+    }
+
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        return nullptr;
+    }
+
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.ObjectFlags |= RF_Transient;
+    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+    ProxyActor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+    if (!ProxyActor)
+    {
+        UE_LOG(LogTemp, Error, TEXT("DepositSimulationManager: Failed to spawn instanced proxy actor"));
+        return nullptr;
+    }
+
+    USceneComponent* RootScene = NewObject<USceneComponent>(ProxyActor, TEXT("DepositProxyRoot"));
+    RootScene->SetMobility(EComponentMobility::Static);
+    ProxyActor->SetRootComponent(RootScene);
+    RootScene->RegisterComponent();
+    ProxyActor->AddInstanceComponent(RootScene);
+
+    return ProxyActor;
+}
+
+void UDepositSimulationManager::HandlePromotedDepositDestroyed(AActor* DestroyedActor)
+{
+    // Zniszczone poza DemoteDeposit (np. przez gameplay) - złoże znika z mapy razem z rekordem
+    const AResourceDeposit* Deposit = Cast<AResourceDeposit>(DestroyedActor);
+    int32 DepositId = INDEX_NONE;
+    if (!Deposit || !DepositIdByActor.RemoveAndCopyValue(Deposit, DepositId))
+    {
+        return;
+    }
+
+    Records[DepositId].PromotedActor.Reset();
+    RemoveDeposit(DepositId);
+}
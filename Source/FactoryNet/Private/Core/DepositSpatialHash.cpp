@@ -0,0 +1,389 @@
+// DepositSpatialHash.cpp
+// Lokalizacja: Source/FactoryNet/Private/Core/DepositSpatialHash.cpp
+
+#include "Core/DepositSpatialHash.h"
+
+namespace
+{
+    const auto AcceptAll = [](int32) { return true; };
+
+    // Candidate for k-nearest heap (max-heap by distance)
+    struct FDepositDistanceEntry
+    {
+        float DistanceSquared;
+        int32 ElementId;
+    };
+
+    struct FFartherFirst
+    {
+        bool operator()(const FDepositDistanceEntry& A, const FDepositDistanceEntry& B) const
+        {
+            return A.DistanceSquared > B.DistanceSquared;
+        }
+    };
+}
+
+FDepositSpatialHash::FDepositSpatialHash(float InCellSize)
+    : CellSize(FMath::Max(InCellSize, 1.0f))
+    , InvCellSize(1.0f / FMath::Max(InCellSize, 1.0f))
+    , NumElements(0)
+    , MinCell(MAX_int32, MAX_int32)
+    , MaxCell(MIN_int32, MIN_int32)
+{
+}
+
+void FDepositSpatialHash::SetCellSize(float NewCellSize)
+{
+    NewCellSize = FMath::Max(NewCellSize, 1.0f);
+    if (FMath::IsNearlyEqual(NewCellSize, CellSize))
+    {
+        return;
+    }
+
+    TArray<FEntry> AllEntries;
+    AllEntries.Reserve(NumElements);
+    for (const TPair<FIntPoint, TArray<FEntry>>& CellPair : Cells)
+    {
+        AllEntries.Append(CellPair.Value);
+    }
+
+    Reset();
+    CellSize = NewCellSize;
+    InvCellSize = 1.0f / NewCellSize;
+
+    for (const FEntry& Entry : AllEntries)
+    {
+        Add(Entry.ElementId, Entry.Location);
+    }
+}
+
+void FDepositSpatialHash::Add(int32 ElementId, const FVector& Location)
+{
+    const FIntPoint Cell = GetCellCoord(Location);
+    Cells.FindOrAdd(Cell).Add({ Location, ElementId });
+    ++NumElements;
+
+    MinCell.X = FMath::Min(MinCell.X, Cell.X);
+    MinCell.Y = FMath::Min(MinCell.Y, Cell.Y);
+    MaxCell.X = FMath::Max(MaxCell.X, Cell.X);
+    MaxCell.Y = FMath::Max(MaxCell.Y, Cell.Y);
+}
+
+bool FDepositSpatialHash::Remove(int32 ElementId, const FVector& Location)
+{
+    const FIntPoint Cell = GetCellCoord(Location);
+    TArray<FEntry>* Entries = Cells.Find(Cell);
+    if (!Entries)
+    {
+        return false;
+    }
+
+    const int32 EntryIndex = Entries->IndexOfByPredicate([ElementId](const FEntry& Entry) { return Entry.ElementId == ElementId; });
+    if (EntryIndex == INDEX_NONE)
+    {
+        return false;
+    }
+
+    Entries->RemoveAtSwap(EntryIndex, 1, EAllowShrinking::No);
+    if (Entries->Num() == 0)
+    {
+        Cells.Remove(Cell);
+    }
+
+    --NumElements;
+    return true;
+}
+
+bool FDepositSpatialHash::Update(int32 ElementId, const FVector& OldLocation, const FVector& NewLocation)
+{
+    if (!Remove(ElementId, OldLocation))
+    {
+        return false;
+    }
+
+    Add(ElementId, NewLocation);
+    return true;
+}
+
+void FDepositSpatialHash::Reset()
+{
+    Cells.Reset();
+    NumElements = 0;
+    MinCell = FIntPoint(MAX_int32, MAX_int32);
+    MaxCell = FIntPoint(MIN_int32, MIN_int32);
+}
+
+bool FDepositSpatialHash::AnyWithinRadius(const FVector& Location, float Radius) const
+{
+    return AnyWithinRadius(Location, Radius, AcceptAll);
+}
+
+bool FDepositSpatialHash::AnyWithinRadius(const FVector& Location, float Radius, TFunctionRef<bool(int32)> Filter) const
+{
+    if (NumElements == 0 || Radius <= 0.0f)
+    {
+        return false;
+    }
+
+    const float RadiusSquared = FMath::Square(Radius);
+    const FIntPoint LowCell = GetCellCoord(Location - FVector(Radius, Radius, 0.0f));
+    const FIntPoint HighCell = GetCellCoord(Location + FVector(Radius, Radius, 0.0f));
+
+    for (int32 CellX = LowCell.X; CellX <= HighCell.X; ++CellX)
+    {
+        for (int32 CellY = LowCell.Y; CellY <= HighCell.Y; ++CellY)
+        {
+            const TArray<FEntry>* Entries = Cells.Find(FIntPoint(CellX, CellY));
+            if (!Entries)
+            {
+                continue;
+            }
+
+            for (const FEntry& Entry : *Entries)
+            {
+                // Strict < to match the original linear check (Distance < MinDistance)
+                if (FVector::DistSquared(Location, Entry.Location) < RadiusSquared && Filter(Entry.ElementId))
+                {
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+void FDepositSpatialHash::QueryRadius(const FVector& Location, float Radius, TArray<int32>& OutElementIds) const
+{
+    QueryRadius(Location, Radius, OutElementIds, AcceptAll);
+}
+
+void FDepositSpatialHash::QueryRadius(const FVector& Location, float Radius, TArray<int32>& OutElementIds, TFunctionRef<bool(int32)> Filter) const
+{
+    OutElementIds.Reset();
+
+    if (NumElements == 0 || Radius <= 0.0f)
+    {
+        return;
+    }
+
+    const float RadiusSquared = FMath::Square(Radius);
+    const FIntPoint LowCell = GetCellCoord(Location - FVector(Radius, Radius, 0.0f));
+    const FIntPoint HighCell = GetCellCoord(Location + FVector(Radius, Radius, 0.0f));
+
+    for (int32 CellX = LowCell.X; CellX <= HighCell.X; ++CellX)
+    {
+        for (int32 CellY = LowCell.Y; CellY <= HighCell.Y; ++CellY)
+        {
+            const TArray<FEntry>* Entries = Cells.Find(FIntPoint(CellX, CellY));
+            if (!Entries)
+            {
+                continue;
+            }
+
+            for (const FEntry& Entry : *Entries)
+            {
+                if (FVector::DistSquared(Location, Entry.Location) <= RadiusSquared && Filter(Entry.ElementId))
+                {
+                    OutElementIds.Add(Entry.ElementId);
+                }
+            }
+        }
+    }
+}
+
+int32 FDepositSpatialHash::FindNearest(const FVector& Location, float MaxRadius, float* OutDistance) const
+{
+    return FindNearest(Location, AcceptAll, MaxRadius, OutDistance);
+}
+
+int32 FDepositSpatialHash::FindNearest(const FVector& Location, TFunctionRef<bool(int32)> Filter, float MaxRadius, float* OutDistance) const
+{
+    if (NumElements == 0)
+    {
+        return INDEX_NONE;
+    }
+
+    const FIntPoint Center = GetCellCoord(Location);
+
+    int32 MaxRing = GetMaxUsefulRing(Center);
+    if (MaxRadius < MAX_flt)
+    {
+        MaxRing = FMath::Min(MaxRing, FMath::CeilToInt(MaxRadius * InvCellSize) + 1);
+    }
+
+    float BestDistanceSquared = MaxRadius < MAX_flt ? FMath::Square(MaxRadius) : MAX_flt;
+    int32 BestElementId = INDEX_NONE;
+
+    for (int32 Ring = 0; Ring <= MaxRing; ++Ring)
+    {
+        // Any point in this ring is at least (Ring - 1) cells away from the query point
+        if (Ring > 0 && BestElementId != INDEX_NONE && FMath::Square((Ring - 1) * CellSize) >= BestDistanceSquared)
+        {
+            break;
+        }
+
+        ForEachCellInRing(Center, Ring, [&](const TArray<FEntry>& Entries)
+        {
+            for (const FEntry& Entry : Entries)
+            {
+                const float DistanceSquared = FVector::DistSquared(Location, Entry.Location);
+                if (DistanceSquared < BestDistanceSquared && Filter(Entry.ElementId))
+                {
+                    BestDistanceSquared = DistanceSquared;
+                    BestElementId = Entry.ElementId;
+                }
+            }
+        });
+    }
+
+    if (OutDistance && BestElementId != INDEX_NONE)
+    {
+        *OutDistance = FMath::Sqrt(BestDistanceSquared);
+    }
+
+    return BestElementId;
+}
+
+void FDepositSpatialHash::FindKNearest(const FVector& Location, int32 K, TArray<int32>& OutElementIds, float MaxRadius) const
+{
+    FindKNearest(Location, K, OutElementIds, AcceptAll, MaxRadius);
+}
+
+void FDepositSpatialHash::FindKNearest(const FVector& Location, int32 K, TArray<int32>& OutElementIds, TFunctionRef<bool(int32)> Filter, float MaxRadius) const
+{
+    OutElementIds.Reset();
+
+    if (NumElements == 0 || K <= 0)
+    {
+        return;
+    }
+
+    const FIntPoint Center = GetCellCoord(Location);
+
+    int32 MaxRing = GetMaxUsefulRing(Center);
+    if (MaxRadius < MAX_flt)
+    {
+        MaxRing = FMath::Min(MaxRing, FMath::CeilToInt(MaxRadius * InvCellSize) + 1);
+    }
+
+    const float MaxDistanceSquared = MaxRadius < MAX_flt ? FMath::Square(MaxRadius) : MAX_flt;
+
+    // Max-heap: HeapTop is the farthest of the current K best
+    TArray<FDepositDistanceEntry> Heap;
+    Heap.Reserve(K + 1);
+
+    for (int32 Ring = 0; Ring <= MaxRing; ++Ring)
+    {
+        if (Ring > 0 && Heap.Num() == K && FMath::Square((Ring - 1) * CellSize) >= Heap.HeapTop().DistanceSquared)
+        {
+            break;
+        }
+
+        ForEachCellInRing(Center, Ring, [&](const TArray<FEntry>& Entries)
+        {
+            for (const FEntry& Entry : Entries)
+            {
+                const float DistanceSquared = FVector::DistSquared(Location, Entry.Location);
+                if (DistanceSquared > MaxDistanceSquared)
+                {
+                    continue;
+                }
+
+                if (Heap.Num() == K && DistanceSquared >= Heap.HeapTop().DistanceSquared)
+                {
+                    continue;
+                }
+
+                if (!Filter(Entry.ElementId))
+                {
+                    continue;
+                }
+
+                Heap.HeapPush({ DistanceSquared, Entry.ElementId }, FFartherFirst());
+                if (Heap.Num() > K)
+                {
+                    Heap.HeapPopDiscard(FFartherFirst(), EAllowShrinking::No);
+                }
+            }
+        });
+    }
+
+    Heap.Sort([](const FDepositDistanceEntry& A, const FDepositDistanceEntry& B) { return A.DistanceSquared < B.DistanceSquared; });
+
+    OutElementIds.Reserve(Heap.Num());
+    for (const FDepositDistanceEntry& Entry : Heap)
+    {
+        OutElementIds.Add(Entry.ElementId);
+    }
+}
+
+FIntPoint FDepositSpatialHash::GetCellCoord(const FVector& Location) const
+{
+    return FIntPoint(
+        FMath::FloorToInt(Location.X * InvCellSize),
+        FMath::FloorToInt(Location.Y * InvCellSize));
+}
+
+int32 FDepositSpatialHash::GetMaxUsefulRing(const FIntPoint& Center) const
+{
+    if (NumElements == 0)
+    {
+        return -1;
+    }
+
+    // Chebyshev distance to the farthest corner of the occupied bounds
+    const int64 DeltaX = FMath::Max(FMath::Abs((int64)Center.X - MinCell.X), FMath::Abs((int64)MaxCell.X - Center.X));
+    const int64 DeltaY = FMath::Max(FMath::Abs((int64)Center.Y - MinCell.Y), FMath::Abs((int64)MaxCell.Y - Center.Y));
+    return (int32)FMath::Min<int64>(FMath::Max(DeltaX, DeltaY), MAX_int32 - 1);
+}
+
+void FDepositSpatialHash::ForEachCellInRing(const FIntPoint& Center, int32 Ring, TFunctionRef<void(const TArray<FEntry>&)> Visitor) const
+{
+    if (Ring == 0)
+    {
+        if (const TArray<FEntry>* Entries = Cells.Find(Center))
+        {
+            Visitor(*Entries);
+        }
+        return;
+    }
+
+    // Large, sparse rings: cheaper to walk the occupied cells than to probe 8*Ring coordinates
+    if (8 * (int64)Ring > Cells.Num())
+    {
+        for (const TPair<FIntPoint, TArray<FEntry>>& CellPair : Cells)
+        {
+            const int64 ChebyshevDistance = FMath::Max(
+                FMath::Abs((int64)CellPair.Key.X - Center.X),
+                FMath::Abs((int64)CellPair.Key.Y - Center.Y));
+
+            if (ChebyshevDistance == Ring)
+            {
+                Visitor(CellPair.Value);
+            }
+        }
+        return;
+    }
+
+    auto VisitCell = [this, &Visitor](int32 CellX, int32 CellY)
+    {
+        if (const TArray<FEntry>* Entries = Cells.Find(FIntPoint(CellX, CellY)))
+        {
+            Visitor(*Entries);
+        }
+    };
+
+    // Top and bottom rows (full width), then left and right columns (without corners)
+    for (int32 CellX = Center.X - Ring; CellX <= Center.X + Ring; ++CellX)
+    {
+        VisitCell(CellX, Center.Y - Ring);
+        VisitCell(CellX, Center.Y + Ring);
+    }
+
+    for (int32 CellY = Center.Y - Ring + 1; CellY <= Center.Y + Ring - 1; ++CellY)
+    {
+        VisitCell(Center.X - Ring, CellY);
+        VisitCell(Center.X + Ring, CellY);
+    }
+}
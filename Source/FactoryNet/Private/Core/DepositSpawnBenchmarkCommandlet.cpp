@@ -0,0 +1,399 @@
+// DepositSpawnBenchmarkCommandlet.cpp
+// Lokalizacja: Source/FactoryNet/Private/Core/DepositSpawnBenchmarkCommandlet.cpp
+
+#include "Core/DepositSpawnBenchmarkCommandlet.h"
+#include "Core/DepositSpatialHash.h"
+#include "Buildings/Base/ResourceDeposit.h"
+#include "Data/DepositDefinition.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformProperties.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace
+{
+    constexpr double BytesPerMB = 1024.0 * 1024.0;
+
+    // "50000,200000" -> liczby; puste / błędne wpisy są pomijane
+    template<typename T>
+    TArray<T> ParseNumberList(const FString& Params, const TCHAR* Key, const TArray<T>& Defaults)
+    {
+        FString ListString;
+        if (!FParse::Value(*Params, Key, ListString, false))
+        {
+            return Defaults;
+        }
+
+        TArray<FString> Entries;
+        ListString.ParseIntoArray(Entries, TEXT(","), true);
+
+        TArray<T> Values;
+        for (const FString& Entry : Entries)
+        {
+            if (Entry.IsNumeric())
+            {
+                T Value;
+                LexFromString(Value, *Entry);
+                if (Value > 0)
+                {
+                    Values.Add(Value);
+                }
+            }
+        }
+        return Values.Num() > 0 ? Values : Defaults;
+    }
+
+    const TCHAR* GetPlacementModeName(EDepositPlacementMode PlacementMode)
+    {
+        return PlacementMode == EDepositPlacementMode::PoissonDisk ? TEXT("Poisson") : TEXT("Grid");
+    }
+}
+
+UDepositSpawnBenchmarkCommandlet::UDepositSpawnBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsEditor = false;
+    IsServer = true;
+    LogToConsole = true;
+}
+
+const TArray<float>& UDepositSpawnBenchmarkCommandlet::GetDefaultScales()
+{
+    static const TArray<float> DefaultScales = { 50000.0f, 200000.0f, 500000.0f };
+    return DefaultScales;
+}
+
+const TArray<int32>& UDepositSpawnBenchmarkCommandlet::GetDefaultRuleCounts()
+{
+    static const TArray<int32> DefaultRuleCounts = { 2, 8 };
+    return DefaultRuleCounts;
+}
+
+int32 UDepositSpawnBenchmarkCommandlet::Main(const FString& Params)
+{
+    const TArray<float> Scales = ParseNumberList<float>(Params, TEXT("Scales="), GetDefaultScales());
+    const TArray<int32> RuleCounts = ParseNumberList<int32>(Params, TEXT("RuleCounts="), GetDefaultRuleCounts());
+
+    float CandidateSpacing = 500.0f;
+    FParse::Value(*Params, TEXT("CandidateSpacing="), CandidateSpacing);
+    CandidateSpacing = FMath::Max(CandidateSpacing, 50.0f);
+
+    int32 QueryCount = 10000;
+    FParse::Value(*Params, TEXT("Queries="), QueryCount);
+    QueryCount = FMath::Max(QueryCount, 1);
+
+    int32 Seed = 1337;
+    FParse::Value(*Params, TEXT("Seed="), Seed);
+
+    const bool bSpawnAsSimulationRecords = FParse::Param(*Params, TEXT("Records"));
+
+    TArray<EDepositPlacementMode> PlacementModes;
+    FString ModesString;
+    if (FParse::Value(*Params, TEXT("Modes="), ModesString, false))
+    {
+        if (ModesString.Contains(TEXT("Grid")))
+        {
+            PlacementModes.Add(EDepositPlacementMode::JitteredGrid);
+        }
+        if (ModesString.Contains(TEXT("Poisson")))
+        {
+            PlacementModes.Add(EDepositPlacementMode::PoissonDisk);
+        }
+    }
+    if (PlacementModes.Num() == 0)
+    {
+        PlacementModes = { EDepositPlacementMode::JitteredGrid, EDepositPlacementMode::PoissonDisk };
+    }
+
+    FString OutputPath;
+    if (!FParse::Value(*Params, TEXT("Output="), OutputPath))
+    {
+        OutputPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Benchmarks"),
+            FString::Printf(TEXT("DepositSpawnBenchmark_%s.csv"), *FDateTime::Now().ToString(TEXT("%Y%m%d_%H%M%S"))));
+    }
+
+    UE_LOG(LogTemp, Warning, TEXT("=== BENCHMARK: DEPOSIT SPAWN PIPELINE ==="));
+    UE_LOG(LogTemp, Warning, TEXT("Scales: %d, rule sets: %d, modes: %d, candidate spacing: %.0f, queries: %d, seed: %d, records: %s"),
+        Scales.Num(), RuleCounts.Num(), PlacementModes.Num(), CandidateSpacing, QueryCount, Seed,
+        bSpawnAsSimulationRecords ? TEXT("Yes") : TEXT("No"));
+
+    TArray<FDepositSpawnBenchmarkResult> Results;
+    int32 FailedCount = 0;
+
+    for (const EDepositPlacementMode PlacementMode : PlacementModes)
+    {
+        for (const float AreaSide : Scales)
+        {
+            for (const int32 RuleCount : RuleCounts)
+            {
+                FDepositSpawnBenchmarkResult Result;
+                if (!RunScenario(PlacementMode, AreaSide, RuleCount, CandidateSpacing, QueryCount, Seed, bSpawnAsSimulationRecords, Result))
+                {
+                    FailedCount++;
+                    continue;
+                }
+
+                UE_LOG(LogTemp, Warning, TEXT("%s"), *FormatSummary(Result));
+                if (Result.MaxCountViolations > 0 || Result.SpacingViolations > 0)
+                {
+                    UE_LOG(LogTemp, Error, TEXT("DepositSpawnBenchmark: %d rules over MaxDepositCount, %d deposits closer than MinDistanceFromOthers"),
+                        Result.MaxCountViolations, Result.SpacingViolations);
+                    FailedCount++;
+                }
+
+                Results.Add(Result);
+            }
+        }
+    }
+
+    const bool bJson = FPaths::GetExtension(OutputPath).Equals(TEXT("json"), ESearchCase::IgnoreCase);
+    if (!FFileHelper::SaveStringToFile(bJson ? FormatJson(Results) : FormatCsv(Results), *OutputPath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("DepositSpawnBenchmark: Failed to write report to %s"), *OutputPath);
+        return 1;
+    }
+
+    UE_LOG(LogTemp, Warning, TEXT("Report (%d scenarios, %d failed): %s"), Results.Num(), FailedCount, *FPaths::ConvertRelativePathToFull(OutputPath));
+    UE_LOG(LogTemp, Warning, TEXT("=========================================="));
+
+    return FailedCount > 0 ? 1 : 0;
+}
+
+bool UDepositSpawnBenchmarkCommandlet::RunScenario(EDepositPlacementMode PlacementMode, float AreaSide, int32 RuleCount, float CandidateSpacing,
+                                                   int32 QueryCount, int32 Seed, bool bSimulationRecords, FDepositSpawnBenchmarkResult& OutResult)
+{
+    if (!GEngine)
+    {
+        UE_LOG(LogTemp, Error, TEXT("DepositSpawnBenchmark: GEngine is null"));
+        return false;
+    }
+
+    // Pusty świat gry na scenariusz - rejestr i raster terenu nie przenoszą się między pomiarami
+    UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, FName(TEXT("DepositSpawnBenchmark")));
+    if (!World)
+    {
+        UE_LOG(LogTemp, Error, TEXT("DepositSpawnBenchmark: Failed to create world"));
+        return false;
+    }
+
+    FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+    WorldContext.SetCurrentWorld(World);
+
+    bool bSuccess = false;
+    TArray<UDepositDefinition*> Definitions;
+
+    if (UDepositSpawnManager* SpawnManager = World->GetSubsystem<UDepositSpawnManager>())
+    {
+        const TArray<FDepositSpawnRule> Rules = MakeSyntheticRules(RuleCount, AreaSide, Definitions);
+        const int32 GridResolution = FMath::Max(1, FMath::CeilToInt(AreaSide / CandidateSpacing));
+
+        SpawnManager->ClearSpawnRules();
+        for (const FDepositSpawnRule& Rule : Rules)
+        {
+            SpawnManager->AddSpawnRule(Rule);
+        }
+        SpawnManager->SetSpawnArea(FVector::ZeroVector, FVector(AreaSide, AreaSide, 10000.0f));
+        SpawnManager->SetPlacementMode(PlacementMode);
+        SpawnManager->SetSpawnSeed(Seed);
+        SpawnManager->SetSpawnAsSimulationRecords(bSimulationRecords);
+
+        // Limit prób = cała siatka, żeby liczba złóż zależała od reguł, a nie od MaxSpawnAttempts
+        SpawnManager->SetCandidateGrid(GridResolution, GridResolution * GridResolution);
+
+        // Log per spawn zdominowałby pomiar
+        const ELogVerbosity::Type PreviousVerbosity = LogTemp.GetVerbosity();
+        LogTemp.SetVerbosity(ELogVerbosity::Warning);
+
+        const uint64 UsedPhysicalBefore = FPlatformMemory::GetStats().UsedPhysical;
+
+        const double StartTime = FPlatformTime::Seconds();
+        SpawnManager->GenerateDepositsOnMap();
+        const double WallSeconds = FPlatformTime::Seconds() - StartTime;
+
+        const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+
+        // Zapytania na gotowej mapie: reguły terenu + dystans w rejestrze, potem najbliższe złoże typu
+        FRandomStream QueryStream(Seed);
+        TArray<FVector> Queries;
+        Queries.SetNumUninitialized(QueryCount);
+        for (FVector& Query : Queries)
+        {
+            Query = FVector(QueryStream.FRandRange(-AreaSide * 0.5f, AreaSide * 0.5f), QueryStream.FRandRange(-AreaSide * 0.5f, AreaSide * 0.5f), 0.0f);
+        }
+
+        int32 ValidCount = 0;
+        double QueryStartTime = FPlatformTime::Seconds();
+        for (int32 QueryIndex = 0; QueryIndex < Queries.Num(); ++QueryIndex)
+        {
+            if (SpawnManager->IsValidSpawnLocation(Queries[QueryIndex], Rules[QueryIndex % Rules.Num()]))
+            {
+                ValidCount++;
+            }
+        }
+        const double ValidQuerySeconds = FPlatformTime::Seconds() - QueryStartTime;
+
+        int32 FoundCount = 0;
+        QueryStartTime = FPlatformTime::Seconds();
+        for (int32 QueryIndex = 0; QueryIndex < Queries.Num(); ++QueryIndex)
+        {
+            if (SpawnManager->GetNearestDepositOfType(Queries[QueryIndex], Definitions[QueryIndex % Definitions.Num()]))
+            {
+                FoundCount++;
+            }
+        }
+        const double NearestQuerySeconds = FPlatformTime::Seconds() - QueryStartTime;
+
+        LogTemp.SetVerbosity(PreviousVerbosity);
+
+        const FDepositGenerationStats& Stats = SpawnManager->GetLastGenerationStats();
+        OutResult.PlacementMode = GetPlacementModeName(PlacementMode);
+        OutResult.AreaSide = AreaSide;
+        OutResult.RuleCount = RuleCount;
+        OutResult.GridResolution = GridResolution;
+        OutResult.bSimulationRecords = bSimulationRecords;
+        OutResult.Stats = Stats;
+        OutResult.WallSeconds = WallSeconds;
+        OutResult.CandidatesPerSecond = Stats.CandidateCount / FMath::Max(Stats.PlanSeconds, 1e-9);
+        OutResult.SpawnedPerSecond = Stats.SpawnedCount / FMath::Max(Stats.SpawnSeconds, 1e-9);
+        OutResult.QueryCount = QueryCount;
+        OutResult.ValidSpawnLocationQueryUs = ValidQuerySeconds * 1e6 / QueryCount;
+        OutResult.NearestDepositQueryUs = NearestQuerySeconds * 1e6 / QueryCount;
+        OutResult.UsedPhysicalDeltaMB = ((double)MemoryStats.UsedPhysical - (double)UsedPhysicalBefore) / BytesPerMB;
+        OutResult.ProcessPeakUsedPhysicalMB = MemoryStats.PeakUsedPhysical / BytesPerMB;
+        ValidateSpawnedDeposits(*SpawnManager, Rules, OutResult);
+
+        UE_LOG(LogTemp, Verbose, TEXT("DepositSpawnBenchmark: %d/%d queries valid, %d/%d nearest found"),
+            ValidCount, QueryCount, FoundCount, QueryCount);
+
+        bSuccess = Stats.SpawnedCount > 0;
+        if (!bSuccess)
+        {
+            UE_LOG(LogTemp, Error, TEXT("DepositSpawnBenchmark: No deposits spawned (%s, %.0f, %d rules)"),
+                GetPlacementModeName(PlacementMode), AreaSide, RuleCount);
+        }
+    }
+    else
+    {
+        UE_LOG(LogTemp, Error, TEXT("DepositSpawnBenchmark: DepositSpawnManager not available"));
+    }
+
+    // Złoża giną razem ze światem, definicje przy najbliższym GC
+    GEngine->DestroyWorldContext(World);
+    World->DestroyWorld(false);
+
+    for (UDepositDefinition* Definition : Definitions)
+    {
+        Definition->RemoveFromRoot();
+    }
+    CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+    return bSuccess;
+}
+
+TArray<FDepositSpawnRule> UDepositSpawnBenchmarkCommandlet::MakeSyntheticRules(int32 RuleCount, float AreaSide, TArray<UDepositDefinition*>& OutDefinitions)
+{
+    TArray<FDepositSpawnRule> Rules;
+    RuleCount = FMath::Max(RuleCount, 1);
+
+    for (int32 RuleIndex = 0; RuleIndex < RuleCount; ++RuleIndex)
+    {
+        UDepositDefinition* Definition = NewObject<UDepositDefinition>(GetTransientPackage(), NAME_None, RF_Transient);
+        Definition->DepositName = FText::FromString(FString::Printf(TEXT("Benchmark Deposit %d"), RuleIndex));
+        Definition->AddToRoot();
+        OutDefinitions.Add(Definition);
+
+        // Różne promienie i prawdopodobieństwa; łączna gęstość stała niezależnie od liczby reguł
+        FDepositSpawnRule& Rule = Rules.AddDefaulted_GetRef();
+        Rule.DepositDefinition = Definition;
+        Rule.MinDistanceFromOthers = 1500.0f + 500.0f * (RuleIndex % 6);
+        Rule.SpawnProbability = 0.05f + 0.25f * RuleIndex / FMath::Max(RuleCount - 1, 1);
+        Rule.MaxDepositCount = FMath::Max(1, FMath::FloorToInt(FMath::Square(AreaSide / (2.0f * Rule.MinDistanceFromOthers)) / RuleCount));
+    }
+
+    return Rules;
+}
+
+void UDepositSpawnBenchmarkCommandlet::ValidateSpawnedDeposits(const UDepositSpawnManager& SpawnManager, const TArray<FDepositSpawnRule>& Rules,
+                                                               FDepositSpawnBenchmarkResult& OutResult)
+{
+    OutResult.MaxCountViolations = 0;
+    OutResult.SpacingViolations = 0;
+
+    for (const FDepositSpawnRule& Rule : Rules)
+    {
+        const TArray<AResourceDeposit*> Deposits = SpawnManager.GetDepositsByType(Rule.DepositDefinition);
+        if (Deposits.Num() > Rule.MaxDepositCount)
+        {
+            OutResult.MaxCountViolations++;
+        }
+
+        // Hash zamiast porównań parami - przy 500k x 500k to dziesiątki tysięcy złóż na regułę
+        const float MinDistance = FMath::Max(Rule.MinDistanceFromOthers - 1.0f, 0.0f);
+        FDepositSpatialHash SpacingIndex(FMath::Max(Rule.MinDistanceFromOthers, 1.0f));
+        for (int32 DepositIndex = 0; DepositIndex < Deposits.Num(); ++DepositIndex)
+        {
+            const FVector Location = Deposits[DepositIndex]->GetActorLocation();
+            if (SpacingIndex.AnyWithinRadius(Location, MinDistance))
+            {
+                OutResult.SpacingViolations++;
+            }
+            SpacingIndex.Add(DepositIndex, Location);
+        }
+    }
+}
+
+FString UDepositSpawnBenchmarkCommandlet::FormatSummary(const FDepositSpawnBenchmarkResult& Result)
+{
+    return FString::Printf(TEXT("[%s %.0fx%.0f, %d rules] wall %.2f ms (plan %.2f / spawn %.2f) | %d candidates (%.0f/s) | %d spawned (%.0f/s)\n")
+                           TEXT("  Queries: valid location %.3f us | nearest %.3f us | memory +%.1f MB (process peak %.1f MB)"),
+        *Result.PlacementMode, Result.AreaSide, Result.AreaSide, Result.RuleCount,
+        Result.WallSeconds * 1000.0, Result.Stats.PlanSeconds * 1000.0, Result.Stats.SpawnSeconds * 1000.0,
+        Result.Stats.CandidateCount, Result.CandidatesPerSecond, Result.Stats.SpawnedCount, Result.SpawnedPerSecond,
+        Result.ValidSpawnLocationQueryUs, Result.NearestDepositQueryUs, Result.UsedPhysicalDeltaMB, Result.ProcessPeakUsedPhysicalMB);
+}
+
+FString UDepositSpawnBenchmarkCommandlet::FormatCsv(const TArray<FDepositSpawnBenchmarkResult>& Results)
+{
+    FString Csv = TEXT("Mode,Records,AreaSide,Rules,GridResolution,Seed,Candidates,Planned,Spawned,WallMs,PlanMs,SpawnMs,")
+                  TEXT("CandidatesPerSec,SpawnedPerSec,Queries,ValidSpawnLocationUs,NearestDepositUs,UsedPhysicalDeltaMB,ProcessPeakUsedPhysicalMB\n");
+
+    for (const FDepositSpawnBenchmarkResult& Result : Results)
+    {
+        Csv += FString::Printf(TEXT("%s,%d,%.0f,%d,%d,%d,%d,%d,%d,%.3f,%.3f,%.3f,%.0f,%.0f,%d,%.4f,%.4f,%.2f,%.2f\n"),
+            *Result.PlacementMode, Result.bSimulationRecords ? 1 : 0, Result.AreaSide, Result.RuleCount, Result.GridResolution, Result.Stats.GenerationSeed,
+            Result.Stats.CandidateCount, Result.Stats.PlannedCount, Result.Stats.SpawnedCount,
+            Result.WallSeconds * 1000.0, Result.Stats.PlanSeconds * 1000.0, Result.Stats.SpawnSeconds * 1000.0,
+            Result.CandidatesPerSecond, Result.SpawnedPerSecond, Result.QueryCount,
+            Result.ValidSpawnLocationQueryUs, Result.NearestDepositQueryUs, Result.UsedPhysicalDeltaMB, Result.ProcessPeakUsedPhysicalMB);
+    }
+
+    return Csv;
+}
+
+FString UDepositSpawnBenchmarkCommandlet::FormatJson(const TArray<FDepositSpawnBenchmarkResult>& Results)
+{
+    FString Json = FString::Printf(TEXT("{\n  \"Platform\": \"%s\",\n  \"Cores\": %d,\n  \"Results\": ["),
+        ANSI_TO_TCHAR(FPlatformProperties::IniPlatformName()), FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+
+    for (int32 ResultIndex = 0; ResultIndex < Results.Num(); ++ResultIndex)
+    {
+        const FDepositSpawnBenchmarkResult& Result = Results[ResultIndex];
+        Json += FString::Printf(TEXT("%s\n    { \"Mode\": \"%s\", \"Records\": %s, \"AreaSide\": %.0f, \"Rules\": %d, \"GridResolution\": %d, \"Seed\": %d, ")
+                                TEXT("\"Candidates\": %d, \"Planned\": %d, \"Spawned\": %d, \"WallMs\": %.3f, \"PlanMs\": %.3f, \"SpawnMs\": %.3f, ")
+                                TEXT("\"CandidatesPerSec\": %.0f, \"SpawnedPerSec\": %.0f, \"Queries\": %d, \"ValidSpawnLocationUs\": %.4f, ")
+                                TEXT("\"NearestDepositUs\": %.4f, \"UsedPhysicalDeltaMB\": %.2f, \"ProcessPeakUsedPhysicalMB\": %.2f }"),
+            ResultIndex > 0 ? TEXT(",") : TEXT(""),
+            *Result.PlacementMode, Result.bSimulationRecords ? TEXT("true") : TEXT("false"), Result.AreaSide, Result.RuleCount, Result.GridResolution, Result.Stats.GenerationSeed,
+            Result.Stats.CandidateCount, Result.Stats.PlannedCount, Result.Stats.SpawnedCount,
+            Result.WallSeconds * 1000.0, Result.Stats.PlanSeconds * 1000.0, Result.Stats.SpawnSeconds * 1000.0,
+            Result.CandidatesPerSecond, Result.SpawnedPerSecond, Result.QueryCount,
+            Result.ValidSpawnLocationQueryUs, Result.NearestDepositQueryUs, Result.UsedPhysicalDeltaMB, Result.ProcessPeakUsedPhysicalMB);
+    }
+
+    Json += TEXT("\n  ]\n}\n");
+    return Json;
+}
@@ -3,6 +3,11 @@
 
 #include "Core/DepositSpawnManager.h"
 #include "Core/DataTableManager.h"
+#include "Core/DepositRegistry.h"
+#include "Core/DepositSimulationManager.h"
+#include "Core/DepositMeshStreamer.h"
+#include "Core/DepositSpatialHash.h"
+#include "Core/PoissonDiskSampler.h"
 #include "Buildings/Base/ResourceDeposit.h"
 #include "Data/DepositDefinition.h"
 #include "Engine/World.h"
@@ -11,16 +16,73 @@
 #include "DrawDebugHelpers.h"
 #include "Components/StaticMeshComponent.h"
 #include "EngineUtils.h"  // ✅ DODANO: Required for TActorIterator
+#include "Async/ParallelFor.h"
+#include "Tasks/Task.h"
+
+namespace
+{
+    // Kafelek siatki kandydatów = jeden work item ParallelFor z własnym strumieniem losowym
+    constexpr int32 SpawnTileSize = 32;
+
+    // Strumień 0 = jitter kandydatów, 1 + RuleIndex = walidacja reguły, -1 = TestProbabilityGeneration
+    constexpr int32 CandidateStreamId = 0;
+
+    int32 MakeSpawnStreamSeed(int32 GenerationSeed, int32 StreamId, int32 TileIndex)
+    {
+        return static_cast<int32>(HashCombine(HashCombine(GetTypeHash(GenerationSeed), GetTypeHash(StreamId)), GetTypeHash(TileIndex)));
+    }
+}
+
+// Stan GenerateDepositsOnMapAsync: współdzielony z taskiem planowania przez TSharedPtr
+struct FDepositAsyncGeneration
+{
+    enum class EPhase : uint8
+    {
+        Clearing,
+        Planning,
+        Spawning
+    };
+
+    EPhase Phase = EPhase::Clearing;
+    bool bGenerateAfterClear = true;
+    double SpawnBudgetSeconds = 0.002;
+
+    // Wybrany w StartAsyncGeneration - GetLastGenerationSeed jest poprawny od razu po wywołaniu
+    int32 GenerationSeed = 0;
+
+    // Zapisywane tylko przez task, czytane na game thread dopiero po PlanTask.IsCompleted()
+    FDepositSpawnPlanSettings Settings;
+    TArray<FPlannedDepositSpawn> SpawnPlan;
+    UE::Tasks::FTask PlanTask;
+
+    int32 NextSpawnIndex = 0;
+    int32 SpawnedCount = 0;
+
+    // Planowanie mierzy task, spawn sumuje kolejne klatki
+    int32 CandidateCount = 0;
+    double PlanSeconds = 0.0;
+    double SpawnSeconds = 0.0;
+
+    std::atomic<bool> bCancelRequested { false };
+};
 
 UDepositSpawnManager::UDepositSpawnManager()
 {
     DataTableManager = nullptr;
+    DepositRegistry = nullptr;
+    SimulationManager = nullptr;
+    MeshStreamer = nullptr;
 }
 
 void UDepositSpawnManager::Initialize(FSubsystemCollectionBase& Collection)
 {
     Super::Initialize(Collection);
     
+    // Rejestr złóż (spatial index) musi istnieć przed pierwszym spawnem
+    DepositRegistry = Collection.InitializeDependency<UDepositRegistry>();
+    SimulationManager = Collection.InitializeDependency<UDepositSimulationManager>();
+    MeshStreamer = Collection.InitializeDependency<UDepositMeshStreamer>();
+    
     // Pobierz DataTableManager z GameInstance
     if (UWorld* World = GetWorld())
     {
@@ -46,6 +108,9 @@ void UDepositSpawnManager::Deinitialize()
 {
     ClearAllSpawnedDeposits();
     DataTableManager = nullptr;
+    DepositRegistry = nullptr;
+    SimulationManager = nullptr;
+    MeshStreamer = nullptr;
     Super::Deinitialize();
 }
 
@@ -63,109 +128,69 @@ void UDepositSpawnManager::GenerateDepositsOnMap()
     
     UE_LOG(LogTemp, Log, TEXT("DepositSpawnManager: Starting deposit generation..."));
     
-    // Clear previous deposits
+    // Clear previous deposits (also cancels a running async generation)
     ClearAllSpawnedDeposits();
     
-    // Generate spawn candidates
-    TArray<FVector> SpawnCandidates = GenerateSpawnCandidates();
+    // Planowanie bez aktorów - game thread czeka na ParallelFor, więc rejestr można czytać od razu
+    const double PlanStartTime = FPlatformTime::Seconds();
+    const FDepositSpawnPlanSettings Settings = MakePlanSettings(PickGenerationSeed(), true);
+    TArray<FPlannedDepositSpawn> SpawnPlan;
+    const int32 CandidateCount = BuildSpawnPlan(Settings, SpawnPlan);
     
-    UE_LOG(LogTemp, Log, TEXT("DepositSpawnManager: Generated %d spawn candidates"), SpawnCandidates.Num());
+    const double SpawnStartTime = FPlatformTime::Seconds();
+    int32 NextSpawnIndex = 0;
+    const int32 SpawnedCount = ExecuteSpawnPlan(SpawnPlan, NextSpawnIndex, MAX_dbl, false);
+    UE_LOG(LogTemp, Log, TEXT("DepositSpawnManager: Spawned %d/%d planned deposits"), SpawnedCount, SpawnPlan.Num());
     
-    // ✅ UPROSZCZONY ALGORYTM SPAWNU
-    for (const FDepositSpawnRule& SpawnRule : SpawnRules)
-    {
-        if (!SpawnRule.DepositDefinition)
-        {
-            continue;
-        }
-        
-        int32 SpawnedCount = 0;
-        int32 AttemptCount = 0;
-        int32 ValidLocationCount = 0;
-        
-        UE_LOG(LogTemp, Log, TEXT("DepositSpawnManager: Processing rule for %s (Probability: %.3f, Max: %d)"), 
-               *SpawnRule.DepositDefinition->DepositName.ToString(),
-               SpawnRule.SpawnProbability,
-               SpawnRule.MaxDepositCount);
-        
-        // ✅ Shuffle candidates dla lepszej randomizacji
-        TArray<FVector> ShuffledCandidates = SpawnCandidates;
-        for (int32 i = ShuffledCandidates.Num() - 1; i > 0; i--)
-        {
-            int32 RandomIndex = FMath::RandRange(0, i);
-            ShuffledCandidates.Swap(i, RandomIndex);
-        }
-        
-        for (const FVector& Candidate : ShuffledCandidates)
-        {
-            if (SpawnedCount >= SpawnRule.MaxDepositCount)
-            {
-                UE_LOG(LogTemp, VeryVerbose, TEXT("  Reached max count (%d) for %s"), 
-                       SpawnRule.MaxDepositCount, *SpawnRule.DepositDefinition->DepositName.ToString());
-                break;
-            }
-            
-            AttemptCount++;
-            if (AttemptCount > MaxSpawnAttempts)
-            {
-                UE_LOG(LogTemp, Warning, TEXT("  Max spawn attempts (%d) reached for %s"), 
-                       MaxSpawnAttempts, *SpawnRule.DepositDefinition->DepositName.ToString());
-                break;
-            }
-            
-            // ✅ UPROSZCZONE: Tylko sprawdzenie dystansu
-            bool bLocationValid = IsMinimumDistanceRespected(Candidate, SpawnRule.DepositDefinition, SpawnRule.MinDistanceFromOthers);
-            
-            if (bLocationValid)
-            {
-                ValidLocationCount++;
-                
-                // ✅ SPRAWDZENIE PROBABILITY z dodatkowym loggingiem
-                float RandomValue = FMath::RandRange(0.0f, 1.0f);
-                bool bShouldSpawn = RandomValue <= SpawnRule.SpawnProbability;
-                
-                UE_LOG(LogTemp, VeryVerbose, TEXT("  Valid location %d: Random=%.3f vs Prob=%.3f -> %s"), 
-                       ValidLocationCount, RandomValue, SpawnRule.SpawnProbability, 
-                       bShouldSpawn ? TEXT("SPAWN") : TEXT("SKIP"));
-                
-                if (bShouldSpawn)
-                {
-                    AResourceDeposit* SpawnedDeposit = SpawnDepositAtLocation(
-                        SpawnRule.DepositDefinition, Candidate, FRotator::ZeroRotator);
-                    
-                    if (SpawnedDeposit)
-                    {
-                        SpawnedCount++;
-                        
-                        UE_LOG(LogTemp, Log, TEXT("DepositSpawnManager: ✅ Spawned %s at %s (Count: %d/%d)"), 
-                            *SpawnRule.DepositDefinition->DepositName.ToString(),
-                            *Candidate.ToString(),
-                            SpawnedCount,
-                            SpawnRule.MaxDepositCount);
-                    }
-                    else
-                    {
-                        UE_LOG(LogTemp, Warning, TEXT("  ❌ Failed to spawn at %s"), *Candidate.ToString());
-                    }
-                }
-            }
-            else
-            {
-                UE_LOG(LogTemp, VeryVerbose, TEXT("  ❌ Location invalid (too close to other deposits)"));
-            }
-        }
-        
-        UE_LOG(LogTemp, Log, TEXT("DepositSpawnManager: 📊 %s Summary: %d/%d spawned from %d valid locations (%d attempts)"), 
-            *SpawnRule.DepositDefinition->DepositName.ToString(),
-            SpawnedCount, SpawnRule.MaxDepositCount, ValidLocationCount, AttemptCount);
-    }
+    LastGenerationStats = FDepositGenerationStats();
+    LastGenerationStats.GenerationSeed = Settings.GenerationSeed;
+    LastGenerationStats.CandidateCount = CandidateCount;
+    LastGenerationStats.PlannedCount = SpawnPlan.Num();
+    LastGenerationStats.SpawnedCount = SpawnedCount;
+    LastGenerationStats.PlanSeconds = SpawnStartTime - PlanStartTime;
+    LastGenerationStats.SpawnSeconds = FPlatformTime::Seconds() - SpawnStartTime;
     
     LogSpawnStatistics();
     OnAllDepositsSpawned.Broadcast(SpawnedDeposits);
 }
 
+void UDepositSpawnManager::GenerateDepositsOnMapAsync(float SpawnBudgetMs)
+{
+    UE_LOG(LogTemp, Log, TEXT("DepositSpawnManager: Starting async deposit generation (budget %.2f ms/frame)..."), SpawnBudgetMs);
+    StartAsyncGeneration(SpawnBudgetMs, true);
+}
+
+void UDepositSpawnManager::ClearAllSpawnedDepositsAsync(float SpawnBudgetMs)
+{
+    UE_LOG(LogTemp, Log, TEXT("DepositSpawnManager: Clearing %d spawned deposits asynchronously"), SpawnedDeposits.Num());
+    StartAsyncGeneration(SpawnBudgetMs, false);
+}
+
+void UDepositSpawnManager::CancelDepositGeneration()
+{
+    if (!AsyncGeneration.IsValid())
+    {
+        return;
+    }
+    
+    // Worker sprawdza flagę między regułami - czekanie jest krótkie, a potem nikt już nie używa this
+    AsyncGeneration->bCancelRequested = true;
+    AsyncGeneration->PlanTask.Wait();
+    
+    UE_LOG(LogTemp, Log, TEXT("DepositSpawnManager: Cancelled async deposit generation (%d/%d spawned)"), 
+        AsyncGeneration->SpawnedCount, AsyncGeneration->SpawnPlan.Num());
+    
+    // Nieusunięte złoża wracają pod kontrolę managera
+    SpawnedDeposits.Append(DepositsPendingDestroy);
+    DepositsPendingDestroy.Empty();
+    
+    FinishAsyncGeneration(false);
+}
+
 void UDepositSpawnManager::ClearAllSpawnedDeposits()
 {
+    CancelDepositGeneration();
+    
     UE_LOG(LogTemp, Log, TEXT("DepositSpawnManager: Clearing %d spawned deposits"), SpawnedDeposits.Num());
     
     for (const FSpawnedDepositInfo& DepositInfo : SpawnedDeposits)
@@ -177,6 +202,11 @@ void UDepositSpawnManager::ClearAllSpawnedDeposits()
     }
     
     SpawnedDeposits.Empty();
+    
+    if (SimulationManager)
+    {
+        SimulationManager->ClearAllDeposits();
+    }
 }
 
 // ✅ UPROSZCZONA FUNKCJA SpawnDepositAtLocation (usuń collision check)
@@ -216,8 +246,8 @@ AResourceDeposit* UDepositSpawnManager::SpawnDepositAtLocation(UDepositDefinitio
         SpawnInfo.SpawnedActor = SpawnedDeposit;
         SpawnInfo.DepositDefinition = DepositDef;
         SpawnInfo.SpawnLocation = Location;
-        SpawnInfo.TerrainType = ETerrainType::Plains;  // ✅ UPROSZCZENIE
-        SpawnInfo.Elevation = 0.0f;  // ✅ UPROSZCZENIE
+        SpawnInfo.TerrainType = AnalyzeTerrainType(Location);
+        SpawnInfo.Elevation = GetElevationAtLocation(Location);
         
         SpawnedDeposits.Add(SpawnInfo);
         
@@ -239,6 +269,7 @@ void UDepositSpawnManager::SetSpawnArea(const FVector& Center, const FVector& Si
 {
     SpawnAreaCenter = Center;
     SpawnAreaSize = Size;
+    bTerrainRasterDirty = true;
     
     UE_LOG(LogTemp, Log, TEXT("DepositSpawnManager: Set spawn area to Center=%s, Size=%s"), 
         *Center.ToString(), *Size.ToString());
@@ -286,23 +317,12 @@ TArray<AResourceDeposit*> UDepositSpawnManager::GetDepositsByType(UDepositDefini
 AResourceDeposit* UDepositSpawnManager::GetNearestDepositOfType(const FVector& Location, 
                                                               UDepositDefinition* DepositType) const
 {
-    AResourceDeposit* NearestDeposit = nullptr;
-    float NearestDistance = FLT_MAX;
-    
-    for (const FSpawnedDepositInfo& Info : SpawnedDeposits)
+    if (!DepositRegistry || !DepositType)
     {
-        if (IsValid(Info.SpawnedActor) && Info.DepositDefinition == DepositType)
-        {
-            float Distance = FVector::Dist(Location, Info.SpawnLocation);
-            if (Distance < NearestDistance)
-            {
-                NearestDistance = Distance;
-                NearestDeposit = Info.SpawnedActor;
-            }
-        }
+        return nullptr;
     }
     
-    return NearestDeposit;
+    return DepositRegistry->FindNearestDeposit(Location, DepositType);
 }
 
 float UDepositSpawnManager::GetMinimumDistanceBetweenDeposits(UDepositDefinition* DepositType) const
@@ -319,42 +339,95 @@ float UDepositSpawnManager::GetMinimumDistanceBetweenDeposits(UDepositDefinition
 
 ETerrainType UDepositSpawnManager::AnalyzeTerrainType(const FVector& Location) const
 {
-    // ✅ UPROSZCZENIE: Zawsze zwracaj Plains (wszystkie lokacje są valid)
-    return ETerrainType::Plains;
+    // Bez rastra (przed pierwszym bake) wszystko jest równiną
+    return TerrainRaster.SampleTerrainType(Location);
 }
 
 float UDepositSpawnManager::GetElevationAtLocation(const FVector& Location) const
 {
-    // ✅ UPROSZCZENIE: Zawsze zwracaj neutralną wysokość
-    return 0.0f;
+    return TerrainRaster.SampleElevation(Location);
 }
 
 bool UDepositSpawnManager::IsLocationNearWater(const FVector& Location, float WaterCheckRadius) const
 {
-    // ✅ UPROSZCZENIE: Nigdy nie sprawdzaj wody
-    return false;
+    return TerrainRaster.SampleDistanceToWater(Location) <= WaterCheckRadius;
 }
 
 bool UDepositSpawnManager::IsMinimumDistanceRespected(const FVector& Location, UDepositDefinition* DepositType, float MinDistance) const
 {
-    for (const FSpawnedDepositInfo& Info : SpawnedDeposits)
+    if (!DepositRegistry)
     {
-        if (IsValid(Info.SpawnedActor) && Info.DepositDefinition == DepositType)
-        {
-            float Distance = FVector::Dist(Location, Info.SpawnLocation);
-            if (Distance < MinDistance)
-            {
-                return false;
-            }
-        }
+        return true;
     }
-    return true;
+    
+    // Tylko sąsiednie komórki - koszt nie rośnie z liczbą złóż na mapie.
+    // Złoża bez aktorów (rekordy symulacji) liczą się tak samo jak aktory.
+    return !DepositRegistry->IsAnyDepositOfTypeWithinRadius(Location, MinDistance, DepositType) &&
+           !(SimulationManager && SimulationManager->IsAnyDepositOfTypeWithinRadius(Location, MinDistance, DepositType));
 }
 
 bool UDepositSpawnManager::IsValidSpawnLocation(const FVector& Location, const FDepositSpawnRule& SpawnRule) const
 {
-    // ✅ UPROSZCZENIE: Tylko sprawdzenie dystansu między depositami
-    return IsMinimumDistanceRespected(Location, SpawnRule.DepositDefinition, SpawnRule.MinDistanceFromOthers);
+    return PassesTerrainRules(TerrainRaster, Location, SpawnRule) &&
+           IsMinimumDistanceRespected(Location, SpawnRule.DepositDefinition, SpawnRule.MinDistanceFromOthers);
+}
+
+bool UDepositSpawnManager::PassesTerrainRules(const FDepositTerrainRaster& Raster, const FVector& Location, const FDepositSpawnRule& SpawnRule)
+{
+    // Bez rastra nie ma danych o terenie - reguły terenu nie mogą niczego odrzucić
+    if (!Raster.IsBaked())
+    {
+        return true;
+    }
+    
+    const float Elevation = Raster.SampleElevation(Location);
+    if (Elevation < SpawnRule.MinElevation || Elevation > SpawnRule.MaxElevation)
+    {
+        return false;
+    }
+    
+    if (Raster.IsWater(Location) || Raster.SampleDistanceToWater(Location) < SpawnRule.MinDistanceFromWater)
+    {
+        return false;
+    }
+    
+    // PreferCoastline dopuszcza wybrzeże niezależnie od listy preferowanych typów
+    const ETerrainType TerrainType = Raster.SampleTerrainType(Location);
+    if (SpawnRule.PreferCoastline && TerrainType == ETerrainType::Coastline)
+    {
+        return true;
+    }
+    
+    return SpawnRule.PreferredTerrainTypes.Num() == 0 || SpawnRule.PreferredTerrainTypes.Contains(TerrainType);
+}
+
+bool UDepositSpawnManager::BakeTerrainRaster()
+{
+    // Worker planowania czyta raster - nie wolno go przebudować w trakcie
+    if (IsGeneratingDeposits())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("DepositSpawnManager: Cannot bake terrain raster during async generation"));
+        return false;
+    }
+    
+    return RebuildTerrainRaster();
+}
+
+bool UDepositSpawnManager::RebuildTerrainRaster()
+{
+    const double StartTime = FPlatformTime::Seconds();
+    const FBox SpawnArea = FBox::BuildAABB(SpawnAreaCenter, SpawnAreaSize * 0.5f);
+    
+    bTerrainRasterDirty = false;
+    if (!TerrainRaster.BakeFromWorld(GetWorld(), SpawnArea, TerrainRasterCellSize, TerrainTraceChannel, bUseSeaLevel, SeaLevel))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("DepositSpawnManager: Terrain raster bake failed - terrain rules are ignored"));
+        return false;
+    }
+    
+    UE_LOG(LogTemp, Log, TEXT("DepositSpawnManager: Baked terrain raster (%d cells of %.0f) in %.2f ms"), 
+        TerrainRaster.GetNumCells(), TerrainRaster.GetCellSize(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+    return true;
 }
 
 // === PRIVATE FUNCTIONS ===
@@ -371,44 +444,12 @@ void UDepositSpawnManager::LoadDefaultSpawnRules()
     
     UE_LOG(LogTemp, Log, TEXT("DepositSpawnManager: Loading default spawn rules..."));
     
-    // ✅ NAPRAWIONE: Używamy publicznej funkcji GetAllDeposits() zamiast bezpośredniego dostępu do DepositDefinitions
-    // Zakładając, że DataTableManager ma publiczną funkcję do pobierania wszystkich depozytów
-    TArray<UDepositDefinition*> AllDeposits;
-    
-    // Próbujemy różne sposoby pobrania definicji depozytów z DataTableManager
-    // Metoda 1: Sprawdzamy czy istnieje publiczna funkcja GetAllDepositDefinitions
-    for (int32 i = 0; i < 100; i++) // Ograniczamy do 100 prób, żeby nie było nieskończonej pętli
-    {
-        FString DepositName = FString::Printf(TEXT("Deposit_%d"), i);
-        UDepositDefinition* DepositDef = DataTableManager->GetDepositDefinitionByName(DepositName);
-        if (DepositDef)
-        {
-            AllDeposits.Add(DepositDef);
-        }
-        else
-        {
-            // Próbujemy typowe nazwy depozytów
-            TArray<FString> CommonDepositNames = {
-                TEXT("Iron"), TEXT("Coal"), TEXT("Oil"), TEXT("Gold"), TEXT("Copper"),
-                TEXT("Stone"), TEXT("Sand"), TEXT("Clay"), TEXT("Limestone"), TEXT("Granite")
-            };
-            
-            if (i < CommonDepositNames.Num())
-            {
-                UDepositDefinition* CommonDeposit = DataTableManager->GetDepositDefinitionByName(CommonDepositNames[i]);
-                if (CommonDeposit)
-                {
-                    AllDeposits.Add(CommonDeposit);
-                }
-            }
-        }
-    }
+    // Jeden przebieg po rejestrze definicji (Asset Manager + przypisane ręcznie) - bez zgadywania nazw
+    const TArray<UDepositDefinition*> AllDeposits = DataTableManager->GetAllDepositDefinitions();
     
-    // Jeśli nie znaleźliśmy żadnych depozytów przez GetDepositDefinitionByName,
-    // oznacza to, że prawdopodobnie potrzebujemy innej metody dostępu
     if (AllDeposits.Num() == 0)
     {
-        UE_LOG(LogTemp, Warning, TEXT("DepositSpawnManager: No deposit definitions found through GetDepositDefinitionByName. Check DataTableManager implementation."));
+        UE_LOG(LogTemp, Warning, TEXT("DepositSpawnManager: No deposit definitions registered. Check the DepositDefinition primary asset type in DefaultGame.ini."));
         
         // Jako fallback, tworzymy podstawowe reguły spawnu bez sprawdzania wszystkich definicji
         CreateFallbackSpawnRules();
@@ -504,39 +545,561 @@ void UDepositSpawnManager::CreateFallbackSpawnRules()
     UE_LOG(LogTemp, Log, TEXT("DepositSpawnManager: Fallback rules created, but no specific deposit definitions loaded"));
 }
 
-TArray<FVector> UDepositSpawnManager::GenerateSpawnCandidates()
+int32 UDepositSpawnManager::PickGenerationSeed()
+{
+    // Jeden seed na generację - strumienie reguł i kafelków są z niego wyprowadzane,
+    // więc wynik nie zależy od kolejności wykonania na workerach
+    if (bRandomizeSeed)
+    {
+        SpawnSeed = static_cast<int32>(FPlatformTime::Cycles() ^ GetTypeHash(FPlatformTime::Seconds()));
+    }
+    LastGenerationSeed = SpawnSeed;
+    
+    UE_LOG(LogTemp, Log, TEXT("DepositSpawnManager: Generation seed %d"), SpawnSeed);
+    return SpawnSeed;
+}
+
+FDepositSpawnPlanSettings UDepositSpawnManager::MakePlanSettings(int32 GenerationSeed, bool bCheckExistingDeposits)
+{
+    // Raster terenu powstaje raz na obszar spawnu, na game thread - planowanie tylko go czyta
+    if (bTerrainRasterDirty)
+    {
+        RebuildTerrainRaster();
+    }
+    
+    // Komórki indeksu = MinDistanceFromOthers, więc sprawdzenie dystansu to blok 3x3.
+    // Ustawiane tutaj, na game thread - planowanie tylko czyta rejestr.
+    if (DepositRegistry)
+    {
+        for (const FDepositSpawnRule& SpawnRule : SpawnRules)
+        {
+            if (SpawnRule.DepositDefinition)
+            {
+                DepositRegistry->SetDepositTypeCellSize(SpawnRule.DepositDefinition, SpawnRule.MinDistanceFromOthers);
+                if (SimulationManager)
+                {
+                    SimulationManager->SetDepositTypeCellSize(SpawnRule.DepositDefinition, SpawnRule.MinDistanceFromOthers);
+                }
+            }
+        }
+    }
+    
+    // Wszystkie meshe aktywnych reguł w jednym żądaniu - spawnowane złoża dostają je bez osobnych ładowań
+    if (MeshStreamer)
+    {
+        TArray<const UDepositDefinition*> RuleDefinitions;
+        for (const FDepositSpawnRule& SpawnRule : SpawnRules)
+        {
+            if (SpawnRule.DepositDefinition && SpawnRule.MaxDepositCount > 0)
+            {
+                RuleDefinitions.AddUnique(SpawnRule.DepositDefinition);
+            }
+        }
+        MeshStreamer->PrefetchDefinitions(RuleDefinitions);
+    }
+    
+    FDepositSpawnPlanSettings Settings;
+    Settings.SpawnRules = SpawnRules;
+    Settings.SpawnAreaCenter = SpawnAreaCenter;
+    Settings.SpawnAreaSize = SpawnAreaSize;
+    Settings.PlacementMode = PlacementMode;
+    Settings.GridResolution = GridResolution;
+    Settings.MaxSpawnAttempts = MaxSpawnAttempts;
+    Settings.GenerationSeed = GenerationSeed;
+    Settings.bCheckExistingDeposits = bCheckExistingDeposits;
+    return Settings;
+}
+
+int32 UDepositSpawnManager::BuildSpawnPlan(const FDepositSpawnPlanSettings& Settings, TArray<FPlannedDepositSpawn>& OutSpawnPlan) const
 {
-    TArray<FVector> Candidates;
+    if (Settings.PlacementMode == EDepositPlacementMode::PoissonDisk)
+    {
+        return PlanSpawnsPoissonDisk(Settings, OutSpawnPlan);
+    }
+    
+    // Generate spawn candidates (parallel over grid tiles)
+    FDepositCandidateGrid CandidateGrid;
+    GenerateSpawnCandidates(Settings, CandidateGrid);
+    
+    UE_LOG(LogTemp, Log, TEXT("DepositSpawnManager: Generated %d spawn candidates in %d tiles"), 
+           CandidateGrid.Locations.Num(), CandidateGrid.NumTiles());
+    
+    int32 CandidateCount = 0;
+    for (int32 RuleIndex = 0; RuleIndex < Settings.SpawnRules.Num() && !Settings.IsCancelled(); ++RuleIndex)
+    {
+        PlanSpawnsForRule(Settings, RuleIndex, CandidateGrid, OutSpawnPlan);
+        if (Settings.SpawnRules[RuleIndex].DepositDefinition)
+        {
+            CandidateCount += CandidateGrid.Locations.Num();
+        }
+    }
+    return CandidateCount;
+}
+
+void UDepositSpawnManager::GenerateSpawnCandidates(const FDepositSpawnPlanSettings& Settings, FDepositCandidateGrid& OutCandidateGrid) const
+{
+    OutCandidateGrid = FDepositCandidateGrid();
     
     // Generate grid-based candidates within spawn area
-    FVector HalfSize = SpawnAreaSize * 0.5f;
-    float StepSize = FMath::Max(SpawnAreaSize.X, SpawnAreaSize.Y) / GridResolution;
+    const FVector& AreaCenter = Settings.SpawnAreaCenter;
+    const FVector& AreaSize = Settings.SpawnAreaSize;
+    const FVector HalfSize = AreaSize * 0.5f;
+    const float StepSize = FMath::Max(AreaSize.X, AreaSize.Y) / FMath::Max(Settings.GridResolution, 1);
+    if (StepSize <= KINDA_SMALL_NUMBER)
+    {
+        return;
+    }
+    
+    OutCandidateGrid.TileSize = SpawnTileSize;
+    OutCandidateGrid.NumX = FMath::FloorToInt(FMath::Max(AreaSize.X, 0.0f) / StepSize) + 1;
+    OutCandidateGrid.NumY = FMath::FloorToInt(FMath::Max(AreaSize.Y, 0.0f) / StepSize) + 1;
+    OutCandidateGrid.NumTilesX = FMath::DivideAndRoundUp(OutCandidateGrid.NumX, SpawnTileSize);
+    OutCandidateGrid.NumTilesY = FMath::DivideAndRoundUp(OutCandidateGrid.NumY, SpawnTileSize);
+    OutCandidateGrid.Locations.SetNumUninitialized(OutCandidateGrid.NumX * OutCandidateGrid.NumY);
+    
+    const float Jitter = StepSize * 0.3f;
+    
+    // Każdy kafelek pisze tylko swoje komórki, więc nie potrzeba synchronizacji
+    ParallelFor(OutCandidateGrid.NumTiles(), [this, &Settings, &AreaCenter, HalfSize, StepSize, Jitter, &OutCandidateGrid](int32 TileIndex)
+    {
+        FRandomStream TileStream(MakeSpawnStreamSeed(Settings.GenerationSeed, CandidateStreamId, TileIndex));
+        
+        FIntPoint TileMin;
+        FIntPoint TileMax;
+        OutCandidateGrid.GetTileBounds(TileIndex, TileMin, TileMax);
+        
+        for (int32 Y = TileMin.Y; Y < TileMax.Y; ++Y)
+        {
+            for (int32 X = TileMin.X; X < TileMax.X; ++X)
+            {
+                FVector Candidate = AreaCenter + FVector(-HalfSize.X + X * StepSize, -HalfSize.Y + Y * StepSize, 0.0f);
+                
+                // Add some randomization to avoid perfect grid
+                Candidate.X += TileStream.FRandRange(-Jitter, Jitter);
+                Candidate.Y += TileStream.FRandRange(-Jitter, Jitter);
+                
+                // Set Z to ground level
+                Candidate.Z = GetElevationAtLocation(Candidate);
+                
+                OutCandidateGrid.Locations[Y * OutCandidateGrid.NumX + X] = Candidate;
+            }
+        }
+    });
+}
+
+void UDepositSpawnManager::PlanSpawnsForRule(const FDepositSpawnPlanSettings& Settings, int32 RuleIndex, const FDepositCandidateGrid& CandidateGrid, TArray<FPlannedDepositSpawn>& OutSpawnPlan) const
+{
+    const FDepositSpawnRule& SpawnRule = Settings.SpawnRules[RuleIndex];
+    if (!SpawnRule.DepositDefinition)
+    {
+        return;
+    }
+    
+    UE_LOG(LogTemp, Log, TEXT("DepositSpawnManager: Processing rule for %s (Probability: %.3f, Max: %d)"), 
+           *SpawnRule.DepositDefinition->DepositName.ToString(),
+           SpawnRule.SpawnProbability,
+           SpawnRule.MaxDepositCount);
+    
+    // Rzut prawdopodobieństwa + reguły terenu (raster) + dystans do istniejących złóż, równolegle po kafelkach.
+    // Wynik to flaga na kandydata (każdy kafelek pisze tylko swoje komórki)
+    const int32 NumTiles = CandidateGrid.NumTiles();
+    const int32 NumCandidates = CandidateGrid.Locations.Num();
+    const int32 RuleStreamId = CandidateStreamId + 1 + RuleIndex;
+    
+    TArray<uint8> Accepted;
+    Accepted.SetNumZeroed(NumCandidates);
+    
+    ParallelFor(NumTiles, [this, &Settings, &SpawnRule, &CandidateGrid, &Accepted, RuleStreamId](int32 TileIndex)
+    {
+        FRandomStream TileStream(MakeSpawnStreamSeed(Settings.GenerationSeed, RuleStreamId, TileIndex));
+        
+        FIntPoint TileMin;
+        FIntPoint TileMax;
+        CandidateGrid.GetTileBounds(TileIndex, TileMin, TileMax);
+        
+        for (int32 Y = TileMin.Y; Y < TileMax.Y; ++Y)
+        {
+            for (int32 X = TileMin.X; X < TileMax.X; ++X)
+            {
+                const int32 CandidateIndex = Y * CandidateGrid.NumX + X;
+                const FVector& Candidate = CandidateGrid.Locations[CandidateIndex];
+                if (TileStream.GetFraction() < SpawnRule.SpawnProbability &&
+                    PassesTerrainRules(TerrainRaster, Candidate, SpawnRule) &&
+                    (!Settings.bCheckExistingDeposits || IsMinimumDistanceRespected(Candidate, SpawnRule.DepositDefinition, SpawnRule.MinDistanceFromOthers)))
+                {
+                    Accepted[CandidateIndex] = 1;
+                }
+            }
+        }
+    });
+    
+    int32 ValidLocationCount = 0;
+    for (const uint8 bAccepted : Accepted)
+    {
+        ValidLocationCount += bAccepted;
+    }
+    
+    // MaxSpawnAttempts liczy każdego wylosowanego kandydata, także odrzuconego w przebiegu równoległym -
+    // ta sama semantyka co w pętli sekwencyjnej. Fisher-Yates po wszystkich kandydatach, przerywany razem
+    // z pętlą, więc tasujemy tylko tyle pozycji, ile prób faktycznie wykonano
+    TArray<int32> CandidateOrder;
+    CandidateOrder.SetNumUninitialized(NumCandidates);
+    for (int32 CandidateIndex = 0; CandidateIndex < NumCandidates; ++CandidateIndex)
+    {
+        CandidateOrder[CandidateIndex] = CandidateIndex;
+    }
+    
+    FRandomStream RuleStream(MakeSpawnStreamSeed(Settings.GenerationSeed, RuleStreamId, NumTiles));
+    
+    // Dystans między nowymi złożami tej reguły - sekwencyjnie, w kolejności permutacji
+    FDepositSpatialHash PlannedIndex(SpawnRule.MinDistanceFromOthers);
+    int32 PlannedCount = 0;
+    int32 AttemptCount = 0;
+    
+    for (int32 OrderIndex = 0; OrderIndex < NumCandidates; ++OrderIndex)
+    {
+        if (PlannedCount >= SpawnRule.MaxDepositCount)
+        {
+            UE_LOG(LogTemp, VeryVerbose, TEXT("  Reached max count (%d) for %s"), 
+                   SpawnRule.MaxDepositCount, *SpawnRule.DepositDefinition->DepositName.ToString());
+            break;
+        }
+        
+        if (AttemptCount >= Settings.MaxSpawnAttempts)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("  Max spawn attempts (%d) reached for %s"), 
+                   Settings.MaxSpawnAttempts, *SpawnRule.DepositDefinition->DepositName.ToString());
+            break;
+        }
+        AttemptCount++;
+        
+        CandidateOrder.Swap(OrderIndex, RuleStream.RandRange(OrderIndex, NumCandidates - 1));
+        if (!Accepted[CandidateOrder[OrderIndex]])
+        {
+            continue;
+        }
+        
+        const FVector& Candidate = CandidateGrid.Locations[CandidateOrder[OrderIndex]];
+        if (PlannedIndex.AnyWithinRadius(Candidate, SpawnRule.MinDistanceFromOthers))
+        {
+            UE_LOG(LogTemp, VeryVerbose, TEXT("  ❌ Location invalid (too close to other deposits)"));
+            continue;
+        }
+        
+        PlannedIndex.Add(PlannedCount, Candidate);
+        PlannedCount++;
+        
+        FPlannedDepositSpawn& PlannedSpawn = OutSpawnPlan.AddDefaulted_GetRef();
+        PlannedSpawn.DepositDefinition = SpawnRule.DepositDefinition;
+        PlannedSpawn.Location = Candidate;
+        PlannedSpawn.MinDistanceFromOthers = SpawnRule.MinDistanceFromOthers;
+    }
+    
+    UE_LOG(LogTemp, Log, TEXT("DepositSpawnManager: 📊 %s Summary: %d/%d planned from %d valid locations (%d attempts)"), 
+        *SpawnRule.DepositDefinition->DepositName.ToString(),
+        PlannedCount, SpawnRule.MaxDepositCount, ValidLocationCount, AttemptCount);
+}
+
+int32 UDepositSpawnManager::PlanSpawnsPoissonDisk(const FDepositSpawnPlanSettings& Settings, TArray<FPlannedDepositSpawn>& OutSpawnPlan) const
+{
+    const TArray<FDepositSpawnRule>& Rules = Settings.SpawnRules;
+    const FVector HalfSize = Settings.SpawnAreaSize * 0.5f;
+    const FBox2D SpawnBounds(
+        FVector2D(Settings.SpawnAreaCenter.X - HalfSize.X, Settings.SpawnAreaCenter.Y - HalfSize.Y),
+        FVector2D(Settings.SpawnAreaCenter.X + HalfSize.X, Settings.SpawnAreaCenter.Y + HalfSize.Y));
     
-    for (float X = -HalfSize.X; X <= HalfSize.X; X += StepSize)
+    // Największe promienie najpierw: mniejsze typy wypełniają luki między nimi,
+    // a odstęp między typami to promień mniejszego z nich
+    TArray<int32> RuleOrder;
+    float SmallestRadius = MAX_flt;
+    for (int32 RuleIndex = 0; RuleIndex < Rules.Num(); ++RuleIndex)
     {
-        for (float Y = -HalfSize.Y; Y <= HalfSize.Y; Y += StepSize)
+        if (Rules[RuleIndex].DepositDefinition)
         {
-            FVector Candidate = SpawnAreaCenter + FVector(X, Y, 0);
+            RuleOrder.Add(RuleIndex);
+            SmallestRadius = FMath::Min(SmallestRadius, Rules[RuleIndex].MinDistanceFromOthers);
+        }
+    }
+    
+    RuleOrder.StableSort([&Rules](int32 A, int32 B)
+    {
+        return Rules[A].MinDistanceFromOthers > Rules[B].MinDistanceFromOthers;
+    });
+    
+    // Wszystkie zaplanowane złoża (Z = 0 - odstępy liczone w płaszczyźnie XY)
+    FDepositSpatialHash PlannedIndex(RuleOrder.Num() > 0 ? SmallestRadius : 2000.0f);
+    int32 SampleCount = 0;
+    
+    for (const int32 RuleIndex : RuleOrder)
+    {
+        if (Settings.IsCancelled())
+        {
+            break;
+        }
+        
+        const FDepositSpawnRule& SpawnRule = Rules[RuleIndex];
+        const float Radius = FMath::Max(SpawnRule.MinDistanceFromOthers, 1.0f);
+        
+        FRandomStream RuleStream(MakeSpawnStreamSeed(Settings.GenerationSeed, CandidateStreamId + 1 + RuleIndex, 0));
+        
+        // Pełny, maksymalny zbiór próbek dla tego promienia, omijający złoża innych typów
+        TArray<FVector2D> Samples;
+        const FPoissonDiskSampler Sampler(SpawnBounds, Radius);
+        Sampler.Generate(RuleStream, Samples, [&PlannedIndex, Radius](const FVector2D& Point)
+        {
+            return !PlannedIndex.AnyWithinRadius(FVector(Point, 0.0f), Radius);
+        });
+        SampleCount += Samples.Num();
+        
+        // Losowy podzbiór próbek dalej zachowuje odstęp r - Fisher-Yates na indeksach
+        TArray<int32> SampleOrder;
+        SampleOrder.SetNumUninitialized(Samples.Num());
+        for (int32 i = 0; i < SampleOrder.Num(); ++i)
+        {
+            SampleOrder[i] = i;
+        }
+        for (int32 i = SampleOrder.Num() - 1; i > 0; --i)
+        {
+            SampleOrder.Swap(i, RuleStream.RandRange(0, i));
+        }
+        
+        int32 PlannedCount = 0;
+        for (const int32 SampleIndex : SampleOrder)
+        {
+            if (PlannedCount >= SpawnRule.MaxDepositCount)
+            {
+                break;
+            }
             
-            // Add some randomization to avoid perfect grid
-            Candidate.X += FMath::RandRange(-StepSize * 0.3f, StepSize * 0.3f);
-            Candidate.Y += FMath::RandRange(-StepSize * 0.3f, StepSize * 0.3f);
+            if (RuleStream.GetFraction() >= SpawnRule.SpawnProbability)
+            {
+                continue;
+            }
             
-            // Set Z to ground level
+            FVector Candidate(Samples[SampleIndex], 0.0f);
             Candidate.Z = GetElevationAtLocation(Candidate);
             
-            Candidates.Add(Candidate);
+            // Istniejące złoża (spoza tej generacji) i ograniczenia terenu
+            if (!PassesTerrainRules(TerrainRaster, Candidate, SpawnRule) ||
+                (Settings.bCheckExistingDeposits && !IsMinimumDistanceRespected(Candidate, SpawnRule.DepositDefinition, SpawnRule.MinDistanceFromOthers)))
+            {
+                continue;
+            }
+            
+            PlannedIndex.Add(OutSpawnPlan.Num(), FVector(Samples[SampleIndex], 0.0f));
+            PlannedCount++;
+            
+            FPlannedDepositSpawn& PlannedSpawn = OutSpawnPlan.AddDefaulted_GetRef();
+            PlannedSpawn.DepositDefinition = SpawnRule.DepositDefinition;
+            PlannedSpawn.Location = Candidate;
+            PlannedSpawn.MinDistanceFromOthers = SpawnRule.MinDistanceFromOthers;
+        }
+        
+        UE_LOG(LogTemp, Log, TEXT("DepositSpawnManager: 📊 %s Summary (Poisson, r=%.0f): %d/%d planned from %d samples"), 
+            *SpawnRule.DepositDefinition->DepositName.ToString(),
+            Radius, PlannedCount, SpawnRule.MaxDepositCount, Samples.Num());
+    }
+    
+    return SampleCount;
+}
+
+int32 UDepositSpawnManager::ExecuteSpawnPlan(const TArray<FPlannedDepositSpawn>& SpawnPlan, int32& InOutNextIndex, double Deadline, bool bValidateAgainstRegistry)
+{
+    // SpawnActor tylko na game thread, po gotowym planie
+    check(IsInGameThread());
+    
+    SpawnedDeposits.Reserve(SpawnedDeposits.Num() + SpawnPlan.Num() - InOutNextIndex);
+    
+    int32 SpawnedCount = 0;
+    while (InOutNextIndex < SpawnPlan.Num())
+    {
+        const FPlannedDepositSpawn& PlannedSpawn = SpawnPlan[InOutNextIndex++];
+        
+        // Plan z workera nie widział rejestru - złoża spoza generacji sprawdzamy dopiero tutaj
+        if (bValidateAgainstRegistry && 
+            !IsMinimumDistanceRespected(PlannedSpawn.Location, PlannedSpawn.DepositDefinition, PlannedSpawn.MinDistanceFromOthers))
+        {
+            UE_LOG(LogTemp, VeryVerbose, TEXT("  ❌ Planned location blocked by an existing deposit: %s"), *PlannedSpawn.Location.ToString());
+        }
+        else if (bSpawnAsSimulationRecords && SimulationManager)
+        {
+            // Bez aktora - rekord + instancja w batchu definicji, awans do AResourceDeposit na żądanie
+            if (SimulationManager->AddDeposit(PlannedSpawn.DepositDefinition, PlannedSpawn.Location) != INDEX_NONE)
+            {
+                SpawnedCount++;
+            }
+        }
+        else if (SpawnDepositAtLocation(PlannedSpawn.DepositDefinition, PlannedSpawn.Location, FRotator::ZeroRotator))
+        {
+            SpawnedCount++;
+        }
+        else
+        {
+            UE_LOG(LogTemp, Warning, TEXT("  ❌ Failed to spawn at %s"), *PlannedSpawn.Location.ToString());
+        }
+        
+        if (FPlatformTime::Seconds() >= Deadline)
+        {
+            break;
+        }
+    }
+    
+    return SpawnedCount;
+}
+
+void UDepositSpawnManager::StartAsyncGeneration(float SpawnBudgetMs, bool bGenerateAfterClear)
+{
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        UE_LOG(LogTemp, Error, TEXT("DepositSpawnManager: World is null"));
+        return;
+    }
+    
+    CancelDepositGeneration();
+    
+    AsyncGeneration = MakeShared<FDepositAsyncGeneration>();
+    AsyncGeneration->bGenerateAfterClear = bGenerateAfterClear;
+    AsyncGeneration->SpawnBudgetSeconds = FMath::Max(SpawnBudgetMs, 0.1f) * 0.001;
+    if (bGenerateAfterClear)
+    {
+        AsyncGeneration->GenerationSeed = PickGenerationSeed();
+    }
+    
+    // Usuwanie też w budżecie - dotychczasowe złoża przechodzą do kolejki
+    DepositsPendingDestroy = MoveTemp(SpawnedDeposits);
+    SpawnedDeposits.Reset();
+    
+    // Rekordy to tylko instancje ISM - czyszczenie jest tanie, nie potrzebuje budżetu
+    if (SimulationManager)
+    {
+        SimulationManager->ClearAllDeposits();
+    }
+    
+    AsyncGenerationTimerHandle = World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateUObject(this, &UDepositSpawnManager::TickAsyncGeneration));
+}
+
+void UDepositSpawnManager::TickAsyncGeneration()
+{
+    UWorld* World = GetWorld();
+    if (!AsyncGeneration.IsValid() || !World)
+    {
+        return;
+    }
+    
+    // Lokalna kopia wskaźnika - handlery OnDepositSpawned mogą anulować generację w trakcie spawnu
+    const TSharedPtr<FDepositAsyncGeneration> StatePtr = AsyncGeneration;
+    FDepositAsyncGeneration& State = *StatePtr;
+    const double Deadline = FPlatformTime::Seconds() + State.SpawnBudgetSeconds;
+    
+    if (State.Phase == FDepositAsyncGeneration::EPhase::Clearing)
+    {
+        while (DepositsPendingDestroy.Num() > 0 && FPlatformTime::Seconds() < Deadline)
+        {
+            const FSpawnedDepositInfo DepositInfo = DepositsPendingDestroy.Pop(EAllowShrinking::No);
+            if (IsValid(DepositInfo.SpawnedActor))
+            {
+                DepositInfo.SpawnedActor->Destroy();
+            }
+        }
+        
+        if (DepositsPendingDestroy.Num() > 0)
+        {
+            AsyncGenerationTimerHandle = World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateUObject(this, &UDepositSpawnManager::TickAsyncGeneration));
+            return;
+        }
+        
+        if (!State.bGenerateAfterClear)
+        {
+            FinishAsyncGeneration(false);
+            OnAllDepositsCleared.Broadcast();
+            return;
+        }
+        
+        // Kopia reguł i parametrów - worker nie dotyka UObjectów managera poza funkcjami terenu
+        const double BakeStartTime = FPlatformTime::Seconds();
+        AsyncSpawnRules = SpawnRules;
+        State.Settings = MakePlanSettings(State.GenerationSeed, false);
+        State.Settings.CancelRequested = &State.bCancelRequested;
+        State.Phase = FDepositAsyncGeneration::EPhase::Planning;
+        State.PlanSeconds = FPlatformTime::Seconds() - BakeStartTime;
+        
+        State.PlanTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [this, StatePtr]()
+        {
+            const double PlanStartTime = FPlatformTime::Seconds();
+            StatePtr->CandidateCount = BuildSpawnPlan(StatePtr->Settings, StatePtr->SpawnPlan);
+            StatePtr->PlanSeconds += FPlatformTime::Seconds() - PlanStartTime;
+        });
+    }
+    
+    if (State.Phase == FDepositAsyncGeneration::EPhase::Planning)
+    {
+        if (!State.PlanTask.IsCompleted())
+        {
+            AsyncGenerationTimerHandle = World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateUObject(this, &UDepositSpawnManager::TickAsyncGeneration));
+            return;
+        }
+        
+        UE_LOG(LogTemp, Log, TEXT("DepositSpawnManager: Async plan ready - %d deposits to spawn"), State.SpawnPlan.Num());
+        State.Phase = FDepositAsyncGeneration::EPhase::Spawning;
+    }
+    
+    if (State.NextSpawnIndex < State.SpawnPlan.Num())
+    {
+        const double SpawnStartTime = FPlatformTime::Seconds();
+        State.SpawnedCount += ExecuteSpawnPlan(State.SpawnPlan, State.NextSpawnIndex, Deadline, true);
+        State.SpawnSeconds += FPlatformTime::Seconds() - SpawnStartTime;
+    }
+    
+    // Handlery OnDepositSpawned mogły anulować (albo zrestartować) generację
+    if (AsyncGeneration != StatePtr)
+    {
+        return;
+    }
+    
+    if (State.NextSpawnIndex < State.SpawnPlan.Num())
+    {
+        OnDepositGenerationProgress.Broadcast((float)State.NextSpawnIndex / (float)State.SpawnPlan.Num(), State.SpawnedCount);
+        if (AsyncGeneration == StatePtr)
+        {
+            AsyncGenerationTimerHandle = World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateUObject(this, &UDepositSpawnManager::TickAsyncGeneration));
         }
+        return;
     }
     
-    // Shuffle candidates for more random distribution
-    for (int32 i = Candidates.Num() - 1; i > 0; i--)
+    FinishAsyncGeneration(true);
+}
+
+void UDepositSpawnManager::FinishAsyncGeneration(bool bGenerated)
+{
+    if (UWorld* World = GetWorld())
     {
-        int32 RandomIndex = FMath::RandRange(0, i);
-        Candidates.Swap(i, RandomIndex);
+        World->GetTimerManager().ClearTimer(AsyncGenerationTimerHandle);
     }
     
-    return Candidates;
+    const TSharedPtr<FDepositAsyncGeneration> FinishedGeneration = MoveTemp(AsyncGeneration);
+    const int32 SpawnedCount = FinishedGeneration.IsValid() ? FinishedGeneration->SpawnedCount : 0;
+    const int32 PlannedCount = FinishedGeneration.IsValid() ? FinishedGeneration->SpawnPlan.Num() : 0;
+    AsyncSpawnRules.Empty();
+    
+    if (!bGenerated || !FinishedGeneration.IsValid())
+    {
+        return;
+    }
+    
+    LastGenerationStats = FDepositGenerationStats();
+    LastGenerationStats.GenerationSeed = FinishedGeneration->Settings.GenerationSeed;
+    LastGenerationStats.CandidateCount = FinishedGeneration->CandidateCount;
+    LastGenerationStats.PlannedCount = PlannedCount;
+    LastGenerationStats.SpawnedCount = SpawnedCount;
+    LastGenerationStats.PlanSeconds = FinishedGeneration->PlanSeconds;
+    LastGenerationStats.SpawnSeconds = FinishedGeneration->SpawnSeconds;
+    
+    UE_LOG(LogTemp, Log, TEXT("DepositSpawnManager: Spawned %d/%d planned deposits (async)"), SpawnedCount, PlannedCount);
+    
+    OnDepositGenerationProgress.Broadcast(1.0f, SpawnedCount);
+    LogSpawnStatistics();
+    OnAllDepositsSpawned.Broadcast(SpawnedDeposits);
 }
 
 bool UDepositSpawnManager::ValidateSpawnLocation(const FVector& Location, const FDepositSpawnRule& Rule)
@@ -545,7 +1108,7 @@ bool UDepositSpawnManager::ValidateSpawnLocation(const FVector& Location, const
     return IsValidSpawnLocation(Location, Rule);
 }
 
-UDepositDefinition* UDepositSpawnManager::SelectDepositTypeForLocation(const FVector& Location)
+UDepositDefinition* UDepositSpawnManager::SelectDepositTypeForLocation(const FVector& Location, FRandomStream& RandomStream)
 {
     // Select best deposit type based on terrain analysis
     ETerrainType TerrainType = AnalyzeTerrainType(Location);
@@ -566,7 +1129,7 @@ UDepositDefinition* UDepositSpawnManager::SelectDepositTypeForLocation(const FVe
     
     if (SuitableDeposits.Num() > 0)
     {
-        int32 RandomIndex = FMath::RandRange(0, SuitableDeposits.Num() - 1);
+        int32 RandomIndex = RandomStream.RandRange(0, SuitableDeposits.Num() - 1);
         return SuitableDeposits[RandomIndex];
     }
     
@@ -580,14 +1143,12 @@ void UDepositSpawnManager::SpawnDepositFromRule(const FDepositSpawnRule& Rule, c
 
 float UDepositSpawnManager::CalculateSlope(const FVector& Location) const
 {
-    // ✅ UPROSZCZENIE: Zawsze płaski teren
-    return 0.0f;
+    return TerrainRaster.SampleSlopeDegrees(Location);
 }
 
 bool UDepositSpawnManager::IsLocationInWater(const FVector& Location) const
 {
-    // ✅ UPROSZCZENIE: Nigdy nie ma wody
-    return false;
+    return TerrainRaster.IsWater(Location);
 }
 
 void UDepositSpawnManager::DrawDebugSpawnArea() const
@@ -614,6 +1175,11 @@ void UDepositSpawnManager::LogSpawnStatistics() const
 {
     UE_LOG(LogTemp, Log, TEXT("=== Deposit Spawn Statistics ==="));
     UE_LOG(LogTemp, Log, TEXT("Total Spawned Deposits: %d"), SpawnedDeposits.Num());
+    if (SimulationManager && SimulationManager->GetNumDeposits() > 0)
+    {
+        UE_LOG(LogTemp, Log, TEXT("Simulated Deposits (no actor): %d (%d promoted)"), 
+            SimulationManager->GetNumDeposits(), SimulationManager->GetNumPromotedDeposits());
+    }
     
     // Count by type
     TMap<UDepositDefinition*, int32> CountByType;
@@ -668,10 +1234,12 @@ void UDepositSpawnManager::TestProbabilityGeneration(float TestProbability, int3
     UE_LOG(LogTemp, Warning, TEXT("=== TESTING PROBABILITY GENERATION ==="));
     UE_LOG(LogTemp, Warning, TEXT("Test Probability: %.3f, Test Count: %d"), TestProbability, TestCount);
     
+    FRandomStream TestStream(MakeSpawnStreamSeed(SpawnSeed, -1, 0));
+    
     int32 SuccessCount = 0;
     for (int32 i = 0; i < TestCount; i++)
     {
-        float RandomValue = FMath::RandRange(0.0f, 1.0f);
+        float RandomValue = TestStream.GetFraction();
         bool bSuccess = RandomValue <= TestProbability;
         
         if (bSuccess)
@@ -692,9 +1260,280 @@ void UDepositSpawnManager::TestProbabilityGeneration(float TestProbability, int3
     UE_LOG(LogTemp, Warning, TEXT("=========================================="));
 }
 
+bool UDepositSpawnManager::TestTerrainRuleFiltering()
+{
+    UE_LOG(LogTemp, Warning, TEXT("=== TESTING TERRAIN RULE FILTERING ==="));
+    
+    // 64x64 komórek po 100: kolumny 0-3 woda, 4-31 płasko (h=100), 32-63 stok 45° (h rośnie o 100 na komórkę)
+    const int32 Size = 64;
+    const float CellSize = 100.0f;
+    TArray<float> Heights;
+    TArray<bool> WaterMask;
+    Heights.SetNumUninitialized(Size * Size);
+    WaterMask.SetNumUninitialized(Size * Size);
+    for (int32 Y = 0; Y < Size; ++Y)
+    {
+        for (int32 X = 0; X < Size; ++X)
+        {
+            Heights[Y * Size + X] = (X < 4) ? -50.0f : 100.0f + FMath::Max(0, X - 31) * 100.0f;
+            WaterMask[Y * Size + X] = X < 4;
+        }
+    }
+    
+    FDepositTerrainRaster TestRaster;
+    TestRaster.BuildFromHeightfield(FBox2D(FVector2D::ZeroVector, FVector2D(Size * CellSize)), CellSize, Size, Size, MoveTemp(Heights), WaterMask);
+    
+    FDepositSpawnRule PlainsRule;
+    PlainsRule.PreferredTerrainTypes = {ETerrainType::Plains};
+    
+    FDepositSpawnRule MountainRule;
+    MountainRule.PreferredTerrainTypes = {ETerrainType::Mountains};
+    MountainRule.MinElevation = 0.0f;
+    MountainRule.MaxElevation = 2000.0f;
+    
+    FDepositSpawnRule CoastRule = PlainsRule;
+    CoastRule.PreferCoastline = true;
+    
+    FDepositSpawnRule DryRule = PlainsRule;
+    DryRule.MinDistanceFromWater = 2500.0f;
+    
+    struct FTerrainCheck
+    {
+        const TCHAR* Name;
+        const FDepositSpawnRule* Rule;
+        int32 Column;
+        bool bExpected;
+    };
+    
+    const FTerrainCheck Checks[] = {
+        { TEXT("Plains rule on plains"),              &PlainsRule,   25, true  },
+        { TEXT("Plains rule on coastline"),           &PlainsRule,   10, false },
+        { TEXT("Plains rule on mountain slope"),      &PlainsRule,   45, false },
+        { TEXT("Plains rule in water"),               &PlainsRule,    1, false },
+        { TEXT("Mountain rule on slope (h=1500)"),    &MountainRule, 45, true  },
+        { TEXT("Mountain rule above MaxElevation"),   &MountainRule, 60, false },
+        { TEXT("Mountain rule on plains"),            &MountainRule, 25, false },
+        { TEXT("PreferCoastline rule on coastline"),  &CoastRule,    10, true  },
+        { TEXT("MinDistanceFromWater 2500 at 2200"),  &DryRule,      25, false },
+        { TEXT("MinDistanceFromWater 2500 at 2600"),  &DryRule,      29, true  }
+    };
+    
+    int32 FailedCount = 0;
+    for (const FTerrainCheck& Check : Checks)
+    {
+        const FVector Location((Check.Column + 0.5f) * CellSize, Size * CellSize * 0.5f, 0.0f);
+        const bool bPassed = PassesTerrainRules(TestRaster, Location, *Check.Rule);
+        const bool bOk = bPassed == Check.bExpected;
+        FailedCount += bOk ? 0 : 1;
+        
+        UE_LOG(LogTemp, Warning, TEXT("  %s: %s (%s, h=%.0f, water dist=%.0f) -> %s"), 
+               Check.Name, bPassed ? TEXT("accepted") : TEXT("rejected"),
+               *UEnum::GetValueAsString(TestRaster.SampleTerrainType(Location)),
+               TestRaster.SampleElevation(Location), TestRaster.SampleDistanceToWater(Location),
+               bOk ? TEXT("OK") : TEXT("FAIL"));
+    }
+    
+    // Na całej siatce każda reguła musi odrzucić część kandydatów
+    const FDepositSpawnRule* Rules[] = { &PlainsRule, &MountainRule, &CoastRule, &DryRule };
+    for (const FDepositSpawnRule* Rule : Rules)
+    {
+        int32 AcceptedCount = 0;
+        for (int32 Y = 0; Y < Size; ++Y)
+        {
+            for (int32 X = 0; X < Size; ++X)
+            {
+                AcceptedCount += PassesTerrainRules(TestRaster, FVector((X + 0.5f) * CellSize, (Y + 0.5f) * CellSize, 0.0f), *Rule) ? 1 : 0;
+            }
+        }
+        
+        const bool bFiltered = AcceptedCount > 0 && AcceptedCount < Size * Size;
+        FailedCount += bFiltered ? 0 : 1;
+        UE_LOG(LogTemp, Warning, TEXT("  Grid: %d/%d candidates accepted -> %s"), 
+               AcceptedCount, Size * Size, bFiltered ? TEXT("OK") : TEXT("FAIL"));
+    }
+    
+    UE_LOG(LogTemp, Warning, TEXT("Results: %s (%d failed)"), FailedCount == 0 ? TEXT("PASSED") : TEXT("FAILED"), FailedCount);
+    UE_LOG(LogTemp, Warning, TEXT("=========================================="));
+    return FailedCount == 0;
+}
+
 void UDepositSpawnManager::SetDepositDensity(EDepositDensity NewDensity)
 {
     DepositDensity = NewDensity;
     UE_LOG(LogTemp, Log, TEXT("DepositSpawnManager: Set density to %s"), 
         *UEnum::GetValueAsString(NewDensity));
-}
\ No newline at end of file
+}
+
+void UDepositSpawnManager::SetPlacementMode(EDepositPlacementMode NewPlacementMode)
+{
+    PlacementMode = NewPlacementMode;
+    UE_LOG(LogTemp, Log, TEXT("DepositSpawnManager: Set placement mode to %s"), 
+        *UEnum::GetValueAsString(NewPlacementMode));
+}
+
+void UDepositSpawnManager::SetSpawnSeed(int32 NewSpawnSeed, bool bNewRandomizeSeed)
+{
+    SpawnSeed = NewSpawnSeed;
+    bRandomizeSeed = bNewRandomizeSeed;
+    UE_LOG(LogTemp, Log, TEXT("DepositSpawnManager: Set spawn seed to %d (randomize: %s)"), 
+        SpawnSeed, bRandomizeSeed ? TEXT("Yes") : TEXT("No"));
+}
+
+void UDepositSpawnManager::SetSpawnAsSimulationRecords(bool bNewSpawnAsSimulationRecords)
+{
+    bSpawnAsSimulationRecords = bNewSpawnAsSimulationRecords;
+    UE_LOG(LogTemp, Log, TEXT("DepositSpawnManager: Spawn as simulation records: %s"), 
+        bSpawnAsSimulationRecords ? TEXT("Yes") : TEXT("No"));
+}
+
+void UDepositSpawnManager::SetCandidateGrid(int32 NewGridResolution, int32 NewMaxSpawnAttempts)
+{
+    GridResolution = FMath::Max(NewGridResolution, 1);
+    MaxSpawnAttempts = FMath::Max(NewMaxSpawnAttempts, 0);
+    UE_LOG(LogTemp, Log, TEXT("DepositSpawnManager: Set candidate grid to %d (max attempts: %d)"), 
+        GridResolution, MaxSpawnAttempts);
+}
+
+void UDepositSpawnManager::BenchmarkProximityQueries(int32 QueryCount, float MinDistance)
+{
+    UE_LOG(LogTemp, Warning, TEXT("=== BENCHMARK: PROXIMITY QUERIES (Spatial Hash vs Linear) ==="));
+    UE_LOG(LogTemp, Warning, TEXT("Queries per test: %d, MinDistance: %.0f"), QueryCount, MinDistance);
+    
+    QueryCount = FMath::Max(QueryCount, 1);
+    MinDistance = FMath::Max(MinDistance, 1.0f);
+    
+    const int32 DepositCounts[] = { 1000, 10000, 100000 };
+    const int32 NearestK = 8;
+    
+    for (const int32 DepositCount : DepositCounts)
+    {
+        // Stała gęstość: obszar rośnie z liczbą złóż (ok. 1 złoże na (2*MinDistance)^2)
+        const float AreaSide = FMath::Sqrt((float)DepositCount) * MinDistance * 2.0f;
+        FRandomStream RandomStream(12345);
+        
+        TArray<FVector> Locations;
+        Locations.SetNumUninitialized(DepositCount);
+        for (FVector& Location : Locations)
+        {
+            Location = FVector(RandomStream.FRandRange(0.0f, AreaSide), RandomStream.FRandRange(0.0f, AreaSide), RandomStream.FRandRange(-100.0f, 100.0f));
+        }
+        
+        TArray<FVector> Queries;
+        Queries.SetNumUninitialized(QueryCount);
+        for (FVector& Query : Queries)
+        {
+            Query = FVector(RandomStream.FRandRange(0.0f, AreaSide), RandomStream.FRandRange(0.0f, AreaSide), 0.0f);
+        }
+        
+        // Build
+        double StartTime = FPlatformTime::Seconds();
+        FDepositSpatialHash SpatialHash(MinDistance);
+        for (int32 Index = 0; Index < Locations.Num(); ++Index)
+        {
+            SpatialHash.Add(Index, Locations[Index]);
+        }
+        const double BuildMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+        
+        // Min distance check
+        int32 LinearBlocked = 0;
+        StartTime = FPlatformTime::Seconds();
+        for (const FVector& Query : Queries)
+        {
+            for (const FVector& Location : Locations)
+            {
+                if (FVector::Dist(Query, Location) < MinDistance)
+                {
+                    LinearBlocked++;
+                    break;
+                }
+            }
+        }
+        const double LinearRadiusMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+        
+        int32 HashBlocked = 0;
+        StartTime = FPlatformTime::Seconds();
+        for (const FVector& Query : Queries)
+        {
+            if (SpatialHash.AnyWithinRadius(Query, MinDistance))
+            {
+                HashBlocked++;
+            }
+        }
+        const double HashRadiusMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+        
+        // Nearest
+        TArray<int32> LinearNearest;
+        LinearNearest.Reserve(QueryCount);
+        StartTime = FPlatformTime::Seconds();
+        for (const FVector& Query : Queries)
+        {
+            int32 BestIndex = INDEX_NONE;
+            float BestDistance = FLT_MAX;
+            for (int32 Index = 0; Index < Locations.Num(); ++Index)
+            {
+                const float Distance = FVector::Dist(Query, Locations[Index]);
+                if (Distance < BestDistance)
+                {
+                    BestDistance = Distance;
+                    BestIndex = Index;
+                }
+            }
+            LinearNearest.Add(BestIndex);
+        }
+        const double LinearNearestMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+        
+        int32 NearestMismatches = 0;
+        StartTime = FPlatformTime::Seconds();
+        for (int32 QueryIndex = 0; QueryIndex < Queries.Num(); ++QueryIndex)
+        {
+            if (SpatialHash.FindNearest(Queries[QueryIndex]) != LinearNearest[QueryIndex])
+            {
+                NearestMismatches++;
+            }
+        }
+        const double HashNearestMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+        
+        // K-nearest
+        // Liniowo: ograniczony max-heap K najbliższych
+        TArray<TPair<float, int32>> NearestHeap;
+        const auto FartherFirst = [](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Key > B.Key; };
+        StartTime = FPlatformTime::Seconds();
+        for (const FVector& Query : Queries)
+        {
+            NearestHeap.Reset();
+            for (int32 Index = 0; Index < Locations.Num(); ++Index)
+            {
+                const float DistanceSquared = FVector::DistSquared(Query, Locations[Index]);
+                if (NearestHeap.Num() < NearestK)
+                {
+                    NearestHeap.HeapPush(TPair<float, int32>(DistanceSquared, Index), FartherFirst);
+                }
+                else if (DistanceSquared < NearestHeap.HeapTop().Key)
+                {
+                    NearestHeap.HeapPopDiscard(FartherFirst, EAllowShrinking::No);
+                    NearestHeap.HeapPush(TPair<float, int32>(DistanceSquared, Index), FartherFirst);
+                }
+            }
+        }
+        const double LinearKNearestMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+        
+        TArray<int32> KNearest;
+        StartTime = FPlatformTime::Seconds();
+        for (const FVector& Query : Queries)
+        {
+            SpatialHash.FindKNearest(Query, NearestK, KNearest);
+        }
+        const double HashKNearestMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+        
+        UE_LOG(LogTemp, Warning, TEXT("[%d deposits] area %.0fx%.0f, %d cells, build %.2f ms"), 
+            DepositCount, AreaSide, AreaSide, SpatialHash.NumCells(), BuildMs);
+        UE_LOG(LogTemp, Warning, TEXT("  MinDistance: linear %.2f ms | hash %.2f ms | x%.1f (blocked %d vs %d)"), 
+            LinearRadiusMs, HashRadiusMs, LinearRadiusMs / FMath::Max(HashRadiusMs, 0.001), LinearBlocked, HashBlocked);
+        UE_LOG(LogTemp, Warning, TEXT("  Nearest:     linear %.2f ms | hash %.2f ms | x%.1f (mismatches %d)"), 
+            LinearNearestMs, HashNearestMs, LinearNearestMs / FMath::Max(HashNearestMs, 0.001), NearestMismatches);
+        UE_LOG(LogTemp, Warning, TEXT("  %d-Nearest:   linear %.2f ms | hash %.2f ms | x%.1f"), 
+            NearestK, LinearKNearestMs, HashKNearestMs, LinearKNearestMs / FMath::Max(HashKNearestMs, 0.001));
+    }
+    
+    UE_LOG(LogTemp, Warning, TEXT("=========================================="));
+}
@@ -0,0 +1,271 @@
+// DepositTerrainRaster.cpp
+// Lokalizacja: Source/FactoryNet/Private/Core/DepositTerrainRaster.cpp
+
+#include "Core/DepositTerrainRaster.h"
+#include "Core/DepositSpawnManager.h"
+#include "Engine/World.h"
+#include "Components/PrimitiveComponent.h"
+#include "GameFramework/Actor.h"
+
+namespace
+{
+    const FName WaterTag(TEXT("Water"));
+}
+
+bool FDepositTerrainRaster::BakeFromWorld(UWorld* World, const FBox& SpawnArea, float InCellSize, ECollisionChannel TraceChannel,
+                                          bool bUseSeaLevel, float SeaLevel, const FDepositTerrainClassification& Classification)
+{
+    Reset();
+
+    if (!World || !SpawnArea.IsValid)
+    {
+        return false;
+    }
+
+    InCellSize = FMath::Max(InCellSize, 1.0f);
+    const FVector AreaSize = SpawnArea.GetSize();
+    const int32 InWidth = FMath::Max(1, FMath::CeilToInt(AreaSize.X / InCellSize));
+    const int32 InHeight = FMath::Max(1, FMath::CeilToInt(AreaSize.Y / InCellSize));
+    const FBox2D InBounds(FVector2D(SpawnArea.Min.X, SpawnArea.Min.Y), FVector2D(SpawnArea.Min.X + InWidth * InCellSize, SpawnArea.Min.Y + InHeight * InCellSize));
+
+    TArray<float> InHeights;
+    InHeights.SetNumUninitialized(InWidth * InHeight);
+    TArray<bool> InWaterMask;
+    InWaterMask.Init(false, InWidth * InHeight);
+
+    FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(DepositTerrainBake), false);
+    const float DefaultHeight = SpawnArea.GetCenter().Z;
+
+    // Jeden trace na komórkę, raz na bake - potem już tylko odczyty z rastra
+    for (int32 Y = 0; Y < InHeight; ++Y)
+    {
+        for (int32 X = 0; X < InWidth; ++X)
+        {
+            const int32 CellIndex = Y * InWidth + X;
+            const FVector2D CellCenter = InBounds.Min + FVector2D(X + 0.5f, Y + 0.5f) * InCellSize;
+
+            FHitResult Hit;
+            const bool bHit = World->LineTraceSingleByChannel(Hit,
+                FVector(CellCenter, SpawnArea.Max.Z), FVector(CellCenter, SpawnArea.Min.Z), TraceChannel, QueryParams);
+
+            InHeights[CellIndex] = bHit ? Hit.ImpactPoint.Z : DefaultHeight;
+
+            const AActor* HitActor = bHit ? Hit.GetActor() : nullptr;
+            const UPrimitiveComponent* HitComponent = bHit ? Hit.GetComponent() : nullptr;
+            InWaterMask[CellIndex] =
+                (bUseSeaLevel && InHeights[CellIndex] <= SeaLevel) ||
+                (HitActor && HitActor->ActorHasTag(WaterTag)) ||
+                (HitComponent && HitComponent->ComponentHasTag(WaterTag));
+        }
+    }
+
+    BuildFromHeightfield(InBounds, InCellSize, InWidth, InHeight, MoveTemp(InHeights), InWaterMask, Classification);
+    return true;
+}
+
+void FDepositTerrainRaster::BuildFromHeightfield(const FBox2D& InBounds, float InCellSize, int32 InWidth, int32 InHeight,
+                                                 TArray<float> InHeights, const TArray<bool>& InWaterMask,
+                                                 const FDepositTerrainClassification& Classification)
+{
+    Reset();
+
+    const int32 NumCells = InWidth * InHeight;
+    if (NumCells <= 0 || InHeights.Num() != NumCells || InWaterMask.Num() != NumCells)
+    {
+        UE_LOG(LogTemp, Error, TEXT("DepositTerrainRaster: Invalid heightfield (%dx%d, %d heights, %d water cells)"),
+            InWidth, InHeight, InHeights.Num(), InWaterMask.Num());
+        return;
+    }
+
+    Bounds = InBounds;
+    CellSize = FMath::Max(InCellSize, 1.0f);
+    Width = InWidth;
+    Height = InHeight;
+    Heights = MoveTemp(InHeights);
+
+    WaterCells.SetNumUninitialized(NumCells);
+    for (int32 CellIndex = 0; CellIndex < NumCells; ++CellIndex)
+    {
+        WaterCells[CellIndex] = InWaterMask[CellIndex] ? 1 : 0;
+    }
+
+    ComputeSlopes();
+    ComputeDistanceToWater();
+    ClassifyCells(Classification);
+}
+
+void FDepositTerrainRaster::Reset()
+{
+    Bounds = FBox2D(ForceInit);
+    CellSize = 0.0f;
+    Width = 0;
+    Height = 0;
+    Heights.Empty();
+    Slopes.Empty();
+    WaterDistances.Empty();
+    WaterCells.Empty();
+    TerrainTypes.Empty();
+}
+
+float FDepositTerrainRaster::SampleElevation(const FVector& Location) const
+{
+    if (!IsBaked())
+    {
+        return 0.0f;
+    }
+
+    // Wysokości leżą w środkach komórek - interpolacja dwuliniowa między czterema sąsiednimi
+    const float GridX = FMath::Clamp((Location.X - Bounds.Min.X) / CellSize - 0.5f, 0.0f, (float)(Width - 1));
+    const float GridY = FMath::Clamp((Location.Y - Bounds.Min.Y) / CellSize - 0.5f, 0.0f, (float)(Height - 1));
+    const int32 X0 = FMath::FloorToInt(GridX);
+    const int32 Y0 = FMath::FloorToInt(GridY);
+    const int32 X1 = FMath::Min(X0 + 1, Width - 1);
+    const int32 Y1 = FMath::Min(Y0 + 1, Height - 1);
+    const float AlphaX = GridX - X0;
+    const float AlphaY = GridY - Y0;
+
+    const float Bottom = FMath::Lerp(GetCellHeight(X0, Y0), GetCellHeight(X1, Y0), AlphaX);
+    const float Top = FMath::Lerp(GetCellHeight(X0, Y1), GetCellHeight(X1, Y1), AlphaX);
+    return FMath::Lerp(Bottom, Top, AlphaY);
+}
+
+float FDepositTerrainRaster::SampleSlopeDegrees(const FVector& Location) const
+{
+    return IsBaked() ? Slopes[GetCellIndex(Location)] : 0.0f;
+}
+
+ETerrainType FDepositTerrainRaster::SampleTerrainType(const FVector& Location) const
+{
+    return IsBaked() ? static_cast<ETerrainType>(TerrainTypes[GetCellIndex(Location)]) : ETerrainType::Plains;
+}
+
+bool FDepositTerrainRaster::IsWater(const FVector& Location) const
+{
+    return IsBaked() && WaterCells[GetCellIndex(Location)] != 0;
+}
+
+float FDepositTerrainRaster::SampleDistanceToWater(const FVector& Location) const
+{
+    return IsBaked() ? WaterDistances[GetCellIndex(Location)] : MAX_flt;
+}
+
+int32 FDepositTerrainRaster::GetCellIndex(const FVector& Location) const
+{
+    const int32 X = FMath::Clamp(FMath::FloorToInt((Location.X - Bounds.Min.X) / CellSize), 0, Width - 1);
+    const int32 Y = FMath::Clamp(FMath::FloorToInt((Location.Y - Bounds.Min.Y) / CellSize), 0, Height - 1);
+    return Y * Width + X;
+}
+
+float FDepositTerrainRaster::GetCellHeight(int32 X, int32 Y) const
+{
+    return Heights[FMath::Clamp(Y, 0, Height - 1) * Width + FMath::Clamp(X, 0, Width - 1)];
+}
+
+void FDepositTerrainRaster::ComputeSlopes()
+{
+    Slopes.SetNumUninitialized(Width * Height);
+
+    for (int32 Y = 0; Y < Height; ++Y)
+    {
+        for (int32 X = 0; X < Width; ++X)
+        {
+            // Różnice centralne (jednostronne na brzegach dzięki clampowi)
+            const int32 Left = FMath::Max(X - 1, 0);
+            const int32 Right = FMath::Min(X + 1, Width - 1);
+            const int32 Down = FMath::Max(Y - 1, 0);
+            const int32 Up = FMath::Min(Y + 1, Height - 1);
+
+            const float GradientX = (Right > Left) ? (GetCellHeight(Right, Y) - GetCellHeight(Left, Y)) / ((Right - Left) * CellSize) : 0.0f;
+            const float GradientY = (Up > Down) ? (GetCellHeight(X, Up) - GetCellHeight(X, Down)) / ((Up - Down) * CellSize) : 0.0f;
+
+            Slopes[Y * Width + X] = FMath::RadiansToDegrees(FMath::Atan(FMath::Sqrt(FMath::Square(GradientX) + FMath::Square(GradientY))));
+        }
+    }
+}
+
+void FDepositTerrainRaster::ComputeDistanceToWater()
+{
+    const int32 NumCells = Width * Height;
+    WaterDistances.SetNumUninitialized(NumCells);
+
+    bool bHasWater = false;
+    for (int32 CellIndex = 0; CellIndex < NumCells; ++CellIndex)
+    {
+        WaterDistances[CellIndex] = WaterCells[CellIndex] ? 0.0f : MAX_flt;
+        bHasWater |= WaterCells[CellIndex] != 0;
+    }
+
+    if (!bHasWater)
+    {
+        return;
+    }
+
+    // Chamfer 3x3 (1, sqrt 2): przebieg w przód i w tył, w jednostkach komórek
+    const auto Relax = [this](int32 CellIndex, int32 X, int32 Y, float Cost)
+    {
+        if (X >= 0 && X < Width && Y >= 0 && Y < Height)
+        {
+            WaterDistances[CellIndex] = FMath::Min(WaterDistances[CellIndex], WaterDistances[Y * Width + X] + Cost);
+        }
+    };
+
+    for (int32 Y = 0; Y < Height; ++Y)
+    {
+        for (int32 X = 0; X < Width; ++X)
+        {
+            const int32 CellIndex = Y * Width + X;
+            Relax(CellIndex, X - 1, Y, 1.0f);
+            Relax(CellIndex, X - 1, Y - 1, UE_SQRT_2);
+            Relax(CellIndex, X, Y - 1, 1.0f);
+            Relax(CellIndex, X + 1, Y - 1, UE_SQRT_2);
+        }
+    }
+
+    for (int32 Y = Height - 1; Y >= 0; --Y)
+    {
+        for (int32 X = Width - 1; X >= 0; --X)
+        {
+            const int32 CellIndex = Y * Width + X;
+            Relax(CellIndex, X + 1, Y, 1.0f);
+            Relax(CellIndex, X + 1, Y + 1, UE_SQRT_2);
+            Relax(CellIndex, X, Y + 1, 1.0f);
+            Relax(CellIndex, X - 1, Y + 1, UE_SQRT_2);
+        }
+    }
+
+    for (float& Distance : WaterDistances)
+    {
+        Distance *= CellSize;
+    }
+}
+
+void FDepositTerrainRaster::ClassifyCells(const FDepositTerrainClassification& Classification)
+{
+    const int32 NumCells = Width * Height;
+    TerrainTypes.SetNumUninitialized(NumCells);
+
+    // Las i pustynia wymagają danych o roślinności / materiałach - z samej geometrii ich nie rozpoznamy
+    for (int32 CellIndex = 0; CellIndex < NumCells; ++CellIndex)
+    {
+        ETerrainType TerrainType = ETerrainType::Plains;
+
+        if (WaterCells[CellIndex])
+        {
+            TerrainType = ETerrainType::Wetlands;
+        }
+        else if (WaterDistances[CellIndex] <= Classification.CoastlineDistance)
+        {
+            TerrainType = ETerrainType::Coastline;
+        }
+        else if (Slopes[CellIndex] >= Classification.MountainSlopeDegrees || Heights[CellIndex] >= Classification.MountainElevation)
+        {
+            TerrainType = ETerrainType::Mountains;
+        }
+        else if (Slopes[CellIndex] >= Classification.HillSlopeDegrees || Heights[CellIndex] >= Classification.HillElevation)
+        {
+            TerrainType = ETerrainType::Hills;
+        }
+
+        TerrainTypes[CellIndex] = static_cast<uint8>(TerrainType);
+    }
+}
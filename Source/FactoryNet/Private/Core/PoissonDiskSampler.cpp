@@ -0,0 +1,119 @@
+// PoissonDiskSampler.cpp
+// Lokalizacja: Source/FactoryNet/Private/Core/PoissonDiskSampler.cpp
+
+#include "Core/PoissonDiskSampler.h"
+
+namespace
+{
+    const auto AcceptAllPoints = [](const FVector2D&) { return true; };
+}
+
+FPoissonDiskSampler::FPoissonDiskSampler(const FBox2D& InBounds, float InRadius, int32 InCandidatesPerSample)
+    : Bounds(InBounds)
+    , Radius(FMath::Max(InRadius, 1.0f))
+    , CellSize(FMath::Max(InRadius, 1.0f) / UE_SQRT_2)
+    , CandidatesPerSample(FMath::Max(InCandidatesPerSample, 1))
+    , GridWidth(0)
+    , GridHeight(0)
+{
+    if (Bounds.bIsValid)
+    {
+        const FVector2D Size = Bounds.GetSize();
+        GridWidth = FMath::Max(1, FMath::CeilToInt(Size.X / CellSize));
+        GridHeight = FMath::Max(1, FMath::CeilToInt(Size.Y / CellSize));
+    }
+}
+
+void FPoissonDiskSampler::Generate(FRandomStream& RandomStream, TArray<FVector2D>& OutSamples) const
+{
+    Generate(RandomStream, OutSamples, AcceptAllPoints);
+}
+
+void FPoissonDiskSampler::Generate(FRandomStream& RandomStream, TArray<FVector2D>& OutSamples, TFunctionRef<bool(const FVector2D&)> Filter) const
+{
+    if (GridWidth == 0 || GridHeight == 0)
+    {
+        return;
+    }
+
+    // Indeksy próbek lokalnych (nie OutSamples - ten może już coś zawierać)
+    TArray<FVector2D> Samples;
+    TArray<int32> Grid;
+    Grid.Init(INDEX_NONE, GridWidth * GridHeight);
+    TArray<int32> ActiveList;
+
+    const auto TryAddSample = [&](const FVector2D& Point)
+    {
+        if (!Bounds.IsInside(Point) || !IsFarFromSamples(Point, Grid, Samples) || !Filter(Point))
+        {
+            return false;
+        }
+
+        const int32 SampleIndex = Samples.Add(Point);
+        const FIntPoint Cell = GetCellCoord(Point);
+        Grid[Cell.Y * GridWidth + Cell.X] = SampleIndex;
+        ActiveList.Add(SampleIndex);
+        return true;
+    };
+
+    // Filtr może zasłaniać część obszaru - kilka losowych startów zamiast jednego
+    for (int32 SeedAttempt = 0; SeedAttempt < CandidatesPerSample; ++SeedAttempt)
+    {
+        const FVector2D SeedPoint(RandomStream.FRandRange(Bounds.Min.X, Bounds.Max.X), RandomStream.FRandRange(Bounds.Min.Y, Bounds.Max.Y));
+        if (!TryAddSample(SeedPoint))
+        {
+            continue;
+        }
+
+        while (ActiveList.Num() > 0)
+        {
+            const int32 ActiveIndex = RandomStream.RandHelper(ActiveList.Num());
+            const FVector2D Origin = Samples[ActiveList[ActiveIndex]];
+
+            bool bFoundCandidate = false;
+            for (int32 Attempt = 0; Attempt < CandidatesPerSample && !bFoundCandidate; ++Attempt)
+            {
+                // Pierścień [r, 2r] wokół aktywnej próbki
+                const float Angle = RandomStream.FRandRange(0.0f, UE_TWO_PI);
+                const float Distance = RandomStream.FRandRange(Radius, 2.0f * Radius);
+                bFoundCandidate = TryAddSample(Origin + FVector2D(FMath::Cos(Angle), FMath::Sin(Angle)) * Distance);
+            }
+
+            if (!bFoundCandidate)
+            {
+                ActiveList.RemoveAtSwap(ActiveIndex, 1, EAllowShrinking::No);
+            }
+        }
+    }
+
+    OutSamples.Append(Samples);
+}
+
+FIntPoint FPoissonDiskSampler::GetCellCoord(const FVector2D& Point) const
+{
+    const FVector2D Local = (Point - Bounds.Min) / CellSize;
+    return FIntPoint(
+        FMath::Clamp(FMath::FloorToInt(Local.X), 0, GridWidth - 1),
+        FMath::Clamp(FMath::FloorToInt(Local.Y), 0, GridHeight - 1));
+}
+
+bool FPoissonDiskSampler::IsFarFromSamples(const FVector2D& Point, const TArray<int32>& Grid, const TArray<FVector2D>& Samples) const
+{
+    // Komórka r/sqrt(2) mieści najwyżej jedną próbkę, więc wystarczy blok 5x5
+    const FIntPoint Cell = GetCellCoord(Point);
+    const float RadiusSquared = FMath::Square(Radius);
+
+    for (int32 CellY = FMath::Max(Cell.Y - 2, 0); CellY <= FMath::Min(Cell.Y + 2, GridHeight - 1); ++CellY)
+    {
+        for (int32 CellX = FMath::Max(Cell.X - 2, 0); CellX <= FMath::Min(Cell.X + 2, GridWidth - 1); ++CellX)
+        {
+            const int32 SampleIndex = Grid[CellY * GridWidth + CellX];
+            if (SampleIndex != INDEX_NONE && FVector2D::DistSquared(Samples[SampleIndex], Point) < RadiusSquared)
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,258 @@
+// ProductionChainSolver.cpp
+// Lokalizacja: Source/FactoryNet/Private/Core/ProductionChainSolver.cpp
+
+#include "Core/ProductionChainSolver.h"
+
+namespace
+{
+    // Grupa poniżej (1 - epsilon) pojemności jest uznana za ograniczoną
+    constexpr double FullCapacityTolerance = 1.0e-6;
+
+    // Po tylu iteracjach zmiany są tłumione - rozbija oscylacje w cyklach receptur
+    constexpr int32 UndampedIterations = 32;
+
+    constexpr double Unlimited = TNumericLimits<double>::Max();
+}
+
+int32 FProductionChainSolver::AddResource(const FDataTableRowHandle& ResourceReference)
+{
+    if (const int32* ExistingIndex = ResourceIndexByReference.Find(ResourceReference))
+    {
+        return *ExistingIndex;
+    }
+
+    const int32 ResourceIndex = Resources.Add(ResourceReference);
+    Supplies.Add(0.0);
+    ResourceIndexByReference.Add(ResourceReference, ResourceIndex);
+    return ResourceIndex;
+}
+
+void FProductionChainSolver::AddSupply(int32 ResourceIndex, double RatePerSecond)
+{
+    if (Supplies.IsValidIndex(ResourceIndex))
+    {
+        Supplies[ResourceIndex] += FMath::Max(0.0, RatePerSecond);
+    }
+}
+
+int32 FProductionChainSolver::AddGroup(double CapacityCyclesPerSecond, int32 OutputResourceIndex, double OutputPerCycle)
+{
+    FGroup& Group = Groups.AddDefaulted_GetRef();
+    Group.Capacity = FMath::Max(0.0, CapacityCyclesPerSecond);
+    Group.OutputResourceIndex = Resources.IsValidIndex(OutputResourceIndex) ? OutputResourceIndex : INDEX_NONE;
+    Group.OutputPerCycle = FMath::Max(0.0, OutputPerCycle);
+    return Groups.Num() - 1;
+}
+
+void FProductionChainSolver::AddGroupInput(int32 GroupIndex, int32 ResourceIndex, double AmountPerCycle)
+{
+    if (Groups.IsValidIndex(GroupIndex) && Resources.IsValidIndex(ResourceIndex) && AmountPerCycle > 0.0)
+    {
+        Groups[GroupIndex].Inputs.Add({ ResourceIndex, AmountPerCycle });
+    }
+}
+
+bool FProductionChainSolver::Solve(FProductionChainSolution& OutSolution, int32 MaxIterations, double Tolerance)
+{
+    const int32 NumGroups = Groups.Num();
+    const int32 NumResources = Resources.Num();
+
+    // Krawędzie wejść spłaszczone: EdgeOffsets[Group] .. EdgeOffsets[Group + 1]
+    TArray<int32> EdgeOffsets;
+    EdgeOffsets.SetNumUninitialized(NumGroups + 1);
+    int32 NumEdges = 0;
+    for (int32 GroupIndex = 0; GroupIndex < NumGroups; ++GroupIndex)
+    {
+        EdgeOffsets[GroupIndex] = NumEdges;
+        NumEdges += Groups[GroupIndex].Inputs.Num();
+    }
+    EdgeOffsets[NumGroups] = NumEdges;
+
+    TArray<TArray<int32>> ConsumerEdgesByResource;
+    TArray<double> EdgeAmounts;
+    ConsumerEdgesByResource.SetNum(NumResources);
+    EdgeAmounts.SetNumUninitialized(NumEdges);
+    for (int32 GroupIndex = 0; GroupIndex < NumGroups; ++GroupIndex)
+    {
+        for (int32 InputIndex = 0; InputIndex < Groups[GroupIndex].Inputs.Num(); ++InputIndex)
+        {
+            const int32 Edge = EdgeOffsets[GroupIndex] + InputIndex;
+            const FGroupInput& Input = Groups[GroupIndex].Inputs[InputIndex];
+            EdgeAmounts[Edge] = Input.AmountPerCycle;
+            ConsumerEdgesByResource[Input.ResourceIndex].Add(Edge);
+        }
+    }
+
+    // Start optymistyczny: wszystko na pełnej mocy, żadne wejście nie ogranicza
+    TArray<double> Rates;
+    TArray<double> NewRates;
+    TArray<double> Available;
+    TArray<double> AllowedRates;    // cycles/s the edge's share of its resource allows
+    TArray<double> OtherLimits;     // cycles/s allowed by capacity and the group's other inputs
+    Rates.SetNumUninitialized(NumGroups);
+    NewRates.SetNumUninitialized(NumGroups);
+    AllowedRates.Init(Unlimited, NumEdges);
+    OtherLimits.SetNumUninitialized(NumEdges);
+    for (int32 GroupIndex = 0; GroupIndex < NumGroups; ++GroupIndex)
+    {
+        Rates[GroupIndex] = Groups[GroupIndex].Capacity;
+    }
+
+    OutSolution.bConverged = false;
+    OutSolution.Iterations = 0;
+
+    for (int32 Iteration = 1; Iteration <= MaxIterations; ++Iteration)
+    {
+        OutSolution.Iterations = Iteration;
+        ComputeAvailability(Rates, Available);
+
+        // Limit z pozostałych wejść: min i drugie min na grupę - O(wejść)
+        for (int32 GroupIndex = 0; GroupIndex < NumGroups; ++GroupIndex)
+        {
+            double FirstMin = Unlimited;
+            double SecondMin = Unlimited;
+            int32 FirstMinEdge = INDEX_NONE;
+            for (int32 Edge = EdgeOffsets[GroupIndex]; Edge < EdgeOffsets[GroupIndex + 1]; ++Edge)
+            {
+                if (AllowedRates[Edge] < FirstMin)
+                {
+                    SecondMin = FirstMin;
+                    FirstMin = AllowedRates[Edge];
+                    FirstMinEdge = Edge;
+                }
+                else if (AllowedRates[Edge] < SecondMin)
+                {
+                    SecondMin = AllowedRates[Edge];
+                }
+            }
+
+            for (int32 Edge = EdgeOffsets[GroupIndex]; Edge < EdgeOffsets[GroupIndex + 1]; ++Edge)
+            {
+                OtherLimits[Edge] = FMath::Min(Groups[GroupIndex].Capacity, Edge == FirstMinEdge ? SecondMin : FirstMin);
+            }
+        }
+
+        // Podział zasobu proporcjonalnie do tego, co konsumenci faktycznie mogą zużyć
+        for (int32 ResourceIndex = 0; ResourceIndex < NumResources; ++ResourceIndex)
+        {
+            const TArray<int32>& ConsumerEdges = ConsumerEdgesByResource[ResourceIndex];
+
+            double TotalDemand = 0.0;
+            for (const int32 Edge : ConsumerEdges)
+            {
+                TotalDemand += EdgeAmounts[Edge] * OtherLimits[Edge];
+            }
+
+            const bool bSufficient = TotalDemand <= Available[ResourceIndex] * (1.0 + FullCapacityTolerance);
+            const double Scale = bSufficient ? 1.0 : Available[ResourceIndex] / TotalDemand;
+            for (const int32 Edge : ConsumerEdges)
+            {
+                AllowedRates[Edge] = bSufficient ? Unlimited : OtherLimits[Edge] * Scale;
+            }
+        }
+
+        double MaxRelativeChange = 0.0;
+        for (int32 GroupIndex = 0; GroupIndex < NumGroups; ++GroupIndex)
+        {
+            double NewRate = Groups[GroupIndex].Capacity;
+            for (int32 Edge = EdgeOffsets[GroupIndex]; Edge < EdgeOffsets[GroupIndex + 1]; ++Edge)
+            {
+                NewRate = FMath::Min(NewRate, AllowedRates[Edge]);
+            }
+
+            if (Iteration > UndampedIterations)
+            {
+                NewRate = 0.5 * (NewRate + Rates[GroupIndex]);
+            }
+
+            NewRates[GroupIndex] = NewRate;
+            MaxRelativeChange = FMath::Max(MaxRelativeChange,
+                FMath::Abs(NewRate - Rates[GroupIndex]) / FMath::Max(Groups[GroupIndex].Capacity, UE_DOUBLE_SMALL_NUMBER));
+        }
+
+        Swap(Rates, NewRates);
+        if (MaxRelativeChange <= Tolerance)
+        {
+            OutSolution.bConverged = true;
+            break;
+        }
+    }
+
+    // === RESULTS ===
+    ComputeAvailability(Rates, Available);
+
+    TArray<double> Consumed;
+    TArray<double> PotentialDemand;
+    TArray<bool> LimitsConsumer;
+    Consumed.SetNumZeroed(NumResources);
+    PotentialDemand.SetNumZeroed(NumResources);
+    LimitsConsumer.SetNumZeroed(NumResources);
+
+    OutSolution.Groups.SetNum(NumGroups);
+    for (int32 GroupIndex = 0; GroupIndex < NumGroups; ++GroupIndex)
+    {
+        const FGroup& Group = Groups[GroupIndex];
+        FProductionChainGroupResult& Result = OutSolution.Groups[GroupIndex];
+        Result.CapacityCyclesPerSecond = static_cast<float>(Group.Capacity);
+        Result.CyclesPerSecond = static_cast<float>(Rates[GroupIndex]);
+        Result.Utilization = Group.Capacity > 0.0 ? static_cast<float>(Rates[GroupIndex] / Group.Capacity) : 0.0f;
+        Result.LimitingResource = FDataTableRowHandle();
+        Result.bIsBottleneck = false;
+
+        int32 LimitingEdge = INDEX_NONE;
+        for (int32 Edge = EdgeOffsets[GroupIndex]; Edge < EdgeOffsets[GroupIndex + 1]; ++Edge)
+        {
+            const int32 ResourceIndex = Group.Inputs[Edge - EdgeOffsets[GroupIndex]].ResourceIndex;
+            Consumed[ResourceIndex] += EdgeAmounts[Edge] * Rates[GroupIndex];
+            PotentialDemand[ResourceIndex] += EdgeAmounts[Edge] * Group.Capacity;
+
+            if (LimitingEdge == INDEX_NONE || AllowedRates[Edge] < AllowedRates[LimitingEdge])
+            {
+                LimitingEdge = Edge;
+            }
+        }
+
+        if (LimitingEdge != INDEX_NONE && Rates[GroupIndex] < Group.Capacity * (1.0 - FullCapacityTolerance))
+        {
+            const int32 ResourceIndex = Group.Inputs[LimitingEdge - EdgeOffsets[GroupIndex]].ResourceIndex;
+            Result.LimitingResource = Resources[ResourceIndex];
+            LimitsConsumer[ResourceIndex] = true;
+        }
+    }
+
+    // Wąskie gardło: pełna moc, a mimo to jej produkt ogranicza kogoś dalej w łańcuchu
+    for (int32 GroupIndex = 0; GroupIndex < NumGroups; ++GroupIndex)
+    {
+        const FGroup& Group = Groups[GroupIndex];
+        OutSolution.Groups[GroupIndex].bIsBottleneck = Group.Capacity > 0.0
+            && Group.OutputResourceIndex != INDEX_NONE
+            && LimitsConsumer[Group.OutputResourceIndex]
+            && Rates[GroupIndex] >= Group.Capacity * (1.0 - FullCapacityTolerance);
+    }
+
+    OutSolution.Resources.SetNum(NumResources);
+    for (int32 ResourceIndex = 0; ResourceIndex < NumResources; ++ResourceIndex)
+    {
+        FProductionChainResourceResult& Result = OutSolution.Resources[ResourceIndex];
+        Result.ResourceReference = Resources[ResourceIndex];
+        Result.ProducedPerSecond = static_cast<float>(Available[ResourceIndex]);
+        Result.ConsumedPerSecond = static_cast<float>(Consumed[ResourceIndex]);
+        Result.SurplusPerSecond = static_cast<float>(FMath::Max(0.0, Available[ResourceIndex] - Consumed[ResourceIndex]));
+        Result.DeficitPerSecond = static_cast<float>(FMath::Max(0.0, PotentialDemand[ResourceIndex] - Available[ResourceIndex]));
+    }
+
+    return OutSolution.bConverged;
+}
+
+void FProductionChainSolver::ComputeAvailability(const TArray<double>& Rates, TArray<double>& OutAvailable) const
+{
+    OutAvailable = Supplies;
+    for (int32 GroupIndex = 0; GroupIndex < Groups.Num(); ++GroupIndex)
+    {
+        const FGroup& Group = Groups[GroupIndex];
+        if (Group.OutputResourceIndex != INDEX_NONE)
+        {
+            OutAvailable[Group.OutputResourceIndex] += Group.OutputPerCycle * Rates[GroupIndex];
+        }
+    }
+}
@@ -0,0 +1,1114 @@
+// ProductionManager.cpp
+// Lokalizacja: Source/FactoryNet/Private/Core/ProductionManager.cpp
+
+#include "Core/ProductionManager.h"
+#include "Core/DataTableManager.h"
+#include "Data/FactoryDefinition.h"
+#include "Data/ProductionData.h"
+#include "Components/ResourceStorageComponent.h"
+#include "Engine/World.h"
+#include "Engine/GameInstance.h"
+#include "Async/ParallelFor.h"
+
+namespace
+{
+    // Upper bound for very short recipes (ProductionTime << step) - keeps one step O(1) per factory
+    constexpr int32 MaxCyclesPerStep = 16;
+}
+
+UProductionManager::UProductionManager()
+{
+    DataTableManager = nullptr;
+}
+
+void UProductionManager::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    if (UWorld* World = GetWorld())
+    {
+        if (UGameInstance* GameInstance = World->GetGameInstance())
+        {
+            DataTableManager = GameInstance->GetSubsystem<UDataTableManager>();
+        }
+    }
+
+    if (!DataTableManager)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ProductionManager: DataTableManager not available - recipes cannot be assigned"));
+    }
+
+    StepAccumulator = 0.0;
+}
+
+void UProductionManager::Deinitialize()
+{
+    for (TPair<const UResourceStorageComponent*, FStorageSubscription>& Pair : StorageSubscriptions)
+    {
+        if (UResourceStorageComponent* Storage = Pair.Value.Storage.Get())
+        {
+            Storage->OnStorageContentsChanged.Remove(Pair.Value.Handle);
+        }
+    }
+
+    Definitions.Empty();
+    FactoryIds.Empty();
+    Levels.Empty();
+    RecipeIndices.Empty();
+    SpeedMultipliers.Empty();
+    EnergyMultipliers.Empty();
+    Progress.Empty();
+    CycleActive.Empty();
+    InputAmounts.Empty();
+    OutputAmounts.Empty();
+    MaxInputStorage.Empty();
+    MaxOutputStorage.Empty();
+    Statuses.Empty();
+    InputStorages.Empty();
+    OutputStorages.Empty();
+    WaitingOnStorage.Empty();
+    WaitingOnResource.Empty();
+    WaitingForOutput.Empty();
+    NumActiveSlots = 0;
+
+    StorageSubscriptions.Empty();
+    PendingWakes.Empty();
+    PendingOutputWakes.Empty();
+
+    SlotByFactoryId.Empty();
+    FreeFactoryIds.Empty();
+    Recipes.Empty();
+    RecipeIndexByReference.Empty();
+    DataTableManager = nullptr;
+
+    Super::Deinitialize();
+}
+
+TStatId UProductionManager::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UProductionManager, STATGROUP_Tickables);
+}
+
+// === TICK ===
+void UProductionManager::Tick(float DeltaTime)
+{
+    LastCompletedCycleCount = 0;
+    LastEnergyUsage = 0.0f;
+
+    // Symulacja tylko na serwerze / w grze single-player - klienci dostają stan z replikacji
+    const UWorld* World = GetWorld();
+    if (!World || World->GetNetMode() == NM_Client)
+    {
+        return;
+    }
+
+    // Fabryki czekające na zmienione magazyny - przed krokiem, żeby obudzone od razu produkowały
+    ProcessPendingWakes();
+
+    StepAccumulator += DeltaTime;
+
+    int32 NumSteps = 0;
+    while (StepAccumulator >= FixedStepSeconds && NumSteps < MaxStepsPerTick)
+    {
+        SimulateStep(FixedStepSeconds);
+        StepAccumulator -= FixedStepSeconds;
+        ++NumSteps;
+    }
+
+    // Po przycince zostaje tylko ułamek kroku - reszta czasu przepada
+    if (StepAccumulator >= FixedStepSeconds)
+    {
+        StepAccumulator = FMath::Fmod(StepAccumulator, static_cast<double>(FixedStepSeconds));
+    }
+}
+
+void UProductionManager::SimulateStep(float StepSeconds)
+{
+    // Tylko aktywne sloty - zaparkowane fabryki nic nie kosztują
+    const int32 NumSlots = NumActiveSlots;
+    if (NumSlots == 0 || StepSeconds <= 0.0f)
+    {
+        return;
+    }
+
+    // Każdy task ma własne sumy i listę do zaparkowania - redukcja po ParallelFor, bez atomików
+    const int32 NumTasks = FMath::DivideAndRoundUp(NumSlots, SlotsPerTask);
+    TArray<int32, TInlineAllocator<64>> TaskCompletedCycles;
+    TArray<double, TInlineAllocator<64>> TaskEnergy;
+    TArray<TArray<int32>, TInlineAllocator<64>> TaskSlotsToPark;
+    TaskCompletedCycles.SetNumZeroed(NumTasks);
+    TaskEnergy.SetNumZeroed(NumTasks);
+    TaskSlotsToPark.SetNum(NumTasks);
+
+    ParallelFor(NumTasks, [&](int32 TaskIndex)
+    {
+        const int32 FirstSlot = TaskIndex * SlotsPerTask;
+        const int32 EndSlot = FMath::Min(FirstSlot + SlotsPerTask, NumSlots);
+        SimulateRange(FirstSlot, EndSlot, StepSeconds, TaskCompletedCycles[TaskIndex], TaskEnergy[TaskIndex], TaskSlotsToPark[TaskIndex]);
+    }, NumTasks == 1 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+    double StepEnergy = 0.0;
+    TArray<int32> FactoriesToPark;
+    for (int32 TaskIndex = 0; TaskIndex < NumTasks; ++TaskIndex)
+    {
+        LastCompletedCycleCount += TaskCompletedCycles[TaskIndex];
+        StepEnergy += TaskEnergy[TaskIndex];
+
+        for (const int32 Slot : TaskSlotsToPark[TaskIndex])
+        {
+            FactoriesToPark.Add(FactoryIds[Slot]);
+        }
+    }
+    LastEnergyUsage += static_cast<float>(StepEnergy);
+
+    // Po ID, nie po slocie - parkowanie i eventy magazynów przesuwają sloty
+    for (const int32 FactoryId : FactoriesToPark)
+    {
+        const int32 Slot = GetSlot(FactoryId);
+        if (Slot != INDEX_NONE && Slot < NumActiveSlots && !TryResolveWait(Slot))
+        {
+            ParkSlot(Slot);
+        }
+    }
+}
+
+// === FACTORIES ===
+int32 UProductionManager::AddFactory(UFactoryDefinition* FactoryDefinition, int32 Level)
+{
+    if (!FactoryDefinition)
+    {
+        UE_LOG(LogTemp, Error, TEXT("ProductionManager: Cannot add factory with null FactoryDefinition"));
+        return INDEX_NONE;
+    }
+
+    const int32 FactoryId = FreeFactoryIds.Num() > 0 ? FreeFactoryIds.Pop(EAllowShrinking::No) : SlotByFactoryId.Add(INDEX_NONE);
+
+    const int32 Slot = Definitions.Add(FactoryDefinition);
+    FactoryIds.Add(FactoryId);
+    Levels.Add(FMath::Clamp(Level, 1, FMath::Max(1, FactoryDefinition->MaxLevel)));
+    RecipeIndices.Add(INDEX_NONE);
+    SpeedMultipliers.Add(1.0f);
+    EnergyMultipliers.Add(1.0f);
+    Progress.Add(0.0f);
+    CycleActive.Add(0);
+    InputAmounts.AddZeroed(MaxRecipeInputs);
+    OutputAmounts.Add(0);
+    MaxInputStorage.Add(0);
+    MaxOutputStorage.Add(0);
+    Statuses.Add(EFactoryProductionStatus::Idle);
+    InputStorages.AddDefaulted();
+    OutputStorages.AddDefaulted();
+    WaitingOnStorage.Add(nullptr);
+    WaitingOnResource.Add(NAME_None);
+    WaitingForOutput.Add(0);
+    SlotByFactoryId[FactoryId] = Slot;
+
+    // Nowa fabryka bez receptury startuje zaparkowana (za granicą aktywnych slotów)
+    ApplyLevel(Slot);
+    return FactoryId;
+}
+
+bool UProductionManager::RemoveFactory(int32 FactoryId)
+{
+    int32 Slot = GetSlot(FactoryId);
+    if (Slot == INDEX_NONE)
+    {
+        return false;
+    }
+
+    RemoveFromWaitQueue(Slot);
+    UnsubscribeStorage(InputStorages[Slot].Get());
+    UnsubscribeStorage(OutputStorages[Slot].Get());
+
+    // Najpierw poza aktywny zakres, potem swap z ostatnim slotem
+    if (Slot < NumActiveSlots)
+    {
+        SwapSlots(Slot, NumActiveSlots - 1);
+        --NumActiveSlots;
+        Slot = NumActiveSlots;
+    }
+
+    const int32 LastSlot = Definitions.Num() - 1;
+    SwapSlots(Slot, LastSlot);
+
+    Definitions.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+    FactoryIds.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+    Levels.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+    RecipeIndices.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+    SpeedMultipliers.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+    EnergyMultipliers.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+    Progress.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+    CycleActive.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+    InputAmounts.RemoveAt(LastSlot * MaxRecipeInputs, MaxRecipeInputs, EAllowShrinking::No);
+    OutputAmounts.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+    MaxInputStorage.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+    MaxOutputStorage.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+    Statuses.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+    InputStorages.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+    OutputStorages.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+    WaitingOnStorage.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+    WaitingOnResource.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+    WaitingForOutput.RemoveAt(LastSlot, 1, EAllowShrinking::No);
+
+    SlotByFactoryId[FactoryId] = INDEX_NONE;
+    FreeFactoryIds.Add(FactoryId);
+    return true;
+}
+
+bool UProductionManager::SetFactoryRecipe(int32 FactoryId, const FDataTableRowHandle& RecipeReference)
+{
+    const int32 Slot = GetSlot(FactoryId);
+    if (Slot == INDEX_NONE)
+    {
+        return false;
+    }
+
+    // Pusty handle = fabryka bez receptury (zaparkuje się w następnym kroku)
+    if (RecipeReference.IsNull())
+    {
+        RemoveFromWaitQueue(Slot);
+        RecipeIndices[Slot] = INDEX_NONE;
+        ResetProduction(Slot);
+        return true;
+    }
+
+    const UFactoryDefinition* FactoryDefinition = Definitions[Slot];
+    if (FactoryDefinition->SupportedRecipes.Num() > 0 && !FactoryDefinition->SupportedRecipes.Contains(RecipeReference))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ProductionManager: Recipe %s is not supported by %s"),
+            *RecipeReference.RowName.ToString(), *FactoryDefinition->FactoryName.ToString());
+        return false;
+    }
+
+    const int32 RecipeIndex = FindOrCompileRecipe(RecipeReference);
+    if (RecipeIndex == INDEX_NONE)
+    {
+        return false;
+    }
+
+    if (Recipes[RecipeIndex].RequiredFactoryLevel > Levels[Slot])
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ProductionManager: Recipe %s requires factory level %d (factory is level %d)"),
+            *RecipeReference.RowName.ToString(), Recipes[RecipeIndex].RequiredFactoryLevel, Levels[Slot]);
+        return false;
+    }
+
+    if (RecipeIndices[Slot] != RecipeIndex)
+    {
+        RecipeIndices[Slot] = RecipeIndex;
+        ResetProduction(Slot);
+    }
+
+    WakeFactory(FactoryId);
+    return true;
+}
+
+bool UProductionManager::SetFactoryLevel(int32 FactoryId, int32 NewLevel)
+{
+    const int32 Slot = GetSlot(FactoryId);
+    if (Slot == INDEX_NONE)
+    {
+        return false;
+    }
+
+    // Bufory powyżej nowej pojemności zostają - po prostu nie da się nic dołożyć
+    Levels[Slot] = FMath::Clamp(NewLevel, 1, FMath::Max(1, Definitions[Slot]->MaxLevel));
+    ApplyLevel(Slot);
+
+    // Po obniżeniu poziomu receptura może wymagać więcej niż fabryka ma - zdejmij ją jak SetFactoryRecipe z pustym handle
+    const int32 RecipeIndex = RecipeIndices[Slot];
+    if (RecipeIndex != INDEX_NONE && Recipes[RecipeIndex].RequiredFactoryLevel > Levels[Slot])
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ProductionManager: Recipe %s requires factory level %d - cleared from %s (now level %d)"),
+            *Recipes[RecipeIndex].RecipeReference.RowName.ToString(), Recipes[RecipeIndex].RequiredFactoryLevel,
+            *Definitions[Slot]->FactoryName.ToString(), Levels[Slot]);
+        RemoveFromWaitQueue(Slot);
+        RecipeIndices[Slot] = INDEX_NONE;
+        ResetProduction(Slot);
+        return true;
+    }
+
+    // Większy magazyn / szybsza produkcja - niech krok sam oceni stan
+    if (RecipeIndices[Slot] != INDEX_NONE)
+    {
+        WakeFactory(FactoryId);
+    }
+    return true;
+}
+
+bool UProductionManager::BindFactoryStorage(int32 FactoryId, UResourceStorageComponent* InputStorage, UResourceStorageComponent* OutputStorage)
+{
+    const int32 Slot = GetSlot(FactoryId);
+    if (Slot == INDEX_NONE)
+    {
+        return false;
+    }
+
+    RemoveFromWaitQueue(Slot);
+    UnsubscribeStorage(InputStorages[Slot].Get());
+    UnsubscribeStorage(OutputStorages[Slot].Get());
+
+    InputStorages[Slot] = InputStorage;
+    OutputStorages[Slot] = OutputStorage;
+    SubscribeStorage(InputStorage);
+    SubscribeStorage(OutputStorage);
+
+    if (RecipeIndices[Slot] != INDEX_NONE)
+    {
+        WakeFactory(FactoryId);
+    }
+    return true;
+}
+
+// === BUFFERS ===
+int32 UProductionManager::AddFactoryInput(int32 FactoryId, const FDataTableRowHandle& ResourceReference, int32 Amount)
+{
+    const int32 Slot = GetSlot(FactoryId);
+    const int32 InputIndex = Slot != INDEX_NONE ? FindInputIndex(Slot, ResourceReference) : INDEX_NONE;
+    if (InputIndex == INDEX_NONE || Amount <= 0)
+    {
+        return 0;
+    }
+
+    int32& Buffer = InputAmounts[Slot * MaxRecipeInputs + InputIndex];
+    const int32 Accepted = FMath::Clamp(MaxInputStorage[Slot] - Buffer, 0, Amount);
+    Buffer += Accepted;
+
+    // Budzimy tylko, gdy brakujące wejścia są już komplet
+    if (Accepted > 0 && Slot >= NumActiveSlots && Statuses[Slot] == EFactoryProductionStatus::StarvedInput && HasAllInputs(Slot))
+    {
+        WakeFactory(FactoryId);
+    }
+    return Accepted;
+}
+
+int32 UProductionManager::TakeFactoryOutput(int32 FactoryId, int32 MaxAmount)
+{
+    const int32 Slot = GetSlot(FactoryId);
+    if (Slot == INDEX_NONE || MaxAmount <= 0)
+    {
+        return 0;
+    }
+
+    const int32 Taken = FMath::Min(OutputAmounts[Slot], MaxAmount);
+    OutputAmounts[Slot] -= Taken;
+
+    if (Taken > 0 && Slot >= NumActiveSlots && Statuses[Slot] == EFactoryProductionStatus::OutputBlocked && HasOutputSpace(Slot))
+    {
+        WakeFactory(FactoryId);
+    }
+    return Taken;
+}
+
+// === QUERIES ===
+bool UProductionManager::IsValidFactory(int32 FactoryId) const
+{
+    return GetSlot(FactoryId) != INDEX_NONE;
+}
+
+EFactoryProductionStatus UProductionManager::GetFactoryStatus(int32 FactoryId) const
+{
+    const int32 Slot = GetSlot(FactoryId);
+    return Slot != INDEX_NONE ? Statuses[Slot] : EFactoryProductionStatus::Idle;
+}
+
+float UProductionManager::GetFactoryProgress(int32 FactoryId) const
+{
+    const int32 Slot = GetSlot(FactoryId);
+    if (Slot == INDEX_NONE || RecipeIndices[Slot] == INDEX_NONE)
+    {
+        return 0.0f;
+    }
+
+    return FMath::Clamp(Progress[Slot] / Recipes[RecipeIndices[Slot]].ProductionTime, 0.0f, 1.0f);
+}
+
+int32 UProductionManager::GetFactoryInputAmount(int32 FactoryId, const FDataTableRowHandle& ResourceReference) const
+{
+    const int32 Slot = GetSlot(FactoryId);
+    const int32 InputIndex = Slot != INDEX_NONE ? FindInputIndex(Slot, ResourceReference) : INDEX_NONE;
+    return InputIndex != INDEX_NONE ? InputAmounts[Slot * MaxRecipeInputs + InputIndex] : 0;
+}
+
+int32 UProductionManager::GetFactoryOutputAmount(int32 FactoryId) const
+{
+    const int32 Slot = GetSlot(FactoryId);
+    return Slot != INDEX_NONE ? OutputAmounts[Slot] : 0;
+}
+
+FDataTableRowHandle UProductionManager::GetFactoryOutputResource(int32 FactoryId) const
+{
+    const int32 Slot = GetSlot(FactoryId);
+    if (Slot == INDEX_NONE || RecipeIndices[Slot] == INDEX_NONE)
+    {
+        return FDataTableRowHandle();
+    }
+
+    return Recipes[RecipeIndices[Slot]].OutputResource;
+}
+
+// === PLANNING ===
+FProductionChainSolution UProductionManager::SolveSteadyState(const TArray<FProductionChainGroup>& Groups, const TArray<FProductionChainSupply>& Supplies)
+{
+    const double StartTime = FPlatformTime::Seconds();
+
+    FProductionChainSolver Solver;
+    for (const FProductionChainSupply& Supply : Supplies)
+    {
+        if (!Supply.ResourceReference.IsNull())
+        {
+            Solver.AddSupply(Solver.AddResource(Supply.ResourceReference), Supply.RatePerSecond);
+        }
+    }
+
+    for (const FProductionChainGroup& Group : Groups)
+    {
+        const int32 RecipeIndex = Group.RecipeReference.IsNull() ? INDEX_NONE : FindOrCompileRecipe(Group.RecipeReference);
+        if (RecipeIndex == INDEX_NONE || !Group.FactoryDefinition)
+        {
+            // Pusta grupa zachowuje kolejność wyników
+            Solver.AddGroup(0.0, INDEX_NONE, 0.0);
+            continue;
+        }
+
+        // Kopia - FindOrCompileRecipe kolejnej grupy może realokować Recipes
+        const FCompiledRecipe Recipe = Recipes[RecipeIndex];
+        const FFactoryLevel LevelData = Group.FactoryDefinition->GetLevelData(Group.Level);
+
+        // Cykle/s całej grupy - ten sam wzór co w SimulateRange (ProductionTime przy prędkości 1.0)
+        const double Capacity = FMath::Max(0, Group.FactoryCount) * FMath::Max(0.0f, LevelData.ProductionSpeedMultiplier) / Recipe.ProductionTime;
+
+        const int32 GroupIndex = Solver.AddGroup(Capacity, Solver.AddResource(Recipe.OutputResource), Recipe.OutputQuantity);
+        for (int32 InputIndex = 0; InputIndex < Recipe.NumInputs; ++InputIndex)
+        {
+            Solver.AddGroupInput(GroupIndex, Solver.AddResource(Recipe.InputResources[InputIndex]), Recipe.InputQuantities[InputIndex]);
+        }
+    }
+
+    FProductionChainSolution Solution;
+    if (!Solver.Solve(Solution))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ProductionManager: Steady state did not converge after %d iterations - rates are approximate"),
+            Solution.Iterations);
+    }
+
+    for (int32 GroupIndex = 0; GroupIndex < Groups.Num(); ++GroupIndex)
+    {
+        Solution.Groups[GroupIndex].Group = Groups[GroupIndex];
+    }
+
+    UE_LOG(LogTemp, Verbose, TEXT("ProductionManager: Solved %d groups / %d resources in %d iterations (%.2f ms)"),
+        Solution.Groups.Num(), Solution.Resources.Num(), Solution.Iterations, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+    return Solution;
+}
+
+FProductionChainSolution UProductionManager::SolveCurrentSteadyState(const TArray<FProductionChainSupply>& Supplies)
+{
+    TArray<FProductionChainGroup> Groups;
+    TMap<TTuple<int32, const UFactoryDefinition*, int32>, int32> GroupIndexByKey;
+
+    for (int32 Slot = 0; Slot < Definitions.Num(); ++Slot)
+    {
+        if (RecipeIndices[Slot] == INDEX_NONE || !Definitions[Slot])
+        {
+            continue;
+        }
+
+        const TTuple<int32, const UFactoryDefinition*, int32> Key(RecipeIndices[Slot], Definitions[Slot], Levels[Slot]);
+        if (const int32* ExistingIndex = GroupIndexByKey.Find(Key))
+        {
+            ++Groups[*ExistingIndex].FactoryCount;
+            continue;
+        }
+
+        FProductionChainGroup& Group = Groups.AddDefaulted_GetRef();
+        Group.RecipeReference = Recipes[RecipeIndices[Slot]].RecipeReference;
+        Group.FactoryDefinition = Definitions[Slot];
+        Group.Level = Levels[Slot];
+        Group.FactoryCount = 1;
+        GroupIndexByKey.Add(Key, Groups.Num() - 1);
+    }
+
+    return SolveSteadyState(Groups, Supplies);
+}
+
+// === CONFIGURATION ===
+void UProductionManager::SetFixedStepRate(float StepsPerSecond)
+{
+    FixedStepSeconds = 1.0f / FMath::Clamp(StepsPerSecond, 1.0f, 240.0f);
+    StepAccumulator = 0.0;
+}
+
+// === PRIVATE FUNCTIONS ===
+int32 UProductionManager::FindOrCompileRecipe(const FDataTableRowHandle& RecipeReference)
+{
+    if (const int32* ExistingIndex = RecipeIndexByReference.Find(RecipeReference))
+    {
+        return *ExistingIndex;
+    }
+
+    FProductionRecipe RecipeRow;
+    if (!DataTableManager || !DataTableManager->GetProductionRecipeByReference(RecipeReference, RecipeRow))
+    {
+        UE_LOG(LogTemp, Error, TEXT("ProductionManager: Recipe %s not found"), *RecipeReference.RowName.ToString());
+        return INDEX_NONE;
+    }
+
+    FCompiledRecipe Recipe;
+    Recipe.RecipeReference = RecipeReference;
+    Recipe.OutputResource = RecipeRow.OutputResourceReference;
+    Recipe.OutputQuantity = FMath::Max(1, RecipeRow.OutputQuantity);
+    Recipe.ProductionTime = FMath::Max(RecipeRow.ProductionTime, KINDA_SMALL_NUMBER);
+    Recipe.EnergyRequired = FMath::Max(0.0f, RecipeRow.EnergyRequired);
+    Recipe.RequiredFactoryLevel = FMath::Max(1, RecipeRow.FactoryLevel);
+
+    for (const FResourceRequirement& Requirement : RecipeRow.InputResources)
+    {
+        if (Requirement.Quantity <= 0 || Requirement.ResourceReference.IsNull())
+        {
+            continue;
+        }
+
+        // Ten sam surowiec dwa razy w recepturze - jeden bufor, suma ilości
+        int32 InputIndex = 0;
+        while (InputIndex < Recipe.NumInputs && !(Recipe.InputResources[InputIndex] == Requirement.ResourceReference))
+        {
+            ++InputIndex;
+        }
+
+        if (InputIndex == Recipe.NumInputs)
+        {
+            if (Recipe.NumInputs == MaxRecipeInputs)
+            {
+                UE_LOG(LogTemp, Error, TEXT("ProductionManager: Recipe %s has more than %d inputs"),
+                    *RecipeReference.RowName.ToString(), MaxRecipeInputs);
+                return INDEX_NONE;
+            }
+
+            Recipe.InputResources[InputIndex] = Requirement.ResourceReference;
+            ++Recipe.NumInputs;
+        }
+
+        Recipe.InputQuantities[InputIndex] += Requirement.Quantity;
+    }
+
+    const int32 RecipeIndex = Recipes.Add(Recipe);
+    RecipeIndexByReference.Add(RecipeReference, RecipeIndex);
+    return RecipeIndex;
+}
+
+int32 UProductionManager::FindInputIndex(int32 Slot, const FDataTableRowHandle& ResourceReference) const
+{
+    if (RecipeIndices[Slot] == INDEX_NONE)
+    {
+        return INDEX_NONE;
+    }
+
+    const FCompiledRecipe& Recipe = Recipes[RecipeIndices[Slot]];
+    for (int32 InputIndex = 0; InputIndex < Recipe.NumInputs; ++InputIndex)
+    {
+        if (Recipe.InputResources[InputIndex] == ResourceReference)
+        {
+            return InputIndex;
+        }
+    }
+
+    return INDEX_NONE;
+}
+
+int32 UProductionManager::GetSlot(int32 FactoryId) const
+{
+    return SlotByFactoryId.IsValidIndex(FactoryId) ? SlotByFactoryId[FactoryId] : INDEX_NONE;
+}
+
+void UProductionManager::ApplyLevel(int32 Slot)
+{
+    const FFactoryLevel LevelData = Definitions[Slot]->GetLevelData(Levels[Slot]);
+    SpeedMultipliers[Slot] = FMath::Max(0.0f, LevelData.ProductionSpeedMultiplier);
+    EnergyMultipliers[Slot] = FMath::Max(0.0f, LevelData.EnergyConsumptionMultiplier);
+    MaxInputStorage[Slot] = FMath::Max(0, LevelData.MaxInputStorage);
+    MaxOutputStorage[Slot] = FMath::Max(0, LevelData.MaxOutputStorage);
+}
+
+void UProductionManager::ResetProduction(int32 Slot)
+{
+    for (int32 InputIndex = 0; InputIndex < MaxRecipeInputs; ++InputIndex)
+    {
+        InputAmounts[Slot * MaxRecipeInputs + InputIndex] = 0;
+    }
+
+    OutputAmounts[Slot] = 0;
+    Progress[Slot] = 0.0f;
+    CycleActive[Slot] = 0;
+    Statuses[Slot] = RecipeIndices[Slot] != INDEX_NONE ? EFactoryProductionStatus::StarvedInput : EFactoryProductionStatus::Idle;
+}
+
+void UProductionManager::SimulateRange(int32 FirstSlot, int32 EndSlot, float StepSeconds, int32& OutCompletedCycles, double& OutEnergy,
+                                       TArray<int32>& OutSlotsToPark)
+{
+    const FCompiledRecipe* RecipeData = Recipes.GetData();
+    const int32* RESTRICT RecipeIndex = RecipeIndices.GetData();
+    const float* RESTRICT Speed = SpeedMultipliers.GetData();
+    const float* RESTRICT EnergyMultiplier = EnergyMultipliers.GetData();
+    const int32* RESTRICT MaxOutput = MaxOutputStorage.GetData();
+    float* RESTRICT CycleProgress = Progress.GetData();
+    uint8* RESTRICT Active = CycleActive.GetData();
+    int32* RESTRICT Inputs = InputAmounts.GetData();
+    int32* RESTRICT Output = OutputAmounts.GetData();
+    EFactoryProductionStatus* RESTRICT Status = Statuses.GetData();
+
+    int32 CompletedCycles = 0;
+    double Energy = 0.0;
+
+    // Tylko liczby - żadnych UObjectów. Slot pisze wyłącznie do własnych wpisów.
+    for (int32 Slot = FirstSlot; Slot < EndSlot; ++Slot)
+    {
+        if (RecipeIndex[Slot] == INDEX_NONE)
+        {
+            Status[Slot] = EFactoryProductionStatus::Idle;
+            OutSlotsToPark.Add(Slot);
+            continue;
+        }
+
+        const FCompiledRecipe& Recipe = RecipeData[RecipeIndex[Slot]];
+        int32* SlotInputs = Inputs + Slot * MaxRecipeInputs;
+        float Budget = StepSeconds * Speed[Slot];
+        EFactoryProductionStatus NewStatus = EFactoryProductionStatus::Producing;
+
+        for (int32 Cycle = 0; Cycle < MaxCyclesPerStep && Budget > 0.0f; ++Cycle)
+        {
+            // Start cyklu - wejścia pobierane z góry
+            if (!Active[Slot])
+            {
+                bool bHasInputs = true;
+                for (int32 InputIndex = 0; InputIndex < Recipe.NumInputs; ++InputIndex)
+                {
+                    bHasInputs &= SlotInputs[InputIndex] >= Recipe.InputQuantities[InputIndex];
+                }
+
+                if (!bHasInputs)
+                {
+                    NewStatus = EFactoryProductionStatus::StarvedInput;
+                    break;
+                }
+
+                for (int32 InputIndex = 0; InputIndex < Recipe.NumInputs; ++InputIndex)
+                {
+                    SlotInputs[InputIndex] -= Recipe.InputQuantities[InputIndex];
+                }
+
+                Active[Slot] = 1;
+                CycleProgress[Slot] = 0.0f;
+                Energy += Recipe.EnergyRequired * EnergyMultiplier[Slot];
+            }
+
+            const float Remaining = Recipe.ProductionTime - CycleProgress[Slot];
+            if (Budget < Remaining)
+            {
+                CycleProgress[Slot] += Budget;
+                break;
+            }
+
+            Budget -= FMath::Max(0.0f, Remaining);
+            CycleProgress[Slot] = Recipe.ProductionTime;
+
+            // Koniec cyklu - gotowy produkt czeka, aż zwolni się miejsce
+            if (Output[Slot] + Recipe.OutputQuantity > MaxOutput[Slot])
+            {
+                NewStatus = EFactoryProductionStatus::OutputBlocked;
+                break;
+            }
+
+            Output[Slot] += Recipe.OutputQuantity;
+            Active[Slot] = 0;
+            CycleProgress[Slot] = 0.0f;
+            ++CompletedCycles;
+        }
+
+        Status[Slot] = NewStatus;
+        if (NewStatus != EFactoryProductionStatus::Producing)
+        {
+            OutSlotsToPark.Add(Slot);
+        }
+    }
+
+    OutCompletedCycles = CompletedCycles;
+    OutEnergy = Energy;
+}
+
+// === SCHEDULING ===
+void UProductionManager::SwapSlots(int32 SlotA, int32 SlotB)
+{
+    if (SlotA == SlotB)
+    {
+        return;
+    }
+
+    Swap(Definitions[SlotA], Definitions[SlotB]);
+    Swap(FactoryIds[SlotA], FactoryIds[SlotB]);
+    Swap(Levels[SlotA], Levels[SlotB]);
+    Swap(RecipeIndices[SlotA], RecipeIndices[SlotB]);
+    Swap(SpeedMultipliers[SlotA], SpeedMultipliers[SlotB]);
+    Swap(EnergyMultipliers[SlotA], EnergyMultipliers[SlotB]);
+    Swap(Progress[SlotA], Progress[SlotB]);
+    Swap(CycleActive[SlotA], CycleActive[SlotB]);
+    for (int32 InputIndex = 0; InputIndex < MaxRecipeInputs; ++InputIndex)
+    {
+        Swap(InputAmounts[SlotA * MaxRecipeInputs + InputIndex], InputAmounts[SlotB * MaxRecipeInputs + InputIndex]);
+    }
+    Swap(OutputAmounts[SlotA], OutputAmounts[SlotB]);
+    Swap(MaxInputStorage[SlotA], MaxInputStorage[SlotB]);
+    Swap(MaxOutputStorage[SlotA], MaxOutputStorage[SlotB]);
+    Swap(Statuses[SlotA], Statuses[SlotB]);
+    Swap(InputStorages[SlotA], InputStorages[SlotB]);
+    Swap(OutputStorages[SlotA], OutputStorages[SlotB]);
+    Swap(WaitingOnStorage[SlotA], WaitingOnStorage[SlotB]);
+    Swap(WaitingOnResource[SlotA], WaitingOnResource[SlotB]);
+    Swap(WaitingForOutput[SlotA], WaitingForOutput[SlotB]);
+
+    SlotByFactoryId[FactoryIds[SlotA]] = SlotA;
+    SlotByFactoryId[FactoryIds[SlotB]] = SlotB;
+}
+
+void UProductionManager::WakeFactory(int32 FactoryId)
+{
+    const int32 Slot = GetSlot(FactoryId);
+    if (Slot == INDEX_NONE || Slot < NumActiveSlots)
+    {
+        return;
+    }
+
+    RemoveFromWaitQueue(Slot);
+    SwapSlots(Slot, NumActiveSlots);
+    ++NumActiveSlots;
+}
+
+void UProductionManager::ParkSlot(int32 Slot)
+{
+    check(Slot < NumActiveSlots);
+
+    SwapSlots(Slot, NumActiveSlots - 1);
+    --NumActiveSlots;
+    EnqueueWait(NumActiveSlots);
+}
+
+bool UProductionManager::TryResolveWait(int32 Slot)
+{
+    switch (Statuses[Slot])
+    {
+    case EFactoryProductionStatus::Producing:
+        return true;
+    case EFactoryProductionStatus::StarvedInput:
+        return PullInputsFromStorage(Slot);
+    case EFactoryProductionStatus::OutputBlocked:
+        return PushOutputToStorage(Slot);
+    default:
+        return false;
+    }
+}
+
+bool UProductionManager::PullInputsFromStorage(int32 Slot)
+{
+    UResourceStorageComponent* Storage = InputStorages[Slot].Get();
+    if (Storage && RecipeIndices[Slot] != INDEX_NONE && !HasAllInputs(Slot))
+    {
+        // Wszystko albo nic - częściowe pobranie zamroziłoby zasoby w buforze fabryki, która i tak nie ruszy
+        const FCompiledRecipe& Recipe = Recipes[RecipeIndices[Slot]];
+        for (int32 InputIndex = 0; InputIndex < Recipe.NumInputs; ++InputIndex)
+        {
+            const int32 Buffer = InputAmounts[Slot * MaxRecipeInputs + InputIndex];
+            if (Buffer < Recipe.InputQuantities[InputIndex]
+                && Buffer + Storage->GetCurrentAmount(Recipe.InputResources[InputIndex]) < Recipe.InputQuantities[InputIndex])
+            {
+                return false;
+            }
+        }
+
+        // Braki uzupełniamy do pełnego bufora - mniej przebudzeń przy kolejnych cyklach
+        for (int32 InputIndex = 0; InputIndex < Recipe.NumInputs; ++InputIndex)
+        {
+            int32& Buffer = InputAmounts[Slot * MaxRecipeInputs + InputIndex];
+            const int32 FreeSpace = MaxInputStorage[Slot] - Buffer;
+            if (Buffer < Recipe.InputQuantities[InputIndex] && FreeSpace > 0)
+            {
+                Buffer += Storage->RemoveResource(Recipe.InputResources[InputIndex], FreeSpace);
+            }
+        }
+    }
+
+    return HasAllInputs(Slot);
+}
+
+bool UProductionManager::PushOutputToStorage(int32 Slot)
+{
+    UResourceStorageComponent* Storage = OutputStorages[Slot].Get();
+    if (Storage && RecipeIndices[Slot] != INDEX_NONE && OutputAmounts[Slot] > 0)
+    {
+        const FDataTableRowHandle& OutputResource = Recipes[RecipeIndices[Slot]].OutputResource;
+        const int32 Amount = FMath::Min(OutputAmounts[Slot], Storage->GetAvailableSpace(OutputResource));
+        if (Amount > 0 && Storage->AddResource(OutputResource, Amount))
+        {
+            OutputAmounts[Slot] -= Amount;
+        }
+    }
+
+    return HasOutputSpace(Slot);
+}
+
+bool UProductionManager::HasAllInputs(int32 Slot) const
+{
+    if (RecipeIndices[Slot] == INDEX_NONE)
+    {
+        return false;
+    }
+
+    // Cykl w toku ma już pobrane wejścia
+    if (CycleActive[Slot])
+    {
+        return true;
+    }
+
+    const FCompiledRecipe& Recipe = Recipes[RecipeIndices[Slot]];
+    for (int32 InputIndex = 0; InputIndex < Recipe.NumInputs; ++InputIndex)
+    {
+        if (InputAmounts[Slot * MaxRecipeInputs + InputIndex] < Recipe.InputQuantities[InputIndex])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool UProductionManager::HasOutputSpace(int32 Slot) const
+{
+    return RecipeIndices[Slot] != INDEX_NONE
+        && OutputAmounts[Slot] + Recipes[RecipeIndices[Slot]].OutputQuantity <= MaxOutputStorage[Slot];
+}
+
+FName UProductionManager::FindMissingInput(int32 Slot) const
+{
+    const FCompiledRecipe& Recipe = Recipes[RecipeIndices[Slot]];
+    const UResourceStorageComponent* Storage = InputStorages[Slot].Get();
+
+    // Pierwsze wejście, którego nie pokrywa bufor razem z magazynem - na nie czekamy
+    FName FirstShortInBuffer = NAME_None;
+    for (int32 InputIndex = 0; InputIndex < Recipe.NumInputs; ++InputIndex)
+    {
+        const int32 Buffer = InputAmounts[Slot * MaxRecipeInputs + InputIndex];
+        if (Buffer >= Recipe.InputQuantities[InputIndex])
+        {
+            continue;
+        }
+
+        const FDataTableRowHandle& Resource = Recipe.InputResources[InputIndex];
+        if (!Storage || Buffer + Storage->GetCurrentAmount(Resource) < Recipe.InputQuantities[InputIndex])
+        {
+            return Resource.RowName;
+        }
+
+        if (FirstShortInBuffer.IsNone())
+        {
+            FirstShortInBuffer = Resource.RowName;
+        }
+    }
+    return FirstShortInBuffer;
+}
+
+void UProductionManager::EnqueueWait(int32 Slot)
+{
+    // Kolejka (magazyn, zasób), na który czekamy; bez magazynu budzi tylko API fabryki
+    const UResourceStorageComponent* Storage = nullptr;
+    FName Resource = NAME_None;
+    const bool bForOutput = Statuses[Slot] == EFactoryProductionStatus::OutputBlocked;
+    if (Statuses[Slot] == EFactoryProductionStatus::StarvedInput)
+    {
+        Storage = InputStorages[Slot].Get();
+        Resource = Storage ? FindMissingInput(Slot) : NAME_None;
+    }
+    else if (bForOutput)
+    {
+        Storage = OutputStorages[Slot].Get();
+        Resource = Recipes[RecipeIndices[Slot]].OutputResource.RowName;
+    }
+
+    FStorageSubscription* Subscription = Storage ? StorageSubscriptions.Find(Storage) : nullptr;
+    if (!Subscription || Resource.IsNone())
+    {
+        return;
+    }
+
+    Subscription->FactoriesWaitingOnResource.FindOrAdd(Resource).Add(FactoryIds[Slot]);
+    Subscription->NumBlockedOutputs += bForOutput ? 1 : 0;
+    WaitingOnStorage[Slot] = Storage;
+    WaitingOnResource[Slot] = Resource;
+    WaitingForOutput[Slot] = bForOutput ? 1 : 0;
+}
+
+void UProductionManager::RemoveFromWaitQueue(int32 Slot)
+{
+    const UResourceStorageComponent* Storage = WaitingOnStorage[Slot];
+    if (!Storage)
+    {
+        return;
+    }
+
+    const FName Resource = WaitingOnResource[Slot];
+    const bool bForOutput = WaitingForOutput[Slot] != 0;
+    WaitingOnStorage[Slot] = nullptr;
+    WaitingOnResource[Slot] = NAME_None;
+    WaitingForOutput[Slot] = 0;
+
+    FStorageSubscription* Subscription = StorageSubscriptions.Find(Storage);
+    if (!Subscription)
+    {
+        return;
+    }
+
+    Subscription->NumBlockedOutputs -= bForOutput ? 1 : 0;
+    if (TArray<int32>* Queue = Subscription->FactoriesWaitingOnResource.Find(Resource))
+    {
+        Queue->RemoveSingleSwap(FactoryIds[Slot], EAllowShrinking::No);
+        if (Queue->Num() == 0)
+        {
+            Subscription->FactoriesWaitingOnResource.Remove(Resource);
+        }
+    }
+}
+
+void UProductionManager::ProcessPendingWakes()
+{
+    if (PendingWakes.Num() == 0 && PendingOutputWakes.Num() == 0)
+    {
+        return;
+    }
+
+    // Pobieranie z magazynów odpala ich eventy - nowe zmiany trafią do następnego Tick
+    const TArray<FStorageWaitKey> ChangedResources = PendingWakes.Array();
+    const TArray<const UResourceStorageComponent*> FreedStorages = PendingOutputWakes.Array();
+    PendingWakes.Reset();
+    PendingOutputWakes.Reset();
+
+    // Kopia ID - WakeFactory i ponowne kolejkowanie zmieniają kolejki
+    TArray<int32> WaitingFactories;
+    for (const FStorageWaitKey& Key : ChangedResources)
+    {
+        const FStorageSubscription* Subscription = StorageSubscriptions.Find(Key.Key);
+        if (!Subscription)
+        {
+            continue;
+        }
+
+        if (Key.Value.IsNone())
+        {
+            for (const TPair<FName, TArray<int32>>& Queue : Subscription->FactoriesWaitingOnResource)
+            {
+                WaitingFactories.Append(Queue.Value);
+            }
+        }
+        else if (const TArray<int32>* Queue = Subscription->FactoriesWaitingOnResource.Find(Key.Value))
+        {
+            WaitingFactories.Append(*Queue);
+        }
+    }
+
+    // Miejsce jest wspólne dla wszystkich zasobów magazynu - zablokowane wyjścia niezależnie od zasobu
+    for (const UResourceStorageComponent* Storage : FreedStorages)
+    {
+        const FStorageSubscription* Subscription = StorageSubscriptions.Find(Storage);
+        if (!Subscription || Subscription->NumBlockedOutputs == 0)
+        {
+            continue;
+        }
+
+        for (const TPair<FName, TArray<int32>>& Queue : Subscription->FactoriesWaitingOnResource)
+        {
+            for (const int32 FactoryId : Queue.Value)
+            {
+                const int32 Slot = GetSlot(FactoryId);
+                if (Slot != INDEX_NONE && WaitingForOutput[Slot])
+                {
+                    WaitingFactories.Add(FactoryId);
+                }
+            }
+        }
+    }
+
+    for (const int32 FactoryId : WaitingFactories)
+    {
+        const int32 Slot = GetSlot(FactoryId);
+        if (Slot == INDEX_NONE || Slot < NumActiveSlots)
+        {
+            continue;
+        }
+
+        if (TryResolveWait(Slot))
+        {
+            WakeFactory(FactoryId);
+        }
+        else
+        {
+            // Teraz może brakować innego wejścia - przenosimy do jego kolejki
+            RemoveFromWaitQueue(Slot);
+            EnqueueWait(Slot);
+        }
+    }
+}
+
+void UProductionManager::SubscribeStorage(UResourceStorageComponent* Storage)
+{
+    if (!Storage)
+    {
+        return;
+    }
+
+    FStorageSubscription& Subscription = StorageSubscriptions.FindOrAdd(Storage);
+    if (Subscription.NumBindings == 0)
+    {
+        Subscription.Storage = Storage;
+        Subscription.Handle = Storage->OnStorageContentsChanged.AddUObject(this, &UProductionManager::HandleStorageChanged);
+    }
+    ++Subscription.NumBindings;
+}
+
+void UProductionManager::UnsubscribeStorage(const UResourceStorageComponent* Storage)
+{
+    FStorageSubscription* Subscription = Storage ? StorageSubscriptions.Find(Storage) : nullptr;
+    if (!Subscription || --Subscription->NumBindings > 0)
+    {
+        return;
+    }
+
+    if (UResourceStorageComponent* BoundStorage = Subscription->Storage.Get())
+    {
+        BoundStorage->OnStorageContentsChanged.Remove(Subscription->Handle);
+    }
+    StorageSubscriptions.Remove(Storage);
+}
+
+void UProductionManager::HandleStorageChanged(UResourceStorageComponent* Storage, const FDataTableRowHandle& ResourceType)
+{
+    // Tylko istniejące kolejki - zmiany pozostałych magazynów i zasobów nic nie kosztują
+    const FStorageSubscription* Subscription = StorageSubscriptions.Find(Storage);
+    if (!Subscription || Subscription->FactoriesWaitingOnResource.Num() == 0)
+    {
+        return;
+    }
+
+    // Pusty zasób = zmiana pojemności albo wielu zasobów naraz
+    if (ResourceType.RowName.IsNone())
+    {
+        PendingWakes.Add(FStorageWaitKey(Storage, NAME_None));
+        return;
+    }
+
+    if (Subscription->FactoriesWaitingOnResource.Contains(ResourceType.RowName))
+    {
+        PendingWakes.Add(FStorageWaitKey(Storage, ResourceType.RowName));
+    }
+
+    if (Subscription->NumBlockedOutputs > 0 && !Storage->IsFull())
+    {
+        PendingOutputWakes.Add(Storage);
+    }
+}
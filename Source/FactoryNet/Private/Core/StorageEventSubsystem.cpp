@@ -0,0 +1,54 @@
+// StorageEventSubsystem.cpp
+// Lokalizacja: Source/FactoryNet/Private/Core/StorageEventSubsystem.cpp
+
+#include "Core/StorageEventSubsystem.h"
+#include "Components/ResourceStorageComponent.h"
+
+void UStorageEventSubsystem::Deinitialize()
+{
+    QueuedStorages.Empty();
+
+    Super::Deinitialize();
+}
+
+TStatId UStorageEventSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UStorageEventSubsystem, STATGROUP_Tickables);
+}
+
+void UStorageEventSubsystem::Tick(float DeltaTime)
+{
+    TimeSinceLastFlush += DeltaTime;
+
+    if (QueuedStorages.Num() == 0 || TimeSinceLastFlush < FlushInterval)
+    {
+        return;
+    }
+
+    FlushNow();
+}
+
+void UStorageEventSubsystem::QueueStorage(UResourceStorageComponent* Storage)
+{
+    if (Storage)
+    {
+        QueuedStorages.Add(Storage);
+    }
+}
+
+void UStorageEventSubsystem::FlushNow()
+{
+    TimeSinceLastFlush = 0.0f;
+
+    // Handlery mogą zmieniać magazyny i kolejkować je ponownie - trafią do następnego flusha
+    TArray<TWeakObjectPtr<UResourceStorageComponent>> StoragesToFlush = MoveTemp(QueuedStorages);
+    QueuedStorages.Reset();
+
+    for (const TWeakObjectPtr<UResourceStorageComponent>& Storage : StoragesToFlush)
+    {
+        if (Storage.IsValid())
+        {
+            Storage->FlushDeferredStorageEvents();
+        }
+    }
+}
@@ -0,0 +1,112 @@
+// TechUnlockSet.cpp
+// Lokalizacja: Source/FactoryNet/Private/Core/TechUnlockSet.cpp
+
+#include "Core/TechUnlockSet.h"
+
+void FTechUnlockSet::Add(int32 TechId)
+{
+    if (TechId < 0)
+    {
+        return;
+    }
+
+    const int32 WordIndex = TechId >> WordShift;
+    if (WordIndex >= Words.Num())
+    {
+        Words.AddZeroed(WordIndex + 1 - Words.Num());
+    }
+
+    Words[WordIndex] |= (1ULL << (TechId & WordMask));
+}
+
+void FTechUnlockSet::Remove(int32 TechId)
+{
+    if (TechId < 0)
+    {
+        return;
+    }
+
+    const int32 WordIndex = TechId >> WordShift;
+    if (Words.IsValidIndex(WordIndex))
+    {
+        Words[WordIndex] &= ~(1ULL << (TechId & WordMask));
+    }
+}
+
+void FTechUnlockSet::Reset()
+{
+    Words.Reset();
+    bHasUnresolvedTechs = false;
+}
+
+void FTechUnlockSet::Append(const FTechUnlockSet& Other)
+{
+    if (Other.Words.Num() > Words.Num())
+    {
+        Words.AddZeroed(Other.Words.Num() - Words.Num());
+    }
+
+    for (int32 WordIndex = 0; WordIndex < Other.Words.Num(); ++WordIndex)
+    {
+        Words[WordIndex] |= Other.Words[WordIndex];
+    }
+
+    bHasUnresolvedTechs |= Other.bHasUnresolvedTechs;
+}
+
+void FTechUnlockSet::GetMissing(const FTechUnlockSet& Required, TArray<int32>& OutMissingTechIds) const
+{
+    OutMissingTechIds.Reset();
+
+    for (int32 WordIndex = 0; WordIndex < Required.Words.Num(); ++WordIndex)
+    {
+        const uint64 OwnedWord = WordIndex < Words.Num() ? Words[WordIndex] : 0;
+        uint64 MissingWord = Required.Words[WordIndex] & ~OwnedWord;
+
+        while (MissingWord != 0)
+        {
+            const int32 BitIndex = static_cast<int32>(FMath::CountTrailingZeros64(MissingWord));
+            OutMissingTechIds.Add((WordIndex << WordShift) + BitIndex);
+            MissingWord &= MissingWord - 1;
+        }
+    }
+}
+
+void FTechUnlockSet::GetTechIds(TArray<int32>& OutTechIds) const
+{
+    OutTechIds.Reset();
+    OutTechIds.Reserve(Num());
+
+    for (int32 WordIndex = 0; WordIndex < Words.Num(); ++WordIndex)
+    {
+        uint64 Word = Words[WordIndex];
+        while (Word != 0)
+        {
+            const int32 BitIndex = static_cast<int32>(FMath::CountTrailingZeros64(Word));
+            OutTechIds.Add((WordIndex << WordShift) + BitIndex);
+            Word &= Word - 1;
+        }
+    }
+}
+
+int32 FTechUnlockSet::Num() const
+{
+    int32 Count = 0;
+    for (const uint64 Word : Words)
+    {
+        Count += static_cast<int32>(FMath::CountBits(Word));
+    }
+    return Count;
+}
+
+bool FTechUnlockSet::IsEmpty() const
+{
+    for (const uint64 Word : Words)
+    {
+        if (Word != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
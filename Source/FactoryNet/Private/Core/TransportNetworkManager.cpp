@@ -0,0 +1,662 @@
+// TransportNetworkManager.cpp
+// Lokalizacja: Source/FactoryNet/Private/Core/TransportNetworkManager.cpp
+
+#include "Core/TransportNetworkManager.h"
+#include "Core/DataTableManager.h"
+#include "Data/HubDefinition.h"
+#include "Engine/World.h"
+#include "Engine/GameInstance.h"
+#include "Algo/Reverse.h"
+
+namespace
+{
+    constexpr int32 NumTransportTypes = static_cast<int32>(ETransportType::Pipeline) + 1;
+
+    // Brak ścieżki / brak informacji o odległości
+    constexpr float Unreachable = TNumericLimits<float>::Max();
+}
+
+UTransportNetworkManager::UTransportNetworkManager()
+{
+    DataTableManager = nullptr;
+}
+
+void UTransportNetworkManager::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    if (UWorld* World = GetWorld())
+    {
+        if (UGameInstance* GameInstance = World->GetGameInstance())
+        {
+            DataTableManager = GameInstance->GetSubsystem<UDataTableManager>();
+        }
+    }
+
+    if (DataTableManager)
+    {
+        DataTableManager->OnDataTablesLoaded.AddDynamic(this, &UTransportNetworkManager::HandleDataTablesLoaded);
+    }
+    else
+    {
+        UE_LOG(LogTemp, Warning, TEXT("TransportNetworkManager: DataTableManager not available - only runtime routes will be used"));
+    }
+
+    RebuildNetwork();
+}
+
+void UTransportNetworkManager::Deinitialize()
+{
+    if (DataTableManager)
+    {
+        DataTableManager->OnDataTablesLoaded.RemoveDynamic(this, &UTransportNetworkManager::HandleDataTablesLoaded);
+    }
+
+    HubPaths.Empty();
+    HubIdByPath.Empty();
+    RouteStartHubs.Empty();
+    RouteEndHubs.Empty();
+    RouteTypes.Empty();
+    RouteCosts.Empty();
+    RouteActive.Empty();
+    Graphs.Empty();
+
+    SearchCosts.Empty();
+    SearchParentRoutes.Empty();
+    SearchStamps.Empty();
+    SearchHeap.Empty();
+    SearchEpoch = 0;
+
+    DataTableManager = nullptr;
+
+    Super::Deinitialize();
+}
+
+// === NETWORK ===
+void UTransportNetworkManager::RebuildNetwork()
+{
+    const double StartTime = FPlatformTime::Seconds();
+
+    HubPaths.Reset();
+    HubIdByPath.Reset();
+    RouteStartHubs.Reset();
+    RouteEndHubs.Reset();
+    RouteTypes.Reset();
+    RouteCosts.Reset();
+    RouteActive.Reset();
+    Graphs.Reset();
+    Graphs.SetNum(NumTransportTypes);
+
+    if (DataTableManager)
+    {
+        for (const FTransportRoute& Route : DataTableManager->GetAllRoutes())
+        {
+            AddRouteInternal(Route);
+        }
+    }
+
+    // Landmarki od razu - pierwsze zlecenie transportu nie płaci za ich budowę
+    for (FTransportGraph& Graph : Graphs)
+    {
+        if (Graph.RouteIds.Num() > 0)
+        {
+            PrepareGraph(Graph);
+        }
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("TransportNetworkManager: Built network with %d hubs and %d routes (%.2f ms)"),
+        HubPaths.Num(), RouteTypes.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+int32 UTransportNetworkManager::AddRoute(const FTransportRoute& Route)
+{
+    const int32 RouteId = AddRouteInternal(Route);
+    if (RouteId != INDEX_NONE)
+    {
+        UE_LOG(LogTemp, Verbose, TEXT("TransportNetworkManager: Added route %d (%s -> %s)"),
+            RouteId, *Route.StartHubReference.ToString(), *Route.EndHubReference.ToString());
+    }
+    return RouteId;
+}
+
+bool UTransportNetworkManager::SetRouteActive(int32 RouteId, bool bActive)
+{
+    if (!RouteActive.IsValidIndex(RouteId))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("TransportNetworkManager: SetRouteActive - invalid route ID %d"), RouteId);
+        return false;
+    }
+
+    if ((RouteActive[RouteId] != 0) == bActive)
+    {
+        return true;
+    }
+
+    RouteActive[RouteId] = bActive ? 1 : 0;
+
+    // Wyłączenie: krawędź tylko maskowana, dolne ograniczenia zostają poprawne.
+    // Włączenie: odległości landmarków mogą zmaleć - naprawa przy następnym zapytaniu.
+    if (bActive)
+    {
+        if (FTransportGraph* Graph = GetGraph(RouteTypes[RouteId]))
+        {
+            Graph->PendingRepairRoutes.Add(RouteId);
+        }
+    }
+
+    return true;
+}
+
+// === QUERIES ===
+bool UTransportNetworkManager::FindPath(UHubDefinition* FromHub, UHubDefinition* ToHub, ETransportType TransportType,
+                                        TArray<TSoftObjectPtr<UHubDefinition>>& OutHubs, float& OutDistance)
+{
+    OutHubs.Reset();
+    OutDistance = 0.0f;
+
+    TArray<int32> HubIds;
+    TArray<int32> RouteIds;
+    if (!FindPathByHubIds(GetHubId(FSoftObjectPath(FromHub)), GetHubId(FSoftObjectPath(ToHub)), TransportType, HubIds, RouteIds, OutDistance))
+    {
+        return false;
+    }
+
+    OutHubs.Reserve(HubIds.Num());
+    for (const int32 HubId : HubIds)
+    {
+        OutHubs.Add(TSoftObjectPtr<UHubDefinition>(HubPaths[HubId]));
+    }
+    return true;
+}
+
+float UTransportNetworkManager::GetPathDistance(UHubDefinition* FromHub, UHubDefinition* ToHub, ETransportType TransportType)
+{
+    TArray<int32> HubIds;
+    TArray<int32> RouteIds;
+    float Distance = 0.0f;
+    if (!FindPathByHubIds(GetHubId(FSoftObjectPath(FromHub)), GetHubId(FSoftObjectPath(ToHub)), TransportType, HubIds, RouteIds, Distance))
+    {
+        return -1.0f;
+    }
+    return Distance;
+}
+
+int32 UTransportNetworkManager::GetHubId(const FSoftObjectPath& HubPath) const
+{
+    const int32* HubId = HubIdByPath.Find(HubPath);
+    return HubId ? *HubId : INDEX_NONE;
+}
+
+FSoftObjectPath UTransportNetworkManager::GetHubPath(int32 HubId) const
+{
+    return HubPaths.IsValidIndex(HubId) ? HubPaths[HubId] : FSoftObjectPath();
+}
+
+int32 UTransportNetworkManager::GetRouteStartHubId(int32 RouteId) const
+{
+    return RouteStartHubs.IsValidIndex(RouteId) ? RouteStartHubs[RouteId] : INDEX_NONE;
+}
+
+int32 UTransportNetworkManager::GetRouteEndHubId(int32 RouteId) const
+{
+    return RouteEndHubs.IsValidIndex(RouteId) ? RouteEndHubs[RouteId] : INDEX_NONE;
+}
+
+bool UTransportNetworkManager::IsRouteActive(int32 RouteId) const
+{
+    return RouteActive.IsValidIndex(RouteId) && RouteActive[RouteId] != 0;
+}
+
+bool UTransportNetworkManager::FindPathByHubIds(int32 FromHubId, int32 ToHubId, ETransportType TransportType,
+                                                TArray<int32>& OutHubIds, TArray<int32>& OutRouteIds, float& OutDistance)
+{
+    OutHubIds.Reset();
+    OutRouteIds.Reset();
+    OutDistance = 0.0f;
+
+    FTransportGraph* Graph = GetGraph(TransportType);
+    if (!Graph || !HubPaths.IsValidIndex(FromHubId) || !HubPaths.IsValidIndex(ToHubId))
+    {
+        return false;
+    }
+
+    PrepareGraph(*Graph);
+
+    if (FromHubId == ToHubId)
+    {
+        OutHubIds.Add(FromHubId);
+        return true;
+    }
+
+    // Landmarki dowodzą braku ścieżki bez przeszukiwania całej składowej
+    const float StartEstimate = EstimateDistance(*Graph, FromHubId, ToHubId);
+    if (StartEstimate == Unreachable)
+    {
+        return false;
+    }
+
+    // === A* (ALT) ===
+    BeginSearch(Graph->NumHubs);
+    SearchStamps[FromHubId] = SearchEpoch;
+    SearchCosts[FromHubId] = 0.0f;
+    SearchParentRoutes[FromHubId] = INDEX_NONE;
+    SearchHeap.HeapPush(FSearchNode{ StartEstimate, 0.0f, FromHubId });
+
+    bool bFound = false;
+    while (SearchHeap.Num() > 0)
+    {
+        FSearchNode Node;
+        SearchHeap.HeapPop(Node, EAllowShrinking::No);
+
+        // Nieaktualny wpis - hub został już osiągnięty taniej
+        if (Node.Cost > SearchCosts[Node.Hub])
+        {
+            continue;
+        }
+
+        // Heurystyka jest spójna, więc pierwsze zdjęcie celu z kopca daje optimum
+        if (Node.Hub == ToHubId)
+        {
+            bFound = true;
+            break;
+        }
+
+        for (int32 Edge = Graph->OutOffsets[Node.Hub]; Edge < Graph->OutOffsets[Node.Hub + 1]; ++Edge)
+        {
+            if (!RouteActive[Graph->OutRoutes[Edge]])
+            {
+                continue;
+            }
+
+            const int32 Neighbor = Graph->OutTargets[Edge];
+            const float NewCost = Node.Cost + Graph->OutCosts[Edge];
+            if (IsSearchVisited(Neighbor) && NewCost >= SearchCosts[Neighbor])
+            {
+                continue;
+            }
+
+            const float Estimate = EstimateDistance(*Graph, Neighbor, ToHubId);
+            if (Estimate == Unreachable)
+            {
+                continue;
+            }
+
+            SearchStamps[Neighbor] = SearchEpoch;
+            SearchCosts[Neighbor] = NewCost;
+            SearchParentRoutes[Neighbor] = Graph->OutRoutes[Edge];
+            SearchHeap.HeapPush(FSearchNode{ NewCost + Estimate, NewCost, Neighbor });
+        }
+    }
+
+    if (!bFound)
+    {
+        return false;
+    }
+
+    for (int32 HubId = ToHubId; HubId != FromHubId; HubId = RouteStartHubs[SearchParentRoutes[HubId]])
+    {
+        OutHubIds.Add(HubId);
+        OutRouteIds.Add(SearchParentRoutes[HubId]);
+    }
+    OutHubIds.Add(FromHubId);
+
+    Algo::Reverse(OutHubIds);
+    Algo::Reverse(OutRouteIds);
+    OutDistance = SearchCosts[ToHubId];
+    return true;
+}
+
+float UTransportNetworkManager::GetDistanceLowerBound(int32 FromHubId, int32 ToHubId, ETransportType TransportType)
+{
+    FTransportGraph* Graph = GetGraph(TransportType);
+    if (!Graph || !HubPaths.IsValidIndex(FromHubId) || !HubPaths.IsValidIndex(ToHubId))
+    {
+        return 0.0f;
+    }
+
+    PrepareGraph(*Graph);
+
+    const float Estimate = EstimateDistance(*Graph, FromHubId, ToHubId);
+    return Estimate == Unreachable ? -1.0f : Estimate;
+}
+
+// === PRIVATE FUNCTIONS ===
+void UTransportNetworkManager::HandleDataTablesLoaded()
+{
+    RebuildNetwork();
+}
+
+int32 UTransportNetworkManager::AddRouteInternal(const FTransportRoute& Route)
+{
+    const FSoftObjectPath StartPath = Route.StartHubReference.ToSoftObjectPath();
+    const FSoftObjectPath EndPath = Route.EndHubReference.ToSoftObjectPath();
+    if (StartPath.IsNull() || EndPath.IsNull())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("TransportNetworkManager: Route without start or end hub skipped"));
+        return INDEX_NONE;
+    }
+
+    FTransportGraph* Graph = GetGraph(Route.TransportType);
+    if (!Graph)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("TransportNetworkManager: Route with unknown transport type %d skipped"),
+            static_cast<int32>(Route.TransportType));
+        return INDEX_NONE;
+    }
+
+    const int32 RouteId = RouteTypes.Num();
+    RouteStartHubs.Add(FindOrAddHub(StartPath));
+    RouteEndHubs.Add(FindOrAddHub(EndPath));
+    RouteTypes.Add(Route.TransportType);
+    RouteCosts.Add(FMath::Max(0.0f, Route.Distance));
+    RouteActive.Add(Route.IsActive ? 1 : 0);
+
+    Graph->RouteIds.Add(RouteId);
+    Graph->bAdjacencyDirty = true;
+    if (Route.IsActive)
+    {
+        Graph->PendingRepairRoutes.Add(RouteId);
+    }
+
+    return RouteId;
+}
+
+int32 UTransportNetworkManager::FindOrAddHub(const FSoftObjectPath& HubPath)
+{
+    if (const int32* ExistingId = HubIdByPath.Find(HubPath))
+    {
+        return *ExistingId;
+    }
+
+    const int32 HubId = HubPaths.Add(HubPath);
+    HubIdByPath.Add(HubPath, HubId);
+    return HubId;
+}
+
+UTransportNetworkManager::FTransportGraph* UTransportNetworkManager::GetGraph(ETransportType TransportType)
+{
+    const int32 GraphIndex = static_cast<int32>(TransportType);
+    return Graphs.IsValidIndex(GraphIndex) ? &Graphs[GraphIndex] : nullptr;
+}
+
+// === GRAPH MAINTENANCE ===
+void UTransportNetworkManager::PrepareGraph(FTransportGraph& Graph)
+{
+    // Huby dodane przez trasy innego typu też poszerzają CSR (bez krawędzi)
+    if (Graph.bAdjacencyDirty || Graph.NumHubs != HubPaths.Num())
+    {
+        RebuildAdjacency(Graph);
+    }
+
+    if (Graph.bLandmarksDirty)
+    {
+        BuildLandmarks(Graph);
+    }
+    else if (Graph.PendingRepairRoutes.Num() > 0)
+    {
+        RepairLandmarks(Graph);
+    }
+}
+
+void UTransportNetworkManager::RebuildAdjacency(FTransportGraph& Graph)
+{
+    const int32 NumHubs = HubPaths.Num();
+    const int32 NumEdges = Graph.RouteIds.Num();
+
+    // Sortowanie przez zliczanie po hubie startowym / końcowym - O(hubów + tras)
+    Graph.OutOffsets.Init(0, NumHubs + 1);
+    Graph.InOffsets.Init(0, NumHubs + 1);
+    for (const int32 RouteId : Graph.RouteIds)
+    {
+        ++Graph.OutOffsets[RouteStartHubs[RouteId] + 1];
+        ++Graph.InOffsets[RouteEndHubs[RouteId] + 1];
+    }
+
+    int32 NumConnectedHubs = 0;
+    for (int32 HubId = 0; HubId < NumHubs; ++HubId)
+    {
+        if (Graph.OutOffsets[HubId + 1] > 0 || Graph.InOffsets[HubId + 1] > 0)
+        {
+            ++NumConnectedHubs;
+        }
+        Graph.OutOffsets[HubId + 1] += Graph.OutOffsets[HubId];
+        Graph.InOffsets[HubId + 1] += Graph.InOffsets[HubId];
+    }
+
+    Graph.OutRoutes.SetNumUninitialized(NumEdges);
+    Graph.OutTargets.SetNumUninitialized(NumEdges);
+    Graph.OutCosts.SetNumUninitialized(NumEdges);
+    Graph.InRoutes.SetNumUninitialized(NumEdges);
+    Graph.InSources.SetNumUninitialized(NumEdges);
+    Graph.InCosts.SetNumUninitialized(NumEdges);
+
+    TArray<int32> OutCursors(Graph.OutOffsets);
+    TArray<int32> InCursors(Graph.InOffsets);
+    for (const int32 RouteId : Graph.RouteIds)
+    {
+        const int32 OutEdge = OutCursors[RouteStartHubs[RouteId]]++;
+        Graph.OutRoutes[OutEdge] = RouteId;
+        Graph.OutTargets[OutEdge] = RouteEndHubs[RouteId];
+        Graph.OutCosts[OutEdge] = RouteCosts[RouteId];
+
+        const int32 InEdge = InCursors[RouteEndHubs[RouteId]]++;
+        Graph.InRoutes[InEdge] = RouteId;
+        Graph.InSources[InEdge] = RouteStartHubs[RouteId];
+        Graph.InCosts[InEdge] = RouteCosts[RouteId];
+    }
+
+    // Nowe huby są nieosiągalne dla landmarków, dopóki naprawa nie dojdzie do nich nową trasą
+    if (Graph.NumLandmarks > 0 && NumHubs > Graph.NumHubs)
+    {
+        const int32 NumNewEntries = (NumHubs - Graph.NumHubs) * Graph.NumLandmarks;
+        for (int32 Entry = 0; Entry < NumNewEntries; ++Entry)
+        {
+            Graph.FromLandmark.Add(Unreachable);
+            Graph.ToLandmark.Add(Unreachable);
+        }
+    }
+
+    // Mała sieć urosła - pełny zestaw landmarków zamiast naprawy
+    if (Graph.NumLandmarks < FMath::Min(MaxLandmarks, NumConnectedHubs))
+    {
+        Graph.bLandmarksDirty = true;
+    }
+
+    Graph.NumHubs = NumHubs;
+    Graph.bAdjacencyDirty = false;
+}
+
+void UTransportNetworkManager::BuildLandmarks(FTransportGraph& Graph)
+{
+    const int32 NumHubs = Graph.NumHubs;
+
+    // Kandydaci: huby z co najmniej jedną trasą; pierwszy landmark to hub o największym stopniu
+    TArray<int32> Candidates;
+    int32 FirstLandmark = INDEX_NONE;
+    int32 MaxDegree = 0;
+    for (int32 HubId = 0; HubId < NumHubs; ++HubId)
+    {
+        const int32 Degree = Graph.OutOffsets[HubId + 1] - Graph.OutOffsets[HubId] + Graph.InOffsets[HubId + 1] - Graph.InOffsets[HubId];
+        if (Degree > 0)
+        {
+            Candidates.Add(HubId);
+            if (Degree > MaxDegree)
+            {
+                MaxDegree = Degree;
+                FirstLandmark = HubId;
+            }
+        }
+    }
+
+    const int32 NumLandmarks = FMath::Min(MaxLandmarks, Candidates.Num());
+    Graph.NumLandmarks = NumLandmarks;
+    Graph.Landmarks.Reset();
+    Graph.FromLandmark.Init(Unreachable, NumHubs * NumLandmarks);
+    Graph.ToLandmark.Init(Unreachable, NumHubs * NumLandmarks);
+
+    // Farthest-point: kolejny landmark jest najdalej od wszystkich dotychczasowych (nieosiągalne najpierw)
+    TArray<float> NearestLandmarkDistances;
+    NearestLandmarkDistances.Init(Unreachable, NumHubs);
+
+    int32 NextLandmark = FirstLandmark;
+    for (int32 LandmarkIndex = 0; LandmarkIndex < NumLandmarks && NextLandmark != INDEX_NONE; ++LandmarkIndex)
+    {
+        Graph.Landmarks.Add(NextLandmark);
+        RelaxLandmarkDistances(Graph, false, LandmarkIndex, Graph.FromLandmark, NextLandmark, 0.0f);
+        RelaxLandmarkDistances(Graph, true, LandmarkIndex, Graph.ToLandmark, NextLandmark, 0.0f);
+
+        NextLandmark = INDEX_NONE;
+        float FarthestDistance = -1.0f;
+        for (const int32 HubId : Candidates)
+        {
+            const int32 Entry = HubId * NumLandmarks + LandmarkIndex;
+            NearestLandmarkDistances[HubId] = FMath::Min(NearestLandmarkDistances[HubId],
+                FMath::Min(Graph.FromLandmark[Entry], Graph.ToLandmark[Entry]));
+
+            if (NearestLandmarkDistances[HubId] > FarthestDistance && !Graph.Landmarks.Contains(HubId))
+            {
+                FarthestDistance = NearestLandmarkDistances[HubId];
+                NextLandmark = HubId;
+            }
+        }
+    }
+
+    Graph.PendingRepairRoutes.Reset();
+    Graph.bLandmarksDirty = false;
+}
+
+void UTransportNetworkManager::RepairLandmarks(FTransportGraph& Graph)
+{
+    const int32 NumLandmarks = Graph.NumLandmarks;
+
+    // Nowa krawędź Start -> End: od landmarku przez Start do End, oraz od Start przez End do landmarku
+    for (const int32 RouteId : Graph.PendingRepairRoutes)
+    {
+        if (!RouteActive[RouteId])
+        {
+            continue;
+        }
+
+        const int32 StartHub = RouteStartHubs[RouteId];
+        const int32 EndHub = RouteEndHubs[RouteId];
+        for (int32 LandmarkIndex = 0; LandmarkIndex < NumLandmarks; ++LandmarkIndex)
+        {
+            const float FromStart = Graph.FromLandmark[StartHub * NumLandmarks + LandmarkIndex];
+            if (FromStart != Unreachable)
+            {
+                RelaxLandmarkDistances(Graph, false, LandmarkIndex, Graph.FromLandmark, EndHub, FromStart + RouteCosts[RouteId]);
+            }
+
+            const float ToEnd = Graph.ToLandmark[EndHub * NumLandmarks + LandmarkIndex];
+            if (ToEnd != Unreachable)
+            {
+                RelaxLandmarkDistances(Graph, true, LandmarkIndex, Graph.ToLandmark, StartHub, ToEnd + RouteCosts[RouteId]);
+            }
+        }
+    }
+
+    Graph.PendingRepairRoutes.Reset();
+}
+
+void UTransportNetworkManager::RelaxLandmarkDistances(const FTransportGraph& Graph, bool bReverse, int32 LandmarkIndex,
+                                                      TArray<float>& Distances, int32 SeedHub, float SeedDistance)
+{
+    const int32 NumLandmarks = Graph.NumLandmarks;
+    if (SeedDistance >= Distances[SeedHub * NumLandmarks + LandmarkIndex])
+    {
+        return;
+    }
+
+    const TArray<int32>& Offsets = bReverse ? Graph.InOffsets : Graph.OutOffsets;
+    const TArray<int32>& EdgeRoutes = bReverse ? Graph.InRoutes : Graph.OutRoutes;
+    const TArray<int32>& Neighbors = bReverse ? Graph.InSources : Graph.OutTargets;
+    const TArray<float>& Costs = bReverse ? Graph.InCosts : Graph.OutCosts;
+
+    // Dijkstra tylko po hubach, które się przybliżyły - pełna budowa to ten sam przypadek z pustą tablicą
+    Distances[SeedHub * NumLandmarks + LandmarkIndex] = SeedDistance;
+    SearchHeap.Reset();
+    SearchHeap.HeapPush(FSearchNode{ SeedDistance, SeedDistance, SeedHub });
+
+    while (SearchHeap.Num() > 0)
+    {
+        FSearchNode Node;
+        SearchHeap.HeapPop(Node, EAllowShrinking::No);
+
+        if (Node.Cost > Distances[Node.Hub * NumLandmarks + LandmarkIndex])
+        {
+            continue;
+        }
+
+        for (int32 Edge = Offsets[Node.Hub]; Edge < Offsets[Node.Hub + 1]; ++Edge)
+        {
+            if (!RouteActive[EdgeRoutes[Edge]])
+            {
+                continue;
+            }
+
+            const float NewDistance = Node.Cost + Costs[Edge];
+            float& NeighborDistance = Distances[Neighbors[Edge] * NumLandmarks + LandmarkIndex];
+            if (NewDistance < NeighborDistance)
+            {
+                NeighborDistance = NewDistance;
+                SearchHeap.HeapPush(FSearchNode{ NewDistance, NewDistance, Neighbors[Edge] });
+            }
+        }
+    }
+}
+
+float UTransportNetworkManager::EstimateDistance(const FTransportGraph& Graph, int32 Hub, int32 TargetHub) const
+{
+    const int32 NumLandmarks = Graph.NumLandmarks;
+    const float* HubFrom = Graph.FromLandmark.GetData() + Hub * NumLandmarks;
+    const float* HubTo = Graph.ToLandmark.GetData() + Hub * NumLandmarks;
+    const float* TargetFrom = Graph.FromLandmark.GetData() + TargetHub * NumLandmarks;
+    const float* TargetTo = Graph.ToLandmark.GetData() + TargetHub * NumLandmarks;
+
+    // Nierówność trójkąta: d(L,t) - d(L,v) <= d(v,t) oraz d(v,L) - d(t,L) <= d(v,t)
+    float Estimate = 0.0f;
+    for (int32 LandmarkIndex = 0; LandmarkIndex < NumLandmarks; ++LandmarkIndex)
+    {
+        if (HubFrom[LandmarkIndex] != Unreachable)
+        {
+            // L dociera do v, ale nie do t - więc v też nie dociera do t
+            if (TargetFrom[LandmarkIndex] == Unreachable)
+            {
+                return Unreachable;
+            }
+            Estimate = FMath::Max(Estimate, TargetFrom[LandmarkIndex] - HubFrom[LandmarkIndex]);
+        }
+
+        if (TargetTo[LandmarkIndex] != Unreachable)
+        {
+            if (HubTo[LandmarkIndex] == Unreachable)
+            {
+                return Unreachable;
+            }
+            Estimate = FMath::Max(Estimate, HubTo[LandmarkIndex] - TargetTo[LandmarkIndex]);
+        }
+    }
+
+    return Estimate;
+}
+
+void UTransportNetworkManager::BeginSearch(int32 NumHubs)
+{
+    if (SearchStamps.Num() != NumHubs)
+    {
+        SearchCosts.SetNumUninitialized(NumHubs);
+        SearchParentRoutes.SetNumUninitialized(NumHubs);
+        SearchStamps.Init(0, NumHubs);
+        SearchEpoch = 0;
+    }
+
+    // Znacznik epoki zamiast czyszczenia tablic - koszt zapytania zależy od odwiedzonych hubów, nie od sieci
+    ++SearchEpoch;
+    if (SearchEpoch == 0)
+    {
+        SearchStamps.Init(0, NumHubs);
+        SearchEpoch = 1;
+    }
+
+    SearchHeap.Reset();
+}
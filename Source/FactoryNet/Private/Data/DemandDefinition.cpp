@@ -3,3 +3,4 @@
 
 #include "Data/DemandDefinition.h"
 
+const FPrimaryAssetType UDemandDefinition::PrimaryAssetType(TEXT("DemandDefinition"));
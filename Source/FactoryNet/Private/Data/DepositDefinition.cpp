@@ -3,3 +3,31 @@
 
 #include "Data/DepositDefinition.h"
 
+FDepositLevel UDepositDefinition::GetLevelData(int32 Level) const
+{
+    if (Level <= 0 || Level > DepositLevels.Num())
+    {
+        // Return default level data
+        FDepositLevel DefaultLevel;
+        DefaultLevel.Level = 1;
+        DefaultLevel.ExtractionRate = 1.0f;
+        DefaultLevel.MaxStorage = 100;
+        DefaultLevel.EnergyConsumption = 1.0f;
+        DefaultLevel.UpgradeCost = 1000.0f;
+        return DefaultLevel;
+    }
+
+    return DepositLevels[Level - 1];
+}
+
+TSoftObjectPtr<UStaticMesh> UDepositDefinition::GetLevelMesh(int32 Level) const
+{
+    if (DepositLevels.IsValidIndex(Level - 1) && !DepositLevels[Level - 1].LevelMesh.IsNull())
+    {
+        return DepositLevels[Level - 1].LevelMesh;
+    }
+
+    return BaseMesh;
+}
+
+const FPrimaryAssetType UDepositDefinition::PrimaryAssetType(TEXT("DepositDefinition"));
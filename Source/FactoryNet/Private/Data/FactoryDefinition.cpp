@@ -3,3 +3,17 @@
 
 #include "Data/FactoryDefinition.h"
 
+FFactoryLevel UFactoryDefinition::GetLevelData(int32 Level) const
+{
+    if (!FactoryLevels.IsValidIndex(Level - 1))
+    {
+        // Domyślny konstruktor FFactoryLevel = mnożniki 1.0, magazyny po 100
+        FFactoryLevel DefaultLevel;
+        DefaultLevel.Level = FMath::Max(1, Level);
+        return DefaultLevel;
+    }
+
+    return FactoryLevels[Level - 1];
+}
+
+const FPrimaryAssetType UFactoryDefinition::PrimaryAssetType(TEXT("FactoryDefinition"));
@@ -3,3 +3,4 @@
 
 #include "Data/HubDefinition.h"
 
+const FPrimaryAssetType UHubDefinition::PrimaryAssetType(TEXT("HubDefinition"));
@@ -3,3 +3,4 @@
 
 #include "Data/RoadDefinition.h"
 
+const FPrimaryAssetType URoadDefinition::PrimaryAssetType(TEXT("RoadDefinition"));
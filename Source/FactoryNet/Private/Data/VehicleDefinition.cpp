@@ -3,3 +3,4 @@
 
 #include "Data/VehicleDefinition.h"
 
+const FPrimaryAssetType UVehicleDefinition::PrimaryAssetType(TEXT("VehicleDefinition"));
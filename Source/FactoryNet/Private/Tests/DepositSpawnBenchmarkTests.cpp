@@ -0,0 +1,106 @@
+// DepositSpawnBenchmarkTests.cpp
+// Lokalizacja: Source/FactoryNet/Private/Tests/DepositSpawnBenchmarkTests.cpp
+
+#include "Core/DepositSpawnBenchmarkCommandlet.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Headless run of the DepositSpawnBenchmark scenarios as automation tests - checks the plan and the spawned
+ * deposits, and reports the same metrics as the commandlet:
+ *
+ * UnrealEditor-Cmd FactoryNet.uproject -ExecCmds="Automation RunTests FactoryNet.DepositSpawn.Benchmark; Quit"
+ *     -nullrhi -unattended -nopause -testexit="Automation Test Queue Empty"
+ */
+namespace
+{
+    // Domyślne wartości -run=DepositSpawnBenchmark
+    constexpr float BenchmarkCandidateSpacing = 500.0f;
+    constexpr int32 BenchmarkQueryCount = 10000;
+    constexpr int32 BenchmarkSeed = 1337;
+}
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FDepositSpawnBenchmarkTest, "FactoryNet.DepositSpawn.Benchmark",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+void FDepositSpawnBenchmarkTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+    const TArray<float>& Scales = UDepositSpawnBenchmarkCommandlet::GetDefaultScales();
+    const TArray<int32>& RuleCounts = UDepositSpawnBenchmarkCommandlet::GetDefaultRuleCounts();
+
+    for (const TCHAR* Mode : { TEXT("Grid"), TEXT("Poisson") })
+    {
+        for (const float AreaSide : Scales)
+        {
+            for (const int32 RuleCount : RuleCounts)
+            {
+                OutBeautifiedNames.Add(FString::Printf(TEXT("%s %.0f %d Rules"), Mode, AreaSide, RuleCount));
+                OutTestCommands.Add(FString::Printf(TEXT("%s,%.0f,%d,Actors"), Mode, AreaSide, RuleCount));
+            }
+        }
+
+        // Rekordy symulacji - tylko najmniejsza skala, ścieżka planowania jest ta sama
+        if (Scales.Num() > 0 && RuleCounts.Num() > 0)
+        {
+            OutBeautifiedNames.Add(FString::Printf(TEXT("%s %.0f %d Rules Records"), Mode, Scales[0], RuleCounts.Last()));
+            OutTestCommands.Add(FString::Printf(TEXT("%s,%.0f,%d,Records"), Mode, Scales[0], RuleCounts.Last()));
+        }
+    }
+}
+
+bool FDepositSpawnBenchmarkTest::RunTest(const FString& Parameters)
+{
+    TArray<FString> Tokens;
+    Parameters.ParseIntoArray(Tokens, TEXT(","), true);
+    if (Tokens.Num() != 4)
+    {
+        AddError(FString::Printf(TEXT("Malformed test command: %s"), *Parameters));
+        return false;
+    }
+
+    const EDepositPlacementMode PlacementMode = Tokens[0] == TEXT("Poisson") ? EDepositPlacementMode::PoissonDisk : EDepositPlacementMode::JitteredGrid;
+    const float AreaSide = FCString::Atof(*Tokens[1]);
+    const int32 RuleCount = FCString::Atoi(*Tokens[2]);
+    const bool bSimulationRecords = Tokens[3] == TEXT("Records");
+
+    FDepositSpawnBenchmarkResult Result;
+    if (!UDepositSpawnBenchmarkCommandlet::RunScenario(PlacementMode, AreaSide, RuleCount, BenchmarkCandidateSpacing,
+                                                       BenchmarkQueryCount, BenchmarkSeed, bSimulationRecords, Result))
+    {
+        AddError(TEXT("Scenario could not run or spawned no deposits"));
+        return false;
+    }
+
+    AddInfo(UDepositSpawnBenchmarkCommandlet::FormatSummary(Result));
+
+    // === PLAN ===
+    TestEqual(TEXT("Generation seed"), Result.Stats.GenerationSeed, BenchmarkSeed);
+    TestTrue(TEXT("Planned deposits do not exceed candidates"), Result.Stats.PlannedCount <= Result.Stats.CandidateCount);
+    TestTrue(TEXT("Spawned deposits do not exceed the plan"), Result.Stats.SpawnedCount <= Result.Stats.PlannedCount);
+
+    // === SPAWN ===
+    TestEqual(TEXT("Rules over MaxDepositCount"), Result.MaxCountViolations, 0);
+    TestEqual(TEXT("Same-type deposits closer than MinDistanceFromOthers"), Result.SpacingViolations, 0);
+
+    // Ten sam seed -> ten sam plan; powtórka tylko na najmniejszej skali, żeby nie podwajać czasu dużych scenariuszy
+    const TArray<float>& Scales = UDepositSpawnBenchmarkCommandlet::GetDefaultScales();
+    if (Scales.Num() > 0 && AreaSide <= Scales[0])
+    {
+        FDepositSpawnBenchmarkResult RepeatResult;
+        if (UDepositSpawnBenchmarkCommandlet::RunScenario(PlacementMode, AreaSide, RuleCount, BenchmarkCandidateSpacing,
+                                                          BenchmarkQueryCount, BenchmarkSeed, bSimulationRecords, RepeatResult))
+        {
+            TestEqual(TEXT("Planned count with the same seed"), RepeatResult.Stats.PlannedCount, Result.Stats.PlannedCount);
+            TestEqual(TEXT("Spawned count with the same seed"), RepeatResult.Stats.SpawnedCount, Result.Stats.SpawnedCount);
+        }
+        else
+        {
+            AddError(TEXT("Repeated scenario could not run"));
+        }
+    }
+
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -10,11 +10,20 @@
 #include "Engine/DataTable.h"
 #include "Data/DepositDefinition.h"
 #include "Components/ResourceStorageComponent.h"
+#include "Core/ExtractionAccumulator.h"
 #include "ResourceDeposit.generated.h"
 
 // Forward declarations
 class UDepositDefinition;
 
+UENUM(BlueprintType)
+enum class EDepositExtractionMode : uint8
+{
+    ActorTick   UMETA(DisplayName = "Actor Tick (Tick aktora)"),
+    Batched     UMETA(DisplayName = "Batched (Extraction Manager)"),
+    Lazy        UMETA(DisplayName = "Lazy (Bez ticku, liczone przy odczycie)")
+};
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnResourceExtracted, AResourceDeposit*, Deposit, FDataTableRowHandle, ResourceType, int32, Amount);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnDepositDepleted, AResourceDeposit*, Deposit);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnDepositLevelChanged, AResourceDeposit*, Deposit, int32, NewLevel);
@@ -29,6 +38,8 @@ public:
 
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+    virtual void Destroyed() override;
 
 public:
     virtual void Tick(float DeltaTime) override;
@@ -40,6 +51,9 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Deposit")
     void InitializeFromSpawn(UDepositDefinition* DepositDef, int32 InitialLevel = 1);
 
+    // Po InitializeWithDefinition: odtwarza poziom, rezerwy i magazyn z rekordu UDepositSimulationManager
+    void RestoreSimulationState(int32 Level, int32 Reserves, int32 StoredAmount);
+
     // === EXTRACTION ===
     UFUNCTION(BlueprintCallable, Category = "Extraction")
     int32 ExtractResource(int32 RequestedAmount);
@@ -47,6 +61,15 @@ public:
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Extraction")
     bool CanExtractResource(int32 RequestedAmount) const;
 
+    // Stores everything auto extraction produced up to now, in every extraction mode; returns the amount stored
+    UFUNCTION(BlueprintCallable, Category = "Extraction")
+    int32 CatchUpExtraction();
+
+    // Catches up, then advances auto extraction by DeltaSeconds more in O(1) (same total as ticking through it).
+    // Returns the amount stored.
+    UFUNCTION(BlueprintCallable, Category = "Extraction")
+    int32 AdvanceExtraction(float DeltaSeconds);
+
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Extraction")
     float GetCurrentExtractionRate() const;
 
@@ -83,6 +106,9 @@ public:
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Resource")
     FText GetDepositName() const;
 
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Resource")
+    UDepositDefinition* GetDepositDefinition() const { return DepositDefinition; }
+
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Resource")
     bool IsRenewable() const;
 
@@ -92,6 +118,9 @@ public:
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Resource")
     float GetDepletionPercentage() const;
 
+    // Rezerwy bez części już wydobytej, ale jeszcze nie zapisanej w magazynie (tryb Lazy)
+    int32 GetRemainingReserves() const;
+
     // === STORAGE ACCESS ===
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Storage")
     UResourceStorageComponent* GetStorageComponent() const { return StorageComponent; }
@@ -109,6 +138,17 @@ public:
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Collision")
     float GetCollisionRadius() const;
 
+    // === BATCHED EXTRACTION (UDepositExtractionManager) ===
+    bool IsAutoExtractionActive() const;
+    float GetExtractionTickRate() const { return ExtractionTickRate; }
+
+    // Moves an amount already clamped by the manager from reserves to storage; false if storage rejected it
+    bool ApplyBatchedExtraction(int32 Amount);
+
+    // Call after changing auto extraction settings or reserves at runtime so the manager re-reads them
+    UFUNCTION(BlueprintCallable, Category = "Auto Extraction")
+    void NotifyExtractionStateChanged();
+
     // === VISUAL UPDATES ===
     UFUNCTION(BlueprintCallable, Category = "Visual")
     void UpdateVisualMesh();
@@ -168,6 +208,12 @@ protected:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Auto Extraction")
     float ExtractionTickRate = 1.0f;
 
+    // Batched = UDepositExtractionManager advances all deposits in one loop.
+    // Lazy = no tick at all; stored amount and reserves are computed from the last update time and a timer
+    // fires only when storage fills up or reserves run out. In both modes the actor ticks only for debug drawing.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Auto Extraction")
+    EDepositExtractionMode ExtractionMode = EDepositExtractionMode::Batched;
+
     // === COLLISION SETTINGS ===
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Collision")
     float CollisionRadius = 500.0f;
@@ -192,8 +238,20 @@ private:
     void CheckForDepletion();
     void SetupCollision();  // ✅ DODANO
     void UpdateCollisionSize();  // ✅ DODANO
+    void RegisterWithDepositRegistry();
+    void UnregisterFromDepositRegistry();
+    void RegisterWithExtractionManager();
+    void UnregisterFromExtractionManager();
+    void UpdateActorTickEnabled();
+    void RestartLazyExtraction();
+    void SyncLazyExtraction();
+    int32 StoreAccumulatedExtraction();
+    void HandleStorageContentsChanged(UResourceStorageComponent* Storage, const FDataTableRowHandle& ResourceType);
 
     // === INTERNAL STATE ===
     float TimeSinceLastExtraction = 0.0f;
+    FExtractionAccumulator ExtractionAccumulator;  // ActorTick mode and explicit AdvanceExtraction time
+    int64 LastSeenLazyProducedTotal = 0;
+    FDelegateHandle StorageContentsChangedHandle;
     bool bHasBeenInitialized = false;
 };
\ No newline at end of file
@@ -6,6 +6,9 @@
 #include "Components/ActorComponent.h"
 #include "Engine/DataTable.h"
 #include "Data/ResourceData.h"
+#include "Data/TransportData.h"
+#include "Core/ExtractionAccumulator.h"
+#include "TimerManager.h"
 #include "ResourceStorageComponent.generated.h"
 
 USTRUCT(BlueprintType)
@@ -29,6 +32,15 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnStorageChanged, FDataTableRowH
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnResourceAdded, FDataTableRowHandle, ResourceType, int32, Amount);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnResourceRemoved, FDataTableRowHandle, ResourceType, int32, Amount);
 
+class UResourceStorageComponent;
+
+// Coalesced notification for bulk operations - at most once per frame, query GetAllStoredResources() for contents
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnStorageBatchChanged, UResourceStorageComponent*, Storage);
+
+// Native (C++ only) - fires on every change of contents or capacity, including ClearAllResources/SetInitialResource.
+// ResourceType is the changed resource, or empty when the capacity or several resources changed at once.
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnStorageContentsChanged, UResourceStorageComponent*, const FDataTableRowHandle&);
+
 UCLASS(BlueprintType, ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
 class FACTORYNET_API UResourceStorageComponent : public UActorComponent
 {
@@ -37,8 +49,14 @@ class FACTORYNET_API UResourceStorageComponent : public UActorComponent
 public:
     UResourceStorageComponent();
 
+    // UObject Interface - SlotByResource/StoredTotal are not serialized, rebuilt from the slot arrays
+    virtual void PostLoad() override;
+    virtual void PostDuplicate(bool bDuplicateForPIE) override;
+    virtual void PostEditImport() override;
+
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
     // === STORAGE MANAGEMENT ===
@@ -67,6 +85,10 @@ public:
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Storage")
     TArray<FStoredResource> GetAllStoredResources() const;
 
+    // Stored slots only (what the former StoredResources property held) - pending lazy production is not included
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Runtime Data")
+    TArray<FStoredResource> GetStoredResources() const;
+
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Storage")
     bool IsEmpty() const;
 
@@ -102,6 +124,33 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Utility")
     void SetInitialResource(const FDataTableRowHandle& ResourceType, int32 Amount);
 
+    // === BULK TRANSFER ===
+    // All-or-nothing: validates every item (source amount, target type and capacity) before moving anything.
+    // Duplicate resource entries are summed. Per-resource events are not fired - each side gets one
+    // OnStorageBatchChanged per frame instead.
+    bool TransferManyTo(UResourceStorageComponent* TargetStorage, TArrayView<const FCargoItem> Items);
+
+    UFUNCTION(BlueprintCallable, Category = "Utility")
+    bool TransferCargoTo(UResourceStorageComponent* TargetStorage, const TArray<FCargoItem>& Cargo);
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Utility")
+    bool CanTransferCargoTo(const UResourceStorageComponent* TargetStorage, const TArray<FCargoItem>& Cargo) const;
+
+    // === LAZY PRODUCTION ===
+    // Closed-form production for tickless producers (AResourceDeposit in Lazy mode). Queries add the amount
+    // produced since the last update; it is written into the storage slots on the next mutation, or by a timer
+    // scheduled for the moment production stops (storage full / limit reached) so events still fire on time.
+    // ProductionLimit < 0 = unlimited.
+    void StartLazyProduction(const FDataTableRowHandle& ResourceType, double RatePerSecond, int32 ProductionLimit);
+    void StopLazyProduction();
+    void MaterializeLazyProduction();
+
+    bool IsLazyProductionActive() const { return bLazyProductionActive; }
+    int32 GetLazyPendingAmount() const;
+
+    // Monotonic count of lazily produced units already written into storage
+    int64 GetLazyMaterializedTotal() const { return LazyMaterializedTotal; }
+
     // === EVENTS ===
     UPROPERTY(BlueprintAssignable, Category = "Events")
     FOnStorageChanged OnStorageChanged;
@@ -112,6 +161,12 @@ public:
     UPROPERTY(BlueprintAssignable, Category = "Events")
     FOnResourceRemoved OnResourceRemoved;
 
+    UPROPERTY(BlueprintAssignable, Category = "Events")
+    FOnStorageBatchChanged OnStorageBatchChanged;
+
+    // Used by managers that mirror storage state (e.g. UDepositExtractionManager)
+    FOnStorageContentsChanged OnStorageContentsChanged;
+
     // === BLUEPRINT EVENTS ===
     UFUNCTION(BlueprintImplementableEvent, Category = "Events")
     void OnStorageChanged_BP(FDataTableRowHandle ResourceType, int32 NewAmount, int32 MaxCapacityParam);
@@ -122,6 +177,20 @@ public:
     UFUNCTION(BlueprintImplementableEvent, Category = "Events")
     void OnResourceRemoved_BP(FDataTableRowHandle ResourceType, int32 Amount);
 
+    UFUNCTION(BlueprintImplementableEvent, Category = "Events")
+    void OnStorageBatchChanged_BP();
+
+    // === DEFERRED EVENTS ===
+    // Turning deferral off flushes what is pending right away
+    UFUNCTION(BlueprintCallable, Category = "Events")
+    void SetDeferStorageEvents(bool bDefer);
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Events")
+    bool IsDeferringStorageEvents() const { return bDeferStorageEvents; }
+
+    // Broadcasts one net OnStorageChanged + OnResourceAdded/Removed per changed resource (UStorageEventSubsystem)
+    void FlushDeferredStorageEvents();
+
 protected:
     // === STORAGE CONFIGURATION ===
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Storage Configuration")
@@ -137,14 +206,71 @@ protected:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Storage Configuration")
     bool bAllowOverflow = false;
 
+    // Busy hubs: collect changes and broadcast one aggregated delta per resource at end of frame
+    // (UStorageEventSubsystem) instead of dynamic events inside every mutation
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Storage Configuration")
+    bool bDeferStorageEvents = false;
+
     // === RUNTIME DATA ===
-    UPROPERTY(BlueprintReadOnly, Category = "Runtime Data")
-    TArray<FStoredResource> StoredResources;
+    // Dense slots: SlotResources[i] holds SlotAmounts[i]; SlotByResource maps RowName -> slot.
+    // Use GetStoredResources() / GetAllStoredResources() for a Blueprint-friendly copy.
+    UPROPERTY()
+    TArray<FDataTableRowHandle> SlotResources;
+
+    UPROPERTY()
+    TArray<int32> SlotAmounts;
+
+    TMap<FName, int32, TInlineSetAllocator<16>> SlotByResource;
+
+    // Sum of SlotAmounts, kept up to date by SetSlotAmount/RemoveSlot
+    int32 StoredTotal = 0;
 
 private:
     // === INTERNAL FUNCTIONS ===
-    int32 FindResourceIndex(const FDataTableRowHandle& ResourceType) const;
+    int32 FindSlot(const FDataTableRowHandle& ResourceType) const;
+    int32 FindOrAddSlot(const FDataTableRowHandle& ResourceType);
+    void RebuildSlotIndex();
+    void SetSlotAmount(int32 Slot, int32 NewAmount);
+    void RemoveSlot(int32 Slot);
+    void ResetSlots();
     bool IsValidResourceReference(const FDataTableRowHandle& ResourceType) const;
     bool CanAcceptResourceType(const FDataTableRowHandle& ResourceType) const;
     void BroadcastStorageEvents(const FDataTableRowHandle& ResourceType, int32 OldAmount, int32 NewAmount, bool bWasAdded);
+    void NotifyContentsChanged(const FDataTableRowHandle& ResourceType);
+
+    // === BULK TRANSFER INTERNALS ===
+    using FMergedCargo = TArray<FCargoItem, TInlineAllocator<16>>;
+    bool MergeCargoItems(TArrayView<const FCargoItem> Items, FMergedCargo& OutMerged) const;
+    bool ValidateTransfer(const UResourceStorageComponent* TargetStorage, const FMergedCargo& Merged) const;
+    void QueueBatchChangedNotification();
+    void FlushBatchChangedNotification();
+
+    bool bBatchChangedPending = false;
+    FTimerHandle BatchChangedTimer;
+
+    // === DEFERRED EVENTS INTERNALS ===
+    void RecordDeferredChange(const FDataTableRowHandle& ResourceType, int32 OldAmount);
+    void BroadcastResourceEvents(const FDataTableRowHandle& ResourceType, int32 OldAmount, int32 NewAmount);
+
+    struct FDeferredStorageChange
+    {
+        FDataTableRowHandle ResourceType;
+        int32 AmountBeforeChange = 0;
+    };
+
+    // Presence of an entry = dirty bit for that resource
+    TMap<FName, FDeferredStorageChange, TInlineSetAllocator<8>> DeferredChanges;
+
+    // === LAZY PRODUCTION INTERNALS ===
+    double GetWorldTimeSeconds() const;
+    void ScheduleLazyProductionTimer();
+    void HandleLazyProductionTimer();
+
+    bool bLazyProductionActive = false;
+    FDataTableRowHandle LazyResourceType;
+    FExtractionAccumulator LazyAccumulator;
+    double LazyLastUpdateTime = 0.0;
+    int32 LazyLimitRemaining = 0;
+    int64 LazyMaterializedTotal = 0;
+    FTimerHandle LazyProductionTimer;
 };
\ No newline at end of file
@@ -134,6 +134,13 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Deposit Spawning")
     AResourceDeposit* SpawnDepositAtLocation(UDepositDefinition* DepositType, const FVector& Location);
 
+    // Przerywa asynchroniczną generację / czyszczenie - zespawnowane dotąd złoża zostają
+    UFUNCTION(BlueprintCallable, Category = "Deposit Spawning")
+    void CancelGeneration();
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Deposit Spawning")
+    bool IsGenerating() const;
+
     // === CONFIGURATION ===
     UFUNCTION(BlueprintCallable, Category = "Configuration")
     void SetSpawnAreaFromBounds();
@@ -157,6 +164,10 @@ public:
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Query")
     FDepositInfo GetDepositInfo(UDepositDefinition* DepositType);
 
+    // Seed ostatniej generacji - wystarczy go przesłać, żeby odtworzyć układ złóż
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Query")
+    int32 GetLastGenerationSeed() const;
+
     // === DEBUG FUNCTIONS ===
     UFUNCTION(BlueprintCallable, Category = "Debug")
     void DebugSpawnedDeposits();
@@ -180,6 +191,13 @@ public:
     UFUNCTION(BlueprintImplementableEvent, Category = "Events")
     void OnSpawnAreaChanged_BP(FVector NewCenter, FVector NewSize);
 
+    UFUNCTION(BlueprintImplementableEvent, Category = "Events")
+    void OnDepositGenerationProgress_BP(float Progress, int32 SpawnedCount);
+
+    // Postęp asynchronicznej generacji (0..1) - do pasków ładowania w UI
+    UPROPERTY(BlueprintAssignable, Category = "Events")
+    FOnDepositGenerationProgress OnGenerationProgress;
+
 public:
     // === SPAWN CONFIGURATION ===
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spawn Configuration")
@@ -192,10 +210,34 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spawn Configuration")
     EDepositDensity DepositDensity;
 
+    // PoissonDisk = blue noise z odstępem MinDistance każdej reguły, bez limitu MaxSpawnAttempts
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spawn Configuration")
+    EDepositPlacementMode PlacementMode;
+
+    // Ten sam seed = ten sam układ złóż (np. regeneracja mapy na kliencie zamiast replikacji aktorów)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spawn Configuration",
+              meta = (EditCondition = "!bRandomizeSeed"))
+    int32 SpawnSeed;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spawn Configuration")
+    bool bRandomizeSeed;
+
+    // Złoża bez aktorów (instanced mesh per typ/poziom) - AResourceDeposit powstaje przez UDepositSimulationManager::PromoteDeposit
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spawn Configuration")
+    bool bSpawnAsSimulationRecords;
+
     // ✅ DODANO BRAKUJĄCE WŁAŚCIWOŚCI:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spawn Configuration")
     bool bAutoGenerateOnBeginPlay;
 
+    // Plan liczony poza game thread, aktory spawnowane w budżecie na klatkę (dotyczy też Regenerate/Clear)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spawn Configuration")
+    bool bUseAsyncGeneration;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spawn Configuration",
+              meta = (EditCondition = "bUseAsyncGeneration", ClampMin = "0.1", ClampMax = "50.0"))
+    float AsyncSpawnBudgetMs;
+
     // === SPAWN RULES ===
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spawn Rules")
     bool bUseDefaultSpawnRules;
@@ -244,6 +286,10 @@ protected:
     UPROPERTY()
     FTimerHandle DelayedSpawnTimerHandle;
 
+    // Async RegenerateDeposits / ClearAllDeposits in flight - their Blueprint events fire on completion
+    bool bRegeneratePending = false;
+    bool bClearPending = false;
+
 private:
     // === INTERNAL FUNCTIONS ===
     void InitializeSpawnManager();
@@ -256,6 +302,12 @@ private:
     
     UFUNCTION()
     void OnAllDepositsSpawned(const TArray<FSpawnedDepositInfo>& SpawnedDeposits);
+
+    UFUNCTION()
+    void OnAllDepositsCleared();
+
+    UFUNCTION()
+    void OnGenerationProgressChanged(float Progress, int32 SpawnedCount);
     
     // Utility functions
     void UpdateSpawnAreaVisualization();
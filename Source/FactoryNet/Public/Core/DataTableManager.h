@@ -9,6 +9,7 @@
 #include "Data/ProductionData.h"
 #include "Data/TransportData.h"
 #include "Data/UpgradeData.h"
+#include "Core/TechUnlockSet.h"
 #include "DataTableManager.generated.h"
 
 // Forward Declarations
@@ -69,6 +70,13 @@ public:
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Production")
     TArray<FProductionRecipe> GetRecipesByOutputResource(const FDataTableRowHandle& ResourceReference);
 
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Production")
+    TArray<FProductionRecipe> GetRecipesByInputResource(const FDataTableRowHandle& ResourceReference);
+
+    // Raw materials the resource is ultimately made from (the resource itself if it is raw)
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Production")
+    TArray<FDataTableRowHandle> GetRawMaterialsForResource(const FDataTableRowHandle& ResourceReference);
+
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Production")
     FString GetRecipeNameFromReference(const FDataTableRowHandle& RecipeReference);
 
@@ -154,6 +162,11 @@ public:
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Technology")
     TArray<FUpgradeTableRow> GetTechsByPrerequisite(const FDataTableRowHandle& PrerequisiteTech);
 
+    // Techs that became researchable because CompletedTech was finished (checks direct dependents only)
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Technology")
+    TArray<FUpgradeTableRow> GetNewlyAvailableResearch(const FDataTableRowHandle& CompletedTech, 
+                                                       const TArray<FDataTableRowHandle>& CompletedTechs);
+
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Technology")
     TArray<UFactoryDefinition*> GetUnlockedFactories(const TArray<FDataTableRowHandle>& UnlockedTechs);
 
@@ -191,6 +204,25 @@ public:
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Demand Definitions")
     UDemandDefinition* GetDemandDefinitionByName(const FString& DemandName);
 
+    // Wszystkie definicje danego typu - przypisane ręcznie + znalezione przez Asset Manager
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Factory Definitions")
+    TArray<UFactoryDefinition*> GetAllFactoryDefinitions() const { return FactoryDefinitions; }
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Hub Definitions")
+    TArray<UHubDefinition*> GetAllHubDefinitions() const { return HubDefinitions; }
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Vehicle Definitions")
+    TArray<UVehicleDefinition*> GetAllVehicleDefinitions() const { return VehicleDefinitions; }
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Road Definitions")
+    TArray<URoadDefinition*> GetAllRoadDefinitions() const { return RoadDefinitions; }
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Deposit Definitions")
+    TArray<UDepositDefinition*> GetAllDepositDefinitions() const { return DepositDefinitions; }
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Demand Definitions")
+    TArray<UDemandDefinition*> GetAllDemandDefinitions() const { return DemandDefinitions; }
+
     // === UTILITY FUNCTIONS ===
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Utility")
     bool AreDataTablesLoaded() const;
@@ -224,6 +256,80 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Debug")
     void ValidateDataIntegrity();
 
+    // === INDEXED ROW VIEWS (C++ only) ===
+    // Zero-copy views into the secondary indexes. The indexes are rebuilt on first use after a table
+    // was reassigned or changed (OnDataTableChanged), so row pointers stay valid only until the next
+    // change of the source table - don't hold them across frames.
+    const TArray<const FResourceTableRow*>& GetResourceRowsByType(EResourceType ResourceType);
+    const TArray<const FProductionRecipe*>& GetRecipeRowsByOutputResource(const FDataTableRowHandle& ResourceReference) const;
+    const TArray<const FUpgradeTableRow*>& GetUpgradeRowsByCategory(EUpgradeCategory Category);
+    const TArray<const FUpgradeTableRow*>& GetUpgradeRowsByType(EUpgradeType Type);
+    const TArray<const FUpgradeTableRow*>& GetUpgradeRowsByTechLevel(int32 TechLevel);
+    const TArray<const FTransportRoute*>& GetRouteRowsFromHub(const UHubDefinition* HubDef);
+    const TArray<const FTransportRoute*>& GetRouteRowsToHub(const UHubDefinition* HubDef);
+
+    // === TECHNOLOGY UNLOCK SETS (C++ only) ===
+    // Every upgrade row and every tech reference used by definitions/recipes gets a dense ID at load.
+    // Build the player's set once with MakeTechUnlockSet and reuse it for all queries below.
+    int32 GetTechId(const FDataTableRowHandle& TechReference) const;
+    FDataTableRowHandle GetTechReference(int32 TechId) const;
+    int32 GetNumTechIds() const { return TechReferences.Num(); }
+
+    FTechUnlockSet MakeTechUnlockSet(const TArray<FDataTableRowHandle>& UnlockedTechs) const;
+    FTechUnlockSet MakeTechRequirementSet(const TArray<FDataTableRowHandle>& RequiredTechs) const;
+
+    bool AreTechnologiesUnlocked(const FTechUnlockSet& RequiredTechs, const FTechUnlockSet& UnlockedTechs) const;
+    TArray<FDataTableRowHandle> GetMissingTechnologies(const TArray<FDataTableRowHandle>& RequiredTechs, const FTechUnlockSet& UnlockedTechs) const;
+    bool AreUpgradePrerequisitesMet(const FDataTableRowHandle& UpgradeReference, const FTechUnlockSet& CompletedUpgrades);
+
+    bool CanBuildFactory(const UFactoryDefinition* FactoryDef, const FTechUnlockSet& UnlockedTechs) const;
+    bool CanBuildDeposit(const UDepositDefinition* DepositDef, const FTechUnlockSet& UnlockedTechs) const;
+    bool CanBuildHub(const UHubDefinition* HubDef, const FTechUnlockSet& UnlockedTechs) const;
+    bool CanBuildRoad(const URoadDefinition* RoadDef, const FTechUnlockSet& UnlockedTechs) const;
+    bool CanUseVehicle(const UVehicleDefinition* VehicleDef, const FTechUnlockSet& UnlockedTechs) const;
+    bool CanBuildDemandPoint(const UDemandDefinition* DemandDef, const FTechUnlockSet& UnlockedTechs) const;
+    bool CanUseRecipe(const FDataTableRowHandle& RecipeRef, const FTechUnlockSet& UnlockedTechs);
+
+    TArray<FUpgradeTableRow> GetAvailableResearch(const FTechUnlockSet& CompletedTechs);
+    TArray<UFactoryDefinition*> GetUnlockedFactories(const FTechUnlockSet& UnlockedTechs) const;
+    TArray<UDepositDefinition*> GetUnlockedDeposits(const FTechUnlockSet& UnlockedTechs) const;
+    TArray<UVehicleDefinition*> GetUnlockedVehicles(const FTechUnlockSet& UnlockedTechs) const;
+    TArray<URoadDefinition*> GetUnlockedRoads(const FTechUnlockSet& UnlockedTechs) const;
+    TArray<UHubDefinition*> GetUnlockedHubs(const FTechUnlockSet& UnlockedTechs) const;
+    TArray<UDemandDefinition*> GetUnlockedDemandPoints(const FTechUnlockSet& UnlockedTechs) const;
+
+    // === TECH TREE GRAPH (C++ only) ===
+    // Compiled from FUpgradeTableRow::Prerequisites at load. Edges include optional prerequisites.
+    const TArray<int32>& GetTechTopologicalOrder() const { return TechTopologicalOrder; }
+    const TArray<int32>& GetTechDependents(int32 TechId) const;
+    const TArray<int32>& GetTechPrerequisites(int32 TechId) const;
+    const FUpgradeTableRow* GetTechRow(int32 TechId) const;
+    bool HasTechCycle() const { return TechCycleNodes.Num() > 0; }
+    bool IsTechAvailable(int32 TechId, const FTechUnlockSet& CompletedTechs) const;
+
+    // Adds TechId to the completed set and returns dependents that just became researchable - O(out-degree).
+    // False for unknown IDs and references missing from UpgradeDataTable; already completed -> true, nothing new.
+    bool CompleteTechnology(int32 TechId, FTechUnlockSet& InOutCompletedTechs, TArray<int32>& OutNewlyAvailableTechIds) const;
+
+    // === RECIPE GRAPH (C++ only) ===
+    // Bipartite resource <-> recipe graph compiled from ProductionDataTable at load; every query is O(result).
+    // A resource is raw when no recipe produces it or its type is RawMaterial.
+    int32 GetResourceId(const FDataTableRowHandle& ResourceReference) const;
+    FDataTableRowHandle GetResourceReference(int32 ResourceId) const;
+    int32 GetNumResourceIds() const { return ResourceNodes.Num(); }
+    FDataTableRowHandle GetRecipeReference(int32 RecipeId) const;
+    const FProductionRecipe* GetRecipeRow(int32 RecipeId) const;
+    int32 GetNumRecipeIds() const { return RecipeNodes.Num(); }
+
+    const TArray<int32>& GetProducingRecipeIds(int32 ResourceId) const;
+    const TArray<int32>& GetConsumingRecipeIds(int32 ResourceId) const;
+    const TArray<int32>& GetRecipeInputResourceIds(int32 RecipeId) const;
+    int32 GetRecipeOutputResourceId(int32 RecipeId) const;
+
+    // Transitive closure through every producing recipe, sorted by resource ID
+    const TArray<int32>& GetRawMaterialIds(int32 ResourceId) const;
+    bool IsRawMaterial(int32 ResourceId) const;
+
 protected:
     // === DATATABLE REFERENCES ===
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Data Tables")
@@ -268,6 +374,7 @@ private:
     bool ValidateProductionRecipes();
     bool ValidateUpgradeReferences();
     bool ValidateTechnologyReferences();
+    bool ValidateTechTreeGraph();
     void LogDataTableStats();
     
     // Internal helper functions (nie Blueprint callable)
@@ -281,4 +388,111 @@ private:
     // Technology validation helpers
     bool AreTechnologiesUnlockedInternal(const TArray<FDataTableRowHandle>& RequiredTechs, 
                                         const TArray<FDataTableRowHandle>& UnlockedTechs) const;
+    bool AreTechnologiesUnlockedLinear(const TArray<FDataTableRowHandle>& RequiredTechs, 
+                                      const TArray<FDataTableRowHandle>& UnlockedTechs) const;
+    bool IsDefinitionUnlocked(const UObject* Definition, const TArray<FDataTableRowHandle>& RequiredTechs,
+                              const FTechUnlockSet& UnlockedTechs) const;
+    bool IsDefinitionUnlocked(const UObject* Definition, const TArray<FDataTableRowHandle>& RequiredTechs,
+                              const TArray<FDataTableRowHandle>& UnlockedTechs) const;
+
+    // Shared by the GetUnlocked* array overloads - UnlockedSet is built once by the caller
+    template <typename DefinitionType>
+    TArray<DefinitionType*> FilterUnlockedDefinitions(const TArray<DefinitionType*>& Definitions, const FTechUnlockSet& UnlockedSet,
+                                                      const TArray<FDataTableRowHandle>& UnlockedTechs) const;
+
+    // === DEFINITION REGISTRY ===
+    // Built in LoadDataAssets from the arrays above (after Asset Manager discovery) and rebuilt on lookup
+    // when an array no longer matches its Indexed* copy. Keys compare case-insensitively, like FString ==.
+    void BuildDefinitionNameIndexes();
+    void InvalidateDefinitionNameIndexes();
+
+    TMap<FString, UFactoryDefinition*> FactoryDefinitionsByName;
+    TMap<FString, UHubDefinition*> HubDefinitionsByName;
+    TMap<FString, UVehicleDefinition*> VehicleDefinitionsByName;
+    TMap<FString, URoadDefinition*> RoadDefinitionsByName;
+    TMap<FString, UDepositDefinition*> DepositDefinitionsByName;
+    TMap<FString, UDemandDefinition*> DemandDefinitionsByName;
+
+    TArray<UFactoryDefinition*> IndexedFactoryDefinitions;
+    TArray<UHubDefinition*> IndexedHubDefinitions;
+    TArray<UVehicleDefinition*> IndexedVehicleDefinitions;
+    TArray<URoadDefinition*> IndexedRoadDefinitions;
+    TArray<UDepositDefinition*> IndexedDepositDefinitions;
+    TArray<UDemandDefinition*> IndexedDemandDefinitions;
+
+    // === ROW INDEXES ===
+    // Built in LoadAllDataTables and dropped in RefreshDataTables/Deinitialize. Pointers reference rows
+    // owned by the DataTables' RowMap - a changed (OnDataTableChanged) or reassigned table marks the
+    // indexes stale and EnsureRowIndexes rebuilds them before the next lookup.
+    void BuildRowIndexes();
+    void InvalidateRowIndexes();
+    void EnsureRowIndexes();
+    void HandleIndexedDataTableChanged();
+
+    bool bRowIndexesBuilt = false;
+    TWeakObjectPtr<UDataTable> IndexedResourceTable;
+    TWeakObjectPtr<UDataTable> IndexedUpgradeTable;
+    TWeakObjectPtr<UDataTable> IndexedTransportTable;
+    TMap<EResourceType, TArray<const FResourceTableRow*>> ResourcesByType;
+    TMap<EUpgradeCategory, TArray<const FUpgradeTableRow*>> UpgradesByCategory;
+    TMap<EUpgradeType, TArray<const FUpgradeTableRow*>> UpgradesByType;
+    TMap<int32, TArray<const FUpgradeTableRow*>> UpgradesByTechLevel;
+    TMap<FSoftObjectPath, TArray<const FTransportRoute*>> RoutesByStartHub;
+    TMap<FSoftObjectPath, TArray<const FTransportRoute*>> RoutesByEndHub;
+
+    // === TECH ID SPACE ===
+    // Rebuilt together with the row indexes. Masks hold mandatory requirements only.
+    void BuildTechIndex();
+    void InvalidateTechIndex();
+    int32 RegisterTechId(const FDataTableRowHandle& TechReference);
+
+    TMap<FDataTableRowHandle, int32> TechIdByReference;
+    TArray<FDataTableRowHandle> TechReferences;
+    TMap<const UObject*, FTechUnlockSet> DefinitionTechMasks;
+    TMap<FDataTableRowHandle, FTechUnlockSet> RecipeTechMasks;
+
+    // === TECH TREE GRAPH ===
+    // Indexed by tech ID. Nodes without Row are references that are not in UpgradeDataTable.
+    struct FTechNode
+    {
+        const FUpgradeTableRow* Row = nullptr;
+        TArray<int32> Prerequisites;
+        TArray<int32> Dependents;
+        FTechUnlockSet MandatoryPrerequisites;
+    };
+
+    void BuildTechTopologicalOrder();
+    const FTechUnlockSet* FindPrerequisiteMask(const FDataTableRowHandle& UpgradeReference) const;
+
+    TArray<FTechNode> TechNodes;
+    TArray<int32> TechTopologicalOrder;
+    TArray<int32> TechCycleNodes;
+
+    // === RECIPE GRAPH ===
+    // Rebuilt together with the row indexes. Resource IDs cover the resource table plus references used only by recipes.
+    void BuildRecipeGraph();
+    void InvalidateRecipeGraph();
+    int32 RegisterResourceId(const FDataTableRowHandle& ResourceReference);
+
+    struct FRecipeGraphResource
+    {
+        FDataTableRowHandle Reference;
+        TArray<int32> ProducingRecipes;
+        TArray<const FProductionRecipe*> ProducingRecipeRows;   // rows of ProducingRecipes, same order
+        TArray<int32> ConsumingRecipes;
+        TArray<int32> RawMaterials;
+        bool bIsRawMaterial = false;
+    };
+
+    struct FRecipeGraphRecipe
+    {
+        FDataTableRowHandle Reference;
+        const FProductionRecipe* Row = nullptr;
+        int32 OutputResource = INDEX_NONE;
+        TArray<int32> InputResources;   // unique resource IDs
+    };
+
+    TMap<FDataTableRowHandle, int32> ResourceIdByReference;
+    TArray<FRecipeGraphResource> ResourceNodes;
+    TArray<FRecipeGraphRecipe> RecipeNodes;
 };
\ No newline at end of file
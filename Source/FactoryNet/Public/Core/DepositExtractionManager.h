@@ -0,0 +1,105 @@
+// DepositExtractionManager.h
+// Lokalizacja: Source/FactoryNet/Public/Core/DepositExtractionManager.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Core/ExtractionAccumulator.h"
+#include "DepositExtractionManager.generated.h"
+
+// Forward declarations
+class AResourceDeposit;
+class UResourceStorageComponent;
+
+/**
+ * Advances auto-extraction of every registered AResourceDeposit in one batched loop,
+ * replacing per-actor ticks.
+ *
+ * Deposit state is mirrored into contiguous arrays (production accumulator, reserves, free storage).
+ * The update runs in two phases:
+ *  1. Simulate - a loop over the arrays only (no actor access) that computes how much each deposit produces.
+ *  2. Apply    - only deposits with a non-zero amount touch their actor/storage and fire events.
+ * Mirrors are re-synced lazily when a deposit or its storage reports a change; the manager's own writes
+ * to storage are already accounted for in the mirror and do not mark it dirty.
+ *
+ * Every slot keeps its own clock (LastSimulatedTimes), so a slot can lag behind - time slicing,
+ * long ExtractionTickRate - and be caught up later in O(1) with the same total production.
+ */
+UCLASS()
+class FACTORYNET_API UDepositExtractionManager : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    UDepositExtractionManager();
+
+    // USubsystem Interface
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+    // FTickableGameObject Interface
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    // === REGISTRATION ===
+    // Idempotent - calling again re-syncs the mirrored state
+    void RegisterDeposit(AResourceDeposit* Deposit);
+    void UnregisterDeposit(AResourceDeposit* Deposit);
+    void MarkDepositDirty(const AResourceDeposit* Deposit);
+
+    // Brings one deposit up to the current time and extracts everything pending, ignoring its tick interval
+    // (e.g. before showing its storage in UI). Returns the amount moved to storage.
+    UFUNCTION(BlueprintCallable, Category = "Extraction")
+    int32 CatchUpDeposit(AResourceDeposit* Deposit);
+
+    // === CONFIGURATION ===
+    // 1 = all deposits every frame; N = each deposit is simulated every N-th frame (totals are unchanged)
+    UFUNCTION(BlueprintCallable, Category = "Extraction")
+    void SetTimeSliceCount(int32 NewTimeSliceCount);
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Extraction")
+    int32 GetTimeSliceCount() const { return TimeSliceCount; }
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Extraction")
+    int32 GetNumRegisteredDeposits() const { return Deposits.Num(); }
+
+    // Deposits that actually changed during the last Tick
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Extraction")
+    int32 GetLastChangedDepositCount() const { return LastChangedDepositCount; }
+
+private:
+    void SyncSlot(int32 Slot);
+    void SyncDirtySlots();
+    void AdvanceSlotClock(int32 Slot);
+    void SimulateRange(int32 FirstSlot, int32 EndSlot);
+    void ApplyRange(int32 FirstSlot, int32 EndSlot);
+    void HandleStorageChanged(UResourceStorageComponent* Storage, const FDataTableRowHandle& ResourceType);
+
+    // === SOA STATE ===
+    UPROPERTY()
+    TArray<AResourceDeposit*> Deposits;
+
+    TArray<FExtractionAccumulator> Production;  // rate 0 when auto extraction is off
+    TArray<double> LastSimulatedTimes;  // SimulationTime up to which Production has been fed
+    TArray<float> ExtractionIntervals;  // ExtractionTickRate of the deposit
+    TArray<float> TimeSinceExtraction;
+    TArray<int32> Reserves;             // MAX_int32 for renewable deposits
+    TArray<int32> FreeSpace;            // free storage for the deposit's resource
+    TArray<int32> PendingAmounts;       // output of the simulate phase
+    TArray<uint8> DirtyFlags;           // set exactly for the slots listed in DirtySlots
+
+    TArray<int32> DirtySlots;           // re-synced at the start of the next Tick
+
+    TMap<const AResourceDeposit*, int32> SlotByDeposit;
+    TArray<FDelegateHandle> StorageHandles;
+
+    // Storage receiving our own AddResource - its notifications are ignored
+    const UResourceStorageComponent* StorageBeingWritten = nullptr;
+
+    // === TIME ===
+    double SimulationTime = 0.0;
+    int32 TimeSliceCount = 1;
+    int32 NextTimeSlice = 0;
+
+    int32 LastChangedDepositCount = 0;
+};
@@ -0,0 +1,64 @@
+// DepositMeshStreamer.h
+// Lokalizacja: Source/FactoryNet/Public/Core/DepositMeshStreamer.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/StreamableManager.h"
+#include "DepositMeshStreamer.generated.h"
+
+// Forward declarations
+class UDepositDefinition;
+class UStaticMesh;
+
+/**
+ * Asynchronous loading of deposit meshes (BaseMesh + every LevelMesh) without game-thread disk reads.
+ *
+ * Requests are deduplicated per UDepositDefinition: the first request for a definition starts one
+ * FStreamableManager load of all its meshes, later requests only queue a callback. PrefetchDefinitions
+ * batches many definitions into a single request (e.g. all active spawn rules before generation).
+ * Until a load completes, callers show GetPlaceholderMesh().
+ */
+UCLASS(Config = Game)
+class FACTORYNET_API UDepositMeshStreamer : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    UDepositMeshStreamer();
+
+    // USubsystem Interface
+    virtual void Deinitialize() override;
+
+    // OnLoaded runs immediately when the definition's meshes are already loaded (or failed to load)
+    void RequestDefinitionMeshes(const UDepositDefinition* DepositDefinition, FSimpleDelegate OnLoaded);
+
+    // One streaming request for all meshes of definitions that were not requested yet
+    void PrefetchDefinitions(TArrayView<const UDepositDefinition* const> DepositDefinitions);
+
+    // True once the load finished - meshes that failed to load stay null
+    bool AreDefinitionMeshesLoaded(const UDepositDefinition* DepositDefinition) const;
+
+    UStaticMesh* GetPlaceholderMesh();
+
+private:
+    struct FDefinitionMeshRequest
+    {
+        TSharedPtr<FStreamableHandle> Handle;  // keeps the loaded meshes referenced
+        TArray<FSimpleDelegate> Waiters;
+        bool bLoaded = false;
+    };
+
+    static void GatherMeshPaths(const UDepositDefinition* DepositDefinition, TArray<FSoftObjectPath>& OutPaths);
+    void HandleMeshesLoaded(TArray<const UDepositDefinition*> LoadedDefinitions);
+
+    // Pokazywany do końca ładowania - domyślnie sześcian z engine content
+    UPROPERTY(Config)
+    TSoftObjectPtr<UStaticMesh> PlaceholderMesh;
+
+    UPROPERTY()
+    UStaticMesh* LoadedPlaceholderMesh;
+
+    FStreamableManager StreamableManager;
+    TMap<const UDepositDefinition*, FDefinitionMeshRequest> Requests;
+};
@@ -0,0 +1,93 @@
+// DepositRegistry.h
+// Lokalizacja: Source/FactoryNet/Public/Core/DepositRegistry.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Core/DepositSpatialHash.h"
+#include "DepositRegistry.generated.h"
+
+// Forward declarations
+class AResourceDeposit;
+class UDepositDefinition;
+
+/**
+ * World-wide registry of every AResourceDeposit in play.
+ * Deposits register themselves in BeginPlay/InitializeWithDefinition and unregister in EndPlay,
+ * so proximity checks never have to walk the actor list.
+ *
+ * Positions live in SoA arrays indexed by a dense slot (swap-remove keeps them packed);
+ * a global spatial hash and one hash per deposit type map locations to slots.
+ */
+UCLASS()
+class FACTORYNET_API UDepositRegistry : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    UDepositRegistry();
+
+    // USubsystem Interface
+    virtual void Deinitialize() override;
+
+    // === REGISTRATION ===
+    // Idempotent - calling again re-syncs location and deposit type
+    void RegisterDeposit(AResourceDeposit* Deposit);
+    void UnregisterDeposit(AResourceDeposit* Deposit);
+    bool IsDepositRegistered(const AResourceDeposit* Deposit) const;
+
+    // Cell size for the per-type index (usually the spawn rule's MinDistanceFromOthers)
+    void SetDepositTypeCellSize(const UDepositDefinition* DepositType, float CellSize);
+
+    // === QUERIES ===
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Deposit Registry")
+    int32 GetNumDeposits() const { return Deposits.Num(); }
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Deposit Registry")
+    TArray<AResourceDeposit*> GetAllDeposits() const { return Deposits; }
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Deposit Registry")
+    bool IsAnyDepositWithinRadius(const FVector& Location, float Radius, const AResourceDeposit* IgnoredDeposit = nullptr) const;
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Deposit Registry")
+    bool IsAnyDepositOfTypeWithinRadius(const FVector& Location, float Radius, const UDepositDefinition* DepositType) const;
+
+    // DepositType == nullptr searches all deposits
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Deposit Registry")
+    AResourceDeposit* FindNearestDeposit(const FVector& Location, const UDepositDefinition* DepositType = nullptr) const;
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Deposit Registry")
+    TArray<AResourceDeposit*> GetDepositsInRadius(const FVector& Location, float Radius, const UDepositDefinition* DepositType = nullptr) const;
+
+    // === SOA ACCESS (C++ only) ===
+    // Slots are dense [0, GetNumDeposits()) and change on unregister (swap-remove)
+    const TArray<float>& GetPositionsX() const { return PositionsX; }
+    const TArray<float>& GetPositionsY() const { return PositionsY; }
+    const TArray<float>& GetPositionsZ() const { return PositionsZ; }
+    AResourceDeposit* GetDepositAtSlot(int32 Slot) const { return Deposits.IsValidIndex(Slot) ? Deposits[Slot] : nullptr; }
+    const UDepositDefinition* GetDepositTypeAtSlot(int32 Slot) const { return DepositTypes.IsValidIndex(Slot) ? DepositTypes[Slot] : nullptr; }
+
+private:
+    FVector GetSlotLocation(int32 Slot) const;
+    FDepositSpatialHash& GetOrCreateTypeIndex(const UDepositDefinition* DepositType);
+    void RemoveFromIndexes(int32 Slot);
+    void AddToIndexes(int32 Slot);
+
+    // === SOA STORAGE ===
+    UPROPERTY()
+    TArray<AResourceDeposit*> Deposits;
+
+    TArray<const UDepositDefinition*> DepositTypes;
+    TArray<float> PositionsX;
+    TArray<float> PositionsY;
+    TArray<float> PositionsZ;
+
+    TMap<const AResourceDeposit*, int32> SlotByDeposit;
+
+    // === SPATIAL INDEXES ===
+    FDepositSpatialHash AllDepositsIndex;
+    TMap<const UDepositDefinition*, FDepositSpatialHash> DepositsByTypeIndex;
+    TMap<const UDepositDefinition*, float> CellSizeByType;
+
+    static constexpr float DefaultCellSize = 2000.0f;
+};
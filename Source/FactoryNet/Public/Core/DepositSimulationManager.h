@@ -0,0 +1,164 @@
+// DepositSimulationManager.h
+// Lokalizacja: Source/FactoryNet/Public/Core/DepositSimulationManager.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Core/DepositSpatialHash.h"
+#include "DepositSimulationManager.generated.h"
+
+// Forward declarations
+class AActor;
+class AResourceDeposit;
+class UDepositDefinition;
+class UInstancedStaticMeshComponent;
+class UPrimitiveComponent;
+
+// Deposit without an actor - everything AResourceDeposit needs to be recreated on promotion
+struct FDepositSimulationRecord
+{
+    UDepositDefinition* DepositDefinition = nullptr;
+    FVector Location = FVector::ZeroVector;
+    int32 Level = 1;
+
+    // Stan na chwilę LastUpdateTime - dalej liczony w formie zamkniętej (SyncRecord)
+    int32 Reserves = 0;
+    int32 StoredAmount = 0;
+    int32 MaxStorage = 0;
+    float ExtractionRate = 0.0f;    // 0 = no auto extraction
+    double ExtractionRemainder = 0.0;
+    double LastUpdateTime = 0.0;
+    bool bRenewable = false;
+
+    // Instance in the (definition, level) batch; INDEX_NONE while promoted or without a mesh
+    int32 BatchIndex = INDEX_NONE;
+    int32 InstanceIndex = INDEX_NONE;
+
+    TWeakObjectPtr<AResourceDeposit> PromotedActor;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnSimulatedDepositPromoted, int32, DepositId, AResourceDeposit*, Deposit);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSimulatedDepositDemoted, int32, DepositId);
+
+/**
+ * Actor-free deposits: each one is a record here and an instance in one UInstancedStaticMeshComponent
+ * per (UDepositDefinition, level), all owned by a single proxy actor.
+ *
+ * A record costs a few dozen bytes instead of an actor with four components and a tick. Extraction
+ * of a record is evaluated in closed form on demand (rate x elapsed time, clamped by reserves and
+ * storage - surplus is lost exactly as in the actor's tick), so records need no tick either.
+ *
+ * When a player interacts with or builds on a deposit, PromoteDeposit spawns a full AResourceDeposit
+ * with the record's state and hides its instance; DemoteDeposit folds the actor back into the record.
+ * Deposit IDs are stable for the lifetime of the record.
+ */
+UCLASS()
+class FACTORYNET_API UDepositSimulationManager : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    UDepositSimulationManager();
+
+    // USubsystem Interface
+    virtual void Deinitialize() override;
+
+    // === RECORDS ===
+    // Returns the new deposit ID or INDEX_NONE
+    UFUNCTION(BlueprintCallable, Category = "Deposit Simulation")
+    int32 AddDeposit(UDepositDefinition* DepositDefinition, const FVector& Location, int32 Level = 1);
+
+    // Also destroys the promoted actor, if any
+    UFUNCTION(BlueprintCallable, Category = "Deposit Simulation")
+    bool RemoveDeposit(int32 DepositId);
+
+    UFUNCTION(BlueprintCallable, Category = "Deposit Simulation")
+    void ClearAllDeposits();
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Deposit Simulation")
+    int32 GetNumDeposits() const { return Records.Num(); }
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Deposit Simulation")
+    int32 GetNumPromotedDeposits() const { return DepositIdByActor.Num(); }
+
+    // Brought up to the current time; nullptr for an invalid ID
+    const FDepositSimulationRecord* GetDepositRecord(int32 DepositId);
+
+    // Cell size for the per-type index (usually the spawn rule's MinDistanceFromOthers)
+    void SetDepositTypeCellSize(const UDepositDefinition* DepositType, float CellSize);
+
+    // === PROMOTION ===
+    // Spawns (or returns the already promoted) full actor for the deposit
+    UFUNCTION(BlueprintCallable, Category = "Deposit Simulation")
+    AResourceDeposit* PromoteDeposit(int32 DepositId);
+
+    // Nearest deposit within Radius - e.g. where the player clicked or placed a building
+    UFUNCTION(BlueprintCallable, Category = "Deposit Simulation")
+    AResourceDeposit* PromoteDepositNear(const FVector& Location, float Radius = 1000.0f);
+
+    // Back to a record + instance; the actor is destroyed. False for actors not promoted here.
+    UFUNCTION(BlueprintCallable, Category = "Deposit Simulation")
+    bool DemoteDeposit(AResourceDeposit* Deposit);
+
+    // Hit.Component + Hit.Item of a trace against the instanced proxies
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Deposit Simulation")
+    int32 FindDepositForInstance(const UPrimitiveComponent* Component, int32 InstanceIndex) const;
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Deposit Simulation")
+    int32 FindDepositForActor(const AResourceDeposit* Deposit) const;
+
+    // === QUERIES ===
+    // Includes promoted deposits (their record keeps the location)
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Deposit Simulation")
+    bool IsAnyDepositOfTypeWithinRadius(const FVector& Location, float Radius, const UDepositDefinition* DepositType) const;
+
+    // DepositType == nullptr searches all deposits; INDEX_NONE when nothing is within MaxRadius
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Deposit Simulation")
+    int32 FindNearestDeposit(const FVector& Location, const UDepositDefinition* DepositType = nullptr, float MaxRadius = 1000000.0f) const;
+
+    // === EVENTS ===
+    UPROPERTY(BlueprintAssignable, Category = "Events")
+    FOnSimulatedDepositPromoted OnDepositPromoted;
+
+    UPROPERTY(BlueprintAssignable, Category = "Events")
+    FOnSimulatedDepositDemoted OnDepositDemoted;
+
+private:
+    void SyncRecord(FDepositSimulationRecord& Record, double Now) const;
+    void ResetExtractionState(FDepositSimulationRecord& Record) const;
+    double GetSimulationTime() const;
+
+    // === INSTANCING ===
+    int32 GetOrCreateBatch(UDepositDefinition* DepositDefinition, int32 Level);
+    void AddInstance(int32 DepositId);
+    void RemoveInstance(int32 DepositId);
+    AActor* GetOrCreateProxyActor();
+
+    UFUNCTION()
+    void HandlePromotedDepositDestroyed(AActor* DestroyedActor);
+
+    // === RECORD STORAGE ===
+    TSparseArray<FDepositSimulationRecord> Records;
+    TMap<const AResourceDeposit*, int32> DepositIdByActor;
+
+    // Definicje trzymane przy życiu - rekordy to zwykłe structy, GC ich nie widzi
+    UPROPERTY()
+    TSet<UDepositDefinition*> ReferencedDefinitions;
+
+    // === SPATIAL INDEXES ===
+    FDepositSpatialHash AllDepositsIndex;
+    TMap<const UDepositDefinition*, FDepositSpatialHash> DepositsByTypeIndex;
+    TMap<const UDepositDefinition*, float> CellSizeByType;
+
+    // === INSTANCED PROXIES ===
+    UPROPERTY()
+    AActor* ProxyActor;
+
+    UPROPERTY()
+    TArray<UInstancedStaticMeshComponent*> BatchComponents;  // nullptr for batches without a mesh
+
+    TArray<TArray<int32>> BatchDepositIds;  // instance index -> deposit ID
+    TMap<TPair<const UDepositDefinition*, int32>, int32> BatchByKey;
+
+    static constexpr float DefaultCellSize = 2000.0f;
+};
@@ -0,0 +1,73 @@
+// DepositSpatialHash.h
+// Lokalizacja: Source/FactoryNet/Public/Core/DepositSpatialHash.h
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Uniform hashed grid over the XY plane for deposit proximity queries.
+ * Elements are identified by caller-owned integer IDs (e.g. an index into SpawnedDeposits).
+ * Distances are full 3D, cells are 2D - deposits sit on terrain, so Z never spans many cells.
+ *
+ * With CellSize equal to the typical query radius, radius checks touch a 3x3 block of cells.
+ * Nearest and k-nearest queries expand ring by ring and stop once no unvisited cell can
+ * hold anything closer than what was already found.
+ */
+class FACTORYNET_API FDepositSpatialHash
+{
+public:
+    explicit FDepositSpatialHash(float InCellSize = 2000.0f);
+
+    // === CONFIGURATION ===
+    // Changing the cell size re-buckets all stored elements
+    void SetCellSize(float NewCellSize);
+    float GetCellSize() const { return CellSize; }
+
+    // === MODIFICATION ===
+    void Add(int32 ElementId, const FVector& Location);
+    bool Remove(int32 ElementId, const FVector& Location);
+    bool Update(int32 ElementId, const FVector& OldLocation, const FVector& NewLocation);
+    void Reset();
+
+    int32 Num() const { return NumElements; }
+    int32 NumCells() const { return Cells.Num(); }
+
+    // === QUERIES ===
+    // Filter returns false for elements that should be ignored (e.g. destroyed actors)
+    bool AnyWithinRadius(const FVector& Location, float Radius) const;
+    bool AnyWithinRadius(const FVector& Location, float Radius, TFunctionRef<bool(int32)> Filter) const;
+
+    void QueryRadius(const FVector& Location, float Radius, TArray<int32>& OutElementIds) const;
+    void QueryRadius(const FVector& Location, float Radius, TArray<int32>& OutElementIds, TFunctionRef<bool(int32)> Filter) const;
+
+    // Returns INDEX_NONE when nothing passes the filter within MaxRadius
+    int32 FindNearest(const FVector& Location, float MaxRadius = MAX_flt, float* OutDistance = nullptr) const;
+    int32 FindNearest(const FVector& Location, TFunctionRef<bool(int32)> Filter, float MaxRadius = MAX_flt, float* OutDistance = nullptr) const;
+
+    // Results sorted by ascending distance
+    void FindKNearest(const FVector& Location, int32 K, TArray<int32>& OutElementIds, float MaxRadius = MAX_flt) const;
+    void FindKNearest(const FVector& Location, int32 K, TArray<int32>& OutElementIds, TFunctionRef<bool(int32)> Filter, float MaxRadius = MAX_flt) const;
+
+private:
+    struct FEntry
+    {
+        FVector Location;
+        int32 ElementId;
+    };
+
+    FIntPoint GetCellCoord(const FVector& Location) const;
+    int32 GetMaxUsefulRing(const FIntPoint& Center) const;
+
+    // Calls Visitor for every occupied cell on the square ring of the given radius (in cells)
+    void ForEachCellInRing(const FIntPoint& Center, int32 Ring, TFunctionRef<void(const TArray<FEntry>&)> Visitor) const;
+
+    TMap<FIntPoint, TArray<FEntry>> Cells;
+
+    float CellSize;
+    float InvCellSize;
+    int32 NumElements;
+
+    // Conservative bounds of occupied cells (not shrunk on removal) - caps ring expansion
+    FIntPoint MinCell;
+    FIntPoint MaxCell;
+};
@@ -0,0 +1,83 @@
+// DepositSpawnBenchmarkCommandlet.h
+// Lokalizacja: Source/FactoryNet/Public/Core/DepositSpawnBenchmarkCommandlet.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "Core/DepositSpawnManager.h"
+#include "DepositSpawnBenchmarkCommandlet.generated.h"
+
+// One scenario of the benchmark (placement mode x area x rule set)
+struct FDepositSpawnBenchmarkResult
+{
+    FString PlacementMode;
+    float AreaSide = 0.0f;
+    int32 RuleCount = 0;
+    int32 GridResolution = 0;
+    bool bSimulationRecords = false;
+    FDepositGenerationStats Stats;
+
+    double WallSeconds = 0.0;
+    double CandidatesPerSecond = 0.0;
+    double SpawnedPerSecond = 0.0;
+
+    // Średni koszt pojedynczego zapytania (IsValidSpawnLocation = reguły terenu + dystans w rejestrze)
+    int32 QueryCount = 0;
+    double ValidSpawnLocationQueryUs = 0.0;
+    double NearestDepositQueryUs = 0.0;
+
+    double UsedPhysicalDeltaMB = 0.0;
+
+    // Peak of the whole process so far (editor startup and earlier scenarios included), not of this scenario -
+    // only a ceiling; UsedPhysicalDeltaMB is the per-scenario number
+    double ProcessPeakUsedPhysicalMB = 0.0;
+
+    // Sprawdzenie wyniku (aktorzy; rekordy symulacji nie trafiają do SpawnedDeposits)
+    int32 MaxCountViolations = 0;       // rules that spawned more than MaxDepositCount
+    int32 SpacingViolations = 0;        // same-type deposits closer than MinDistanceFromOthers
+};
+
+/**
+ * Headless benchmark of the deposit spawn path - GenerateDepositsOnMap, registry distance checks and
+ * GetNearestDepositOfType - on synthetic spawn areas and rule sets. Each scenario runs in a fresh,
+ * empty game world, so the numbers do not depend on the loaded map.
+ *
+ * UnrealEditor-Cmd FactoryNet.uproject -run=DepositSpawnBenchmark -nullrhi -unattended
+ *     [-Scales=50000,200000,500000] [-RuleCounts=2,8] [-Modes=Grid,Poisson]
+ *     [-CandidateSpacing=500] [-Queries=10000] [-Seed=1337] [-Records] [-Output=<path>.csv|.json]
+ *
+ * -Records spawns deposits as UDepositSimulationManager records (instanced proxies) instead of actors.
+ *
+ * Without -Output the report goes to Saved/Benchmarks/DepositSpawnBenchmark_<timestamp>.csv.
+ * Returns 0 on success, 1 when a scenario could not run or the report could not be written.
+ *
+ * The FactoryNet.DepositSpawn.Benchmark automation tests run the same scenarios through RunScenario.
+ */
+UCLASS()
+class FACTORYNET_API UDepositSpawnBenchmarkCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UDepositSpawnBenchmarkCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+
+    // === SCENARIOS (shared with the automation tests) ===
+    static const TArray<float>& GetDefaultScales();
+    static const TArray<int32>& GetDefaultRuleCounts();
+
+    // Runs one scenario in a fresh game world; false if it could not run or spawned nothing
+    static bool RunScenario(EDepositPlacementMode PlacementMode, float AreaSide, int32 RuleCount, float CandidateSpacing,
+                            int32 QueryCount, int32 Seed, bool bSimulationRecords, FDepositSpawnBenchmarkResult& OutResult);
+
+    // === REPORT ===
+    static FString FormatSummary(const FDepositSpawnBenchmarkResult& Result);
+    static FString FormatCsv(const TArray<FDepositSpawnBenchmarkResult>& Results);
+    static FString FormatJson(const TArray<FDepositSpawnBenchmarkResult>& Results);
+
+private:
+    static TArray<FDepositSpawnRule> MakeSyntheticRules(int32 RuleCount, float AreaSide, TArray<UDepositDefinition*>& OutDefinitions);
+    static void ValidateSpawnedDeposits(const UDepositSpawnManager& SpawnManager, const TArray<FDepositSpawnRule>& Rules,
+                                        FDepositSpawnBenchmarkResult& OutResult);
+};
@@ -6,12 +6,19 @@
 #include "Subsystems/WorldSubsystem.h"
 #include "Engine/DataTable.h"
 #include "Data/DepositDefinition.h"
+#include "Core/DepositTerrainRaster.h"
+#include "TimerManager.h"
+#include <atomic>
 #include "DepositSpawnManager.generated.h"
 
 // Forward declarations
 class AResourceDeposit;
 class UDataTableManager;
+class UDepositRegistry;
+class UDepositSimulationManager;
+class UDepositMeshStreamer;
 class UDepositDefinition;
+struct FDepositAsyncGeneration;
 // class ALandscape; // Commented out - not used yet
 
 UENUM(BlueprintType)
@@ -35,6 +42,13 @@ enum class ETerrainType : uint8
     Wetlands    UMETA(DisplayName = "Wetlands (Mokradła)")
 };
 
+UENUM(BlueprintType)
+enum class EDepositPlacementMode : uint8
+{
+    JitteredGrid    UMETA(DisplayName = "Jittered Grid (Siatka)"),
+    PoissonDisk     UMETA(DisplayName = "Poisson Disk (Blue Noise)")
+};
+
 USTRUCT(BlueprintType)
 struct FACTORYNET_API FDepositSpawnRule
 {
@@ -119,9 +133,79 @@ struct FACTORYNET_API FSpawnedDepositInfo
     float Elevation;
 };
 
+/**
+ * Jittered spawn candidates on a regular grid, stored row-major (Index = Y * NumX + X).
+ * The grid is split into square tiles of TileSize cells - each tile is one ParallelFor work item
+ * with its own random stream, so results do not depend on the number of worker threads.
+ */
+struct FDepositCandidateGrid
+{
+    TArray<FVector> Locations;
+
+    int32 NumX = 0;
+    int32 NumY = 0;
+    int32 TileSize = 32;
+    int32 NumTilesX = 0;
+    int32 NumTilesY = 0;
+
+    int32 NumTiles() const { return NumTilesX * NumTilesY; }
+
+    // Half-open range [OutMin, OutMax) of grid cells covered by a tile
+    void GetTileBounds(int32 TileIndex, FIntPoint& OutMin, FIntPoint& OutMax) const
+    {
+        OutMin = FIntPoint((TileIndex % NumTilesX) * TileSize, (TileIndex / NumTilesX) * TileSize);
+        OutMax = FIntPoint(FMath::Min(OutMin.X + TileSize, NumX), FMath::Min(OutMin.Y + TileSize, NumY));
+    }
+};
+
+// Deposit chosen by the planning pass, spawned later on the game thread
+struct FPlannedDepositSpawn
+{
+    UDepositDefinition* DepositDefinition = nullptr;
+    FVector Location = FVector::ZeroVector;
+    float MinDistanceFromOthers = 0.0f;
+};
+
+// Snapshot of everything the planning pass reads - safe to hand over to a worker thread
+struct FDepositSpawnPlanSettings
+{
+    TArray<FDepositSpawnRule> SpawnRules;
+    FVector SpawnAreaCenter = FVector::ZeroVector;
+    FVector SpawnAreaSize = FVector::ZeroVector;
+    EDepositPlacementMode PlacementMode = EDepositPlacementMode::JitteredGrid;
+    int32 GridResolution = 100;
+    int32 MaxSpawnAttempts = 1000;
+    int32 GenerationSeed = 0;
+
+    // false off the game thread - the registry is checked again right before each spawn
+    bool bCheckExistingDeposits = true;
+
+    // Polled between rules, set from the game thread to abandon the plan
+    const std::atomic<bool>* CancelRequested = nullptr;
+
+    bool IsCancelled() const { return CancelRequested && CancelRequested->load(std::memory_order_relaxed); }
+};
+
+// Counts and timings of the last finished generation (sync or async) - read by the spawn benchmark
+struct FDepositGenerationStats
+{
+    int32 GenerationSeed = 0;
+
+    // Grid: grid cells x rules evaluated; Poisson: samples drawn by the sampler
+    int32 CandidateCount = 0;
+    int32 PlannedCount = 0;
+    int32 SpawnedCount = 0;
+
+    // Terrain bake + planning / SpawnActor calls (async: sum of the per-frame slices)
+    double PlanSeconds = 0.0;
+    double SpawnSeconds = 0.0;
+};
+
 // Delegate declarations
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnDepositSpawned, AResourceDeposit*, SpawnedDeposit, FVector, SpawnLocation);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnAllDepositsSpawned, const TArray<FSpawnedDepositInfo>&, SpawnedDeposits);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnDepositGenerationProgress, float, Progress, int32, SpawnedCount);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnAllDepositsCleared);
 
 UCLASS(BlueprintType)
 class FACTORYNET_API UDepositSpawnManager : public UWorldSubsystem
@@ -142,6 +226,22 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Deposit Spawning")
     void ClearAllSpawnedDeposits();
 
+    // Plan liczony na workerze, aktory spawnowane na game thread w budżecie SpawnBudgetMs na klatkę.
+    // Kończy się OnAllDepositsSpawned, postęp przez OnDepositGenerationProgress.
+    UFUNCTION(BlueprintCallable, Category = "Deposit Spawning")
+    void GenerateDepositsOnMapAsync(float SpawnBudgetMs = 2.0f);
+
+    // Usuwa złoża w budżecie na klatkę, bez generowania nowych
+    UFUNCTION(BlueprintCallable, Category = "Deposit Spawning")
+    void ClearAllSpawnedDepositsAsync(float SpawnBudgetMs = 2.0f);
+
+    // Złoża już zespawnowane zostają; nieusunięte wracają do listy spawnu
+    UFUNCTION(BlueprintCallable, Category = "Deposit Spawning")
+    void CancelDepositGeneration();
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Deposit Spawning")
+    bool IsGeneratingDeposits() const { return AsyncGeneration.IsValid(); }
+
     UFUNCTION(BlueprintCallable, Category = "Deposit Spawning")
     AResourceDeposit* SpawnDepositAtLocation(UDepositDefinition* DepositDef, 
                                            const FVector& Location, 
@@ -160,10 +260,39 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Configuration")
     void SetDepositDensity(EDepositDensity NewDensity);
 
+    UFUNCTION(BlueprintCallable, Category = "Configuration")
+    void SetPlacementMode(EDepositPlacementMode NewPlacementMode);
+
+    // Ten sam seed = identyczny układ złóż niezależnie od liczby wątków (serwer i klienci generują lokalnie)
+    UFUNCTION(BlueprintCallable, Category = "Configuration")
+    void SetSpawnSeed(int32 NewSpawnSeed, bool bNewRandomizeSeed = false);
+
+    // Seed użyty przez ostatnie GenerateDepositsOnMap (także wylosowany przy bRandomizeSeed)
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Configuration")
+    int32 GetLastGenerationSeed() const { return LastGenerationSeed; }
+
+    // true = złoża jako rekordy UDepositSimulationManager (instancje ISM), AResourceDeposit dopiero po awansie
+    UFUNCTION(BlueprintCallable, Category = "Configuration")
+    void SetSpawnAsSimulationRecords(bool bNewSpawnAsSimulationRecords);
+
+    // Rozdzielczość siatki kandydatów (na dłuższy bok obszaru) i limit prób na regułę
+    UFUNCTION(BlueprintCallable, Category = "Configuration")
+    void SetCandidateGrid(int32 NewGridResolution, int32 NewMaxSpawnAttempts);
+
+    const FDepositGenerationStats& GetLastGenerationStats() const { return LastGenerationStats; }
+
     // ✅ DODANO: Debug testing function
     UFUNCTION(BlueprintCallable, Category = "Debug")
     void TestProbabilityGeneration(float TestProbability = 0.5f, int32 TestCount = 100);
 
+    // Syntetyczny raster (równina, stok, woda) - sprawdza, że reguły terenu faktycznie odrzucają kandydatów
+    UFUNCTION(BlueprintCallable, Category = "Debug")
+    bool TestTerrainRuleFiltering();
+
+    // Porównanie spatial hash vs liniowy skan dla 1k / 10k / 100k złóż (bez spawnowania aktorów)
+    UFUNCTION(BlueprintCallable, Category = "Debug")
+    void BenchmarkProximityQueries(int32 QueryCount = 1000, float MinDistance = 2000.0f);
+
     // === QUERY FUNCTIONS ===
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Query")
     TArray<AResourceDeposit*> GetAllSpawnedDeposits() const;
@@ -190,6 +319,13 @@ public:
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Terrain")
     bool IsValidSpawnLocation(const FVector& Location, const FDepositSpawnRule& SpawnRule) const;
 
+    // Wypala wysokości, typy terenu i odległość od wody dla obszaru spawnu (generacja robi to sama po SetSpawnArea)
+    UFUNCTION(BlueprintCallable, Category = "Terrain")
+    bool BakeTerrainRaster();
+
+    // Elevation, water and terrain-type constraints of a rule; always true without a baked raster
+    static bool PassesTerrainRules(const FDepositTerrainRaster& Raster, const FVector& Location, const FDepositSpawnRule& SpawnRule);
+
     // === EVENTS ===
     UPROPERTY(BlueprintAssignable, Category = "Events")
     FOnDepositSpawned OnDepositSpawned;
@@ -197,6 +333,13 @@ public:
     UPROPERTY(BlueprintAssignable, Category = "Events")
     FOnAllDepositsSpawned OnAllDepositsSpawned;
 
+    UPROPERTY(BlueprintAssignable, Category = "Events")
+    FOnDepositGenerationProgress OnDepositGenerationProgress;
+
+    // ClearAllSpawnedDepositsAsync destroyed the last deposit (ClearAllSpawnedDeposits is synchronous)
+    UPROPERTY(BlueprintAssignable, Category = "Events")
+    FOnAllDepositsCleared OnAllDepositsCleared;
+
 protected:
     // === SPAWN CONFIGURATION ===
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spawn Configuration")
@@ -211,11 +354,42 @@ protected:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spawn Area")
     FVector SpawnAreaSize = FVector(50000.0f, 50000.0f, 10000.0f);
 
+    // PoissonDisk: odstępy gwarantowane przez sampler, MaxSpawnAttempts i GridResolution są ignorowane
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spawn Configuration")
+    EDepositPlacementMode PlacementMode = EDepositPlacementMode::JitteredGrid;
+
+    // Strumienie reguł i kafelków są wyprowadzane z tego seeda (HashCombine), nigdy z globalnego FMath::Rand
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spawn Configuration")
+    int32 SpawnSeed = 0;
+
+    // true = nowy seed przy każdej generacji (odczyt przez GetLastGenerationSeed)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spawn Configuration")
+    bool bRandomizeSeed = true;
+
+    // Na regułę: liczba wylosowanych kandydatów siatki, łącznie z odrzuconymi (prawdopodobieństwo, teren, dystans)
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spawn Configuration")
     int32 MaxSpawnAttempts = 1000;
 
+    // Rekordy nie trafiają do SpawnedDeposits ani OnDepositSpawned - patrz UDepositSimulationManager
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spawn Configuration")
+    bool bSpawnAsSimulationRecords = false;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spawn Configuration")
     int32 GridResolution = 100;
+
+    // === TERRAIN RASTER ===
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Terrain", meta = (ClampMin = "50.0"))
+    float TerrainRasterCellSize = 500.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Terrain")
+    TEnumAsByte<ECollisionChannel> TerrainTraceChannel = ECC_WorldStatic;
+
+    // Poza poziomem morza woda = trafienia w aktory / komponenty z tagiem "Water"
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Terrain")
+    bool bUseSeaLevel = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Terrain", meta = (EditCondition = "bUseSeaLevel"))
+    float SeaLevel = 0.0f;
     
 
     // === RUNTIME DATA ===
@@ -225,13 +399,54 @@ protected:
     UPROPERTY()
     UDataTableManager* DataTableManager;
 
+    UPROPERTY()
+    UDepositRegistry* DepositRegistry;
+
+    UPROPERTY()
+    UDepositSimulationManager* SimulationManager;
+
+    UPROPERTY()
+    UDepositMeshStreamer* MeshStreamer;
+
+    int32 LastGenerationSeed = 0;
+    FDepositGenerationStats LastGenerationStats;
+
+    FDepositTerrainRaster TerrainRaster;
+    bool bTerrainRasterDirty = true;
+
+    // === ASYNC GENERATION ===
+    // Trzyma definicje złóż przy życiu, dopóki worker planuje na kopii reguł
+    UPROPERTY()
+    TArray<FDepositSpawnRule> AsyncSpawnRules;
+
+    UPROPERTY()
+    TArray<FSpawnedDepositInfo> DepositsPendingDestroy;
+
+    TSharedPtr<FDepositAsyncGeneration> AsyncGeneration;
+    FTimerHandle AsyncGenerationTimerHandle;
+
 private:
     // === INTERNAL FUNCTIONS ===
     void LoadDefaultSpawnRules();
     void CreateFallbackSpawnRules();
-    TArray<FVector> GenerateSpawnCandidates();
+    // Randomizes SpawnSeed if bRandomizeSeed and records it as LastGenerationSeed
+    int32 PickGenerationSeed();
+    FDepositSpawnPlanSettings MakePlanSettings(int32 GenerationSeed, bool bCheckExistingDeposits);
+    bool RebuildTerrainRaster();
+    // Returns the number of candidates evaluated (see FDepositGenerationStats::CandidateCount)
+    int32 BuildSpawnPlan(const FDepositSpawnPlanSettings& Settings, TArray<FPlannedDepositSpawn>& OutSpawnPlan) const;
+    void GenerateSpawnCandidates(const FDepositSpawnPlanSettings& Settings, FDepositCandidateGrid& OutCandidateGrid) const;
+    void PlanSpawnsForRule(const FDepositSpawnPlanSettings& Settings, int32 RuleIndex, const FDepositCandidateGrid& CandidateGrid, TArray<FPlannedDepositSpawn>& OutSpawnPlan) const;
+    int32 PlanSpawnsPoissonDisk(const FDepositSpawnPlanSettings& Settings, TArray<FPlannedDepositSpawn>& OutSpawnPlan) const;
+
+    // Spawns from InOutNextIndex until the plan ends or Deadline (FPlatformTime::Seconds) passes - always at least one
+    int32 ExecuteSpawnPlan(const TArray<FPlannedDepositSpawn>& SpawnPlan, int32& InOutNextIndex, double Deadline, bool bValidateAgainstRegistry);
+
+    void StartAsyncGeneration(float SpawnBudgetMs, bool bGenerateAfterClear);
+    void TickAsyncGeneration();
+    void FinishAsyncGeneration(bool bGenerated);
     bool ValidateSpawnLocation(const FVector& Location, const FDepositSpawnRule& Rule);
-    UDepositDefinition* SelectDepositTypeForLocation(const FVector& Location);
+    UDepositDefinition* SelectDepositTypeForLocation(const FVector& Location, FRandomStream& RandomStream);
     void SpawnDepositFromRule(const FDepositSpawnRule& Rule, const FVector& Location);
     
     // Terrain analysis helpers
@@ -0,0 +1,81 @@
+// DepositTerrainRaster.h
+// Lokalizacja: Source/FactoryNet/Public/Core/DepositTerrainRaster.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+
+// Forward declarations
+class UWorld;
+enum class ETerrainType : uint8;
+
+// Thresholds used to derive ETerrainType from the baked heightfield
+struct FDepositTerrainClassification
+{
+    float HillSlopeDegrees = 12.0f;
+    float MountainSlopeDegrees = 30.0f;
+    float HillElevation = 1000.0f;
+    float MountainElevation = 3000.0f;
+
+    // Land cells closer to water than this are Coastline
+    float CoastlineDistance = 1500.0f;
+};
+
+/**
+ * Heightfield, terrain class and distance-to-water for the spawn area, baked once.
+ *
+ * Baking traces one ray per cell; afterwards every spawn check is a raster lookup (bilinear for
+ * elevation, nearest cell for everything else). Distance to water comes from a two-pass chamfer
+ * transform, so the whole bake is linear in the number of cells.
+ *
+ * The raster is immutable between bakes - queries are safe from worker threads.
+ */
+class FACTORYNET_API FDepositTerrainRaster
+{
+public:
+    // Water = below SeaLevel (when bUseSeaLevel) or a hit on an actor / component tagged "Water".
+    // Cells without a hit keep the area's center height and count as dry land.
+    bool BakeFromWorld(UWorld* World, const FBox& SpawnArea, float InCellSize, ECollisionChannel TraceChannel,
+                       bool bUseSeaLevel, float SeaLevel,
+                       const FDepositTerrainClassification& Classification = FDepositTerrainClassification());
+
+    // Derives slope, terrain class and water distance from raw cell-center samples (row-major, InWidth x InHeight)
+    void BuildFromHeightfield(const FBox2D& InBounds, float InCellSize, int32 InWidth, int32 InHeight,
+                              TArray<float> InHeights, const TArray<bool>& InWaterMask,
+                              const FDepositTerrainClassification& Classification = FDepositTerrainClassification());
+
+    void Reset();
+
+    bool IsBaked() const { return Width > 0 && Height > 0; }
+    const FBox2D& GetBounds() const { return Bounds; }
+    float GetCellSize() const { return CellSize; }
+    int32 GetNumCells() const { return Width * Height; }
+
+    // === QUERIES ===
+    // Locations outside the raster are clamped to the border cells
+    float SampleElevation(const FVector& Location) const;
+    float SampleSlopeDegrees(const FVector& Location) const;
+    ETerrainType SampleTerrainType(const FVector& Location) const;
+    bool IsWater(const FVector& Location) const;
+
+    // 0 inside water, MAX_flt when the raster has no water at all
+    float SampleDistanceToWater(const FVector& Location) const;
+
+private:
+    int32 GetCellIndex(const FVector& Location) const;
+    float GetCellHeight(int32 X, int32 Y) const;
+    void ComputeSlopes();
+    void ComputeDistanceToWater();
+    void ClassifyCells(const FDepositTerrainClassification& Classification);
+
+    FBox2D Bounds = FBox2D(ForceInit);
+    float CellSize = 0.0f;
+    int32 Width = 0;
+    int32 Height = 0;
+
+    TArray<float> Heights;
+    TArray<float> Slopes;
+    TArray<float> WaterDistances;
+    TArray<uint8> WaterCells;
+    TArray<uint8> TerrainTypes;
+};
@@ -0,0 +1,110 @@
+// ExtractionAccumulator.h
+// Lokalizacja: Source/FactoryNet/Public/Core/ExtractionAccumulator.h
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Fractional production counter for a constant-rate extractor.
+ *
+ * Instead of rounding Rate * Interval on every extraction (which loses or invents the remainder),
+ * production is evaluated from an anchor: Produced = floor(AnchorCarry + Rate * ElapsedSinceAnchor).
+ * Whole units are handed out by Collect() and the fraction stays in the counter, so the total is the
+ * same whether time is fed in 60 small steps or one 10 s step - coarser ticks no longer change balance.
+ *
+ * SetRate re-anchors and keeps everything produced (whole or fractional) so far at the old rate.
+ */
+struct FExtractionAccumulator
+{
+public:
+    FExtractionAccumulator() = default;
+    explicit FExtractionAccumulator(double InRate) : Rate(FMath::Max(0.0, InRate)) {}
+
+    // === TIME ===
+    FORCEINLINE void AddTime(double DeltaSeconds)
+    {
+        ElapsedSinceAnchor += FMath::Max(0.0, DeltaSeconds);
+    }
+
+    // Whole units produced since the previous Collect()
+    FORCEINLINE int64 Collect()
+    {
+        const int64 Produced = GetProducedSinceAnchor();
+        const int64 NewUnits = Produced - CollectedSinceAnchor;
+        CollectedSinceAnchor = Produced;
+        return NewUnits;
+    }
+
+    // Catch-up in O(1): advance by an arbitrary delta and collect
+    FORCEINLINE int64 Advance(double DeltaSeconds)
+    {
+        AddTime(DeltaSeconds);
+        return Collect();
+    }
+
+    // === RATE ===
+    void SetRate(double NewRate)
+    {
+        NewRate = FMath::Max(0.0, NewRate);
+        if (NewRate == Rate)
+        {
+            return;
+        }
+
+        AnchorCarry = GetPendingUnits();
+        ElapsedSinceAnchor = 0.0;
+        CollectedSinceAnchor = 0;
+        Rate = NewRate;
+    }
+
+    void Reset(double NewRate = 0.0)
+    {
+        *this = FExtractionAccumulator(NewRate);
+    }
+
+    // === QUERIES ===
+    double GetRate() const { return Rate; }
+
+    // Produced but not yet collected (whole + fractional part)
+    double GetPendingUnits() const
+    {
+        return AnchorCarry + Rate * ElapsedSinceAnchor - static_cast<double>(CollectedSinceAnchor);
+    }
+
+    // Whole units a Collect() would return after ExtraSeconds more (closed form, nothing is modified)
+    int64 PeekUnits(double ExtraSeconds = 0.0) const
+    {
+        return GetProducedSinceAnchor(FMath::Max(0.0, ExtraSeconds)) - CollectedSinceAnchor;
+    }
+
+    // Time until PeekUnits() reaches Units; MAX_dbl when the rate is zero
+    double GetSecondsUntilUnits(int64 Units) const
+    {
+        if (PeekUnits() >= Units)
+        {
+            return 0.0;
+        }
+
+        if (Rate <= 0.0)
+        {
+            return MAX_dbl;
+        }
+
+        const double TargetProduced = static_cast<double>(Units + CollectedSinceAnchor) - ProductionEpsilon;
+        return FMath::Max(0.0, (TargetProduced - AnchorCarry) / Rate - ElapsedSinceAnchor);
+    }
+
+private:
+    FORCEINLINE int64 GetProducedSinceAnchor(double ExtraSeconds = 0.0) const
+    {
+        // Epsilon chroni przed 2.9999999 przy sumowaniu wielu małych kroków czasu
+        return static_cast<int64>(FMath::FloorToDouble(AnchorCarry + Rate * (ElapsedSinceAnchor + ExtraSeconds) + ProductionEpsilon));
+    }
+
+    static constexpr double ProductionEpsilon = 1e-9;
+
+    double Rate = 0.0;
+    double ElapsedSinceAnchor = 0.0;
+    double AnchorCarry = 0.0;
+    int64 CollectedSinceAnchor = 0;
+};
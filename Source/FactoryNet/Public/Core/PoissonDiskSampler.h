@@ -0,0 +1,38 @@
+// PoissonDiskSampler.h
+// Lokalizacja: Source/FactoryNet/Public/Core/PoissonDiskSampler.h
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Bridson's Poisson-disk sampling over an axis-aligned rectangle in the XY plane.
+ *
+ * Every sample keeps at least Radius to all others, and the result is maximal: no gap larger than
+ * 2 * Radius stays empty. A background grid with cells of Radius / sqrt(2) holds at most one sample
+ * per cell, so each spacing test reads a 5x5 block and the whole run is O(N * CandidatesPerSample).
+ *
+ * The optional filter rejects candidates that already satisfy spacing (e.g. too close to deposits
+ * of other types with a different radius) - this is how variable radii are layered on top.
+ */
+class FACTORYNET_API FPoissonDiskSampler
+{
+public:
+    FPoissonDiskSampler(const FBox2D& InBounds, float InRadius, int32 InCandidatesPerSample = 30);
+
+    // Samples are appended in generation order (a growing front, not spatially shuffled)
+    void Generate(FRandomStream& RandomStream, TArray<FVector2D>& OutSamples) const;
+    void Generate(FRandomStream& RandomStream, TArray<FVector2D>& OutSamples, TFunctionRef<bool(const FVector2D&)> Filter) const;
+
+    float GetRadius() const { return Radius; }
+
+private:
+    FIntPoint GetCellCoord(const FVector2D& Point) const;
+    bool IsFarFromSamples(const FVector2D& Point, const TArray<int32>& Grid, const TArray<FVector2D>& Samples) const;
+
+    FBox2D Bounds;
+    float Radius;
+    float CellSize;
+    int32 CandidatesPerSample;
+    int32 GridWidth;
+    int32 GridHeight;
+};
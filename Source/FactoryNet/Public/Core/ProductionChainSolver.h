@@ -0,0 +1,191 @@
+// ProductionChainSolver.h
+// Lokalizacja: Source/FactoryNet/Public/Core/ProductionChainSolver.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataTable.h"
+#include "ProductionChainSolver.generated.h"
+
+// Forward declarations
+class UFactoryDefinition;
+
+// N factories of one definition and level running one recipe
+USTRUCT(BlueprintType)
+struct FACTORYNET_API FProductionChainGroup
+{
+    GENERATED_BODY()
+
+    FProductionChainGroup()
+    {
+        FactoryDefinition = nullptr;
+        Level = 1;
+        FactoryCount = 1;
+    }
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Production", meta = (RowType = "ProductionRecipe"))
+    FDataTableRowHandle RecipeReference;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Production")
+    UFactoryDefinition* FactoryDefinition;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Production")
+    int32 Level;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Production")
+    int32 FactoryCount;
+};
+
+// Resource entering the chain from outside (deposits, imports)
+USTRUCT(BlueprintType)
+struct FACTORYNET_API FProductionChainSupply
+{
+    GENERATED_BODY()
+
+    FProductionChainSupply()
+    {
+        RatePerSecond = 0.0f;
+    }
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Production", meta = (RowType = "ResourceTableRow"))
+    FDataTableRowHandle ResourceReference;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Production")
+    float RatePerSecond;
+};
+
+USTRUCT(BlueprintType)
+struct FACTORYNET_API FProductionChainGroupResult
+{
+    GENERATED_BODY()
+
+    FProductionChainGroupResult()
+    {
+        CapacityCyclesPerSecond = 0.0f;
+        CyclesPerSecond = 0.0f;
+        Utilization = 0.0f;
+        bIsBottleneck = false;
+    }
+
+    UPROPERTY(BlueprintReadOnly, Category = "Production")
+    FProductionChainGroup Group;
+
+    // All factories of the group together
+    UPROPERTY(BlueprintReadOnly, Category = "Production")
+    float CapacityCyclesPerSecond;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Production")
+    float CyclesPerSecond;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Production")
+    float Utilization;
+
+    // Input that holds the group below capacity (null when running at full capacity)
+    UPROPERTY(BlueprintReadOnly, Category = "Production")
+    FDataTableRowHandle LimitingResource;
+
+    // Runs at full capacity, yet some consumer of its output is limited by that output
+    UPROPERTY(BlueprintReadOnly, Category = "Production")
+    bool bIsBottleneck;
+};
+
+USTRUCT(BlueprintType)
+struct FACTORYNET_API FProductionChainResourceResult
+{
+    GENERATED_BODY()
+
+    FProductionChainResourceResult()
+    {
+        ProducedPerSecond = 0.0f;
+        ConsumedPerSecond = 0.0f;
+        SurplusPerSecond = 0.0f;
+        DeficitPerSecond = 0.0f;
+    }
+
+    UPROPERTY(BlueprintReadOnly, Category = "Production")
+    FDataTableRowHandle ResourceReference;
+
+    // Supply + production at the solved rates
+    UPROPERTY(BlueprintReadOnly, Category = "Production")
+    float ProducedPerSecond;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Production")
+    float ConsumedPerSecond;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Production")
+    float SurplusPerSecond;
+
+    // Missing to run every consumer at full capacity
+    UPROPERTY(BlueprintReadOnly, Category = "Production")
+    float DeficitPerSecond;
+};
+
+USTRUCT(BlueprintType)
+struct FACTORYNET_API FProductionChainSolution
+{
+    GENERATED_BODY()
+
+    FProductionChainSolution()
+    {
+        Iterations = 0;
+        bConverged = false;
+    }
+
+    UPROPERTY(BlueprintReadOnly, Category = "Production")
+    TArray<FProductionChainGroupResult> Groups;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Production")
+    TArray<FProductionChainResourceResult> Resources;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Production")
+    int32 Iterations;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Production")
+    bool bConverged;
+};
+
+/**
+ * Steady-state flow rates of a production chain without simulating it.
+ *
+ * The chain is a bipartite graph of groups (recipe x factory count, capacity in cycles/s) and resources.
+ * Each resource's availability (external supply + producers' rates) is shared among its consumers in
+ * proportion to what they could use given their other inputs; a group runs at the minimum its inputs allow,
+ * capped by capacity. Iterating this to a fixed point propagates shortages downstream and frees unused
+ * shares for other consumers. A DAG settles in about depth + 1 iterations, cycles converge geometrically;
+ * every iteration is O(groups + edges).
+ */
+class FACTORYNET_API FProductionChainSolver
+{
+public:
+    // Idempotent - returns the resource's index
+    int32 AddResource(const FDataTableRowHandle& ResourceReference);
+    void AddSupply(int32 ResourceIndex, double RatePerSecond);
+
+    // Returns the group index; results are reported in the same order
+    int32 AddGroup(double CapacityCyclesPerSecond, int32 OutputResourceIndex, double OutputPerCycle);
+    void AddGroupInput(int32 GroupIndex, int32 ResourceIndex, double AmountPerCycle);
+
+    // Fills rates, limits and resource balances; Group fields of OutSolution.Groups are left to the caller
+    bool Solve(FProductionChainSolution& OutSolution, int32 MaxIterations = 256, double Tolerance = 1.0e-6);
+
+private:
+    struct FGroupInput
+    {
+        int32 ResourceIndex = INDEX_NONE;
+        double AmountPerCycle = 0.0;
+    };
+
+    struct FGroup
+    {
+        double Capacity = 0.0;
+        int32 OutputResourceIndex = INDEX_NONE;
+        double OutputPerCycle = 0.0;
+        TArray<FGroupInput, TInlineAllocator<4>> Inputs;
+    };
+
+    void ComputeAvailability(const TArray<double>& Rates, TArray<double>& OutAvailable) const;
+
+    TArray<FDataTableRowHandle> Resources;
+    TMap<FDataTableRowHandle, int32> ResourceIndexByReference;
+    TArray<double> Supplies;
+    TArray<FGroup> Groups;
+};
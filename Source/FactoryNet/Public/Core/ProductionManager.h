@@ -0,0 +1,252 @@
+// ProductionManager.h
+// Lokalizacja: Source/FactoryNet/Public/Core/ProductionManager.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/DataTable.h"
+#include "Core/ProductionChainSolver.h"
+#include "ProductionManager.generated.h"
+
+// Forward declarations
+class UDataTableManager;
+class UFactoryDefinition;
+class UResourceStorageComponent;
+
+UENUM(BlueprintType)
+enum class EFactoryProductionStatus : uint8
+{
+    Idle            UMETA(DisplayName = "Idle"),            // no recipe assigned
+    Producing       UMETA(DisplayName = "Producing"),
+    StarvedInput    UMETA(DisplayName = "Starved Input"),   // next cycle lacks inputs
+    OutputBlocked   UMETA(DisplayName = "Output Blocked")   // finished cycle does not fit into output storage
+};
+
+/**
+ * Runs every factory's production in one batched pass - no actor, no per-factory tick.
+ *
+ * Factory state lives in parallel arrays indexed by a dense slot (recipe, progress, input buffers,
+ * output buffer, status). Stable factory IDs map to slots; removal swap-removes like
+ * UDepositExtractionManager. Recipes are compiled once from FProductionRecipe rows into a flat table.
+ *
+ * The simulation advances in fixed steps (60 Hz by default, independent of frame rate). Each step is a
+ * ParallelFor over slot chunks; a slot only writes its own entries, so no locking is needed. Inputs are
+ * consumed when a cycle starts, output is delivered when it ends; a finished cycle that does not fit
+ * into output storage holds until TakeFactoryOutput frees space. Only the authority simulates.
+ *
+ * Factories that cannot progress (starved, blocked, no recipe) are parked: slots are partitioned into
+ * [0, NumActiveSlots) active and the rest sleeping, so a step only touches active factories and parked
+ * ones cost nothing per frame. A parked factory wakes when its wait condition may have changed:
+ *  - AddFactoryInput / TakeFactoryOutput / SetFactoryRecipe / SetFactoryLevel on the factory itself,
+ *  - OnStorageContentsChanged of the storage it waits on (BindFactoryStorage). Queues are keyed by
+ *    (storage, resource): a starved factory waits for the first input the storage cannot cover, a blocked
+ *    one for its output resource, so a change only checks factories waiting for that resource. Output
+ *    space is shared by all resources of a storage, so blocked factories are also checked whenever their
+ *    storage changes and is not full.
+ * Bound storages are used as ports: inputs are pulled from the input storage and finished output is
+ * pushed to the output storage when the factory's own buffer runs out / fills up.
+ */
+UCLASS()
+class FACTORYNET_API UProductionManager : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    UProductionManager();
+
+    // USubsystem Interface
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+    // FTickableGameObject Interface
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    // Recipes with more inputs are rejected by SetFactoryRecipe
+    static constexpr int32 MaxRecipeInputs = 4;
+
+    // === FACTORIES ===
+    // Returns the new factory ID or INDEX_NONE
+    UFUNCTION(BlueprintCallable, Category = "Production")
+    int32 AddFactory(UFactoryDefinition* FactoryDefinition, int32 Level = 1);
+
+    UFUNCTION(BlueprintCallable, Category = "Production")
+    bool RemoveFactory(int32 FactoryId);
+
+    // Buffers and progress of the previous recipe are discarded
+    UFUNCTION(BlueprintCallable, Category = "Production")
+    bool SetFactoryRecipe(int32 FactoryId, const FDataTableRowHandle& RecipeReference);
+
+    // A downgrade below the recipe's RequiredFactoryLevel clears the recipe
+    UFUNCTION(BlueprintCallable, Category = "Production")
+    bool SetFactoryLevel(int32 FactoryId, int32 NewLevel);
+
+    // Storages the factory pulls inputs from / pushes output to; nullptr unbinds
+    UFUNCTION(BlueprintCallable, Category = "Production")
+    bool BindFactoryStorage(int32 FactoryId, UResourceStorageComponent* InputStorage, UResourceStorageComponent* OutputStorage);
+
+    // === BUFFERS ===
+    // Returns the amount accepted (limited by MaxInputStorage of the factory level)
+    UFUNCTION(BlueprintCallable, Category = "Production")
+    int32 AddFactoryInput(int32 FactoryId, const FDataTableRowHandle& ResourceReference, int32 Amount);
+
+    // Returns the amount actually taken from the output buffer
+    UFUNCTION(BlueprintCallable, Category = "Production")
+    int32 TakeFactoryOutput(int32 FactoryId, int32 MaxAmount);
+
+    // === QUERIES ===
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Production")
+    bool IsValidFactory(int32 FactoryId) const;
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Production")
+    EFactoryProductionStatus GetFactoryStatus(int32 FactoryId) const;
+
+    // 0..1 of the current cycle
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Production")
+    float GetFactoryProgress(int32 FactoryId) const;
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Production")
+    int32 GetFactoryInputAmount(int32 FactoryId, const FDataTableRowHandle& ResourceReference) const;
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Production")
+    int32 GetFactoryOutputAmount(int32 FactoryId) const;
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Production")
+    FDataTableRowHandle GetFactoryOutputResource(int32 FactoryId) const;
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Production")
+    int32 GetNumFactories() const { return Definitions.Num(); }
+
+    // Factories simulated each step - the rest are parked in wait queues
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Production")
+    int32 GetNumActiveFactories() const { return NumActiveSlots; }
+
+    // Cycles completed / energy used by all factories during the last Tick
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Production")
+    int32 GetLastCompletedCycleCount() const { return LastCompletedCycleCount; }
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Production")
+    float GetLastEnergyUsage() const { return LastEnergyUsage; }
+
+    // === PLANNING ===
+    // Steady-state rates, bottlenecks and resource balance of a planned chain - nothing is simulated
+    UFUNCTION(BlueprintCallable, Category = "Production|Planning")
+    FProductionChainSolution SolveSteadyState(const TArray<FProductionChainGroup>& Groups, const TArray<FProductionChainSupply>& Supplies);
+
+    // Same for the registered factories, grouped by recipe, definition and level
+    UFUNCTION(BlueprintCallable, Category = "Production|Planning")
+    FProductionChainSolution SolveCurrentSteadyState(const TArray<FProductionChainSupply>& Supplies);
+
+    // === CONFIGURATION ===
+    UFUNCTION(BlueprintCallable, Category = "Production")
+    void SetFixedStepRate(float StepsPerSecond);
+
+    // === SIMULATION (C++ only) ===
+    // One fixed step for all factories - exposed for headless runs and benchmarks
+    void SimulateStep(float StepSeconds);
+
+private:
+    // Flat copy of an FProductionRecipe row - the simulation never touches the DataTable
+    struct FCompiledRecipe
+    {
+        FDataTableRowHandle RecipeReference;
+        FDataTableRowHandle OutputResource;
+        FDataTableRowHandle InputResources[MaxRecipeInputs];
+        int32 InputQuantities[MaxRecipeInputs] = {};
+        int32 NumInputs = 0;
+        int32 OutputQuantity = 1;
+        float ProductionTime = 1.0f;
+        float EnergyRequired = 0.0f;
+        int32 RequiredFactoryLevel = 1;
+    };
+
+    int32 FindOrCompileRecipe(const FDataTableRowHandle& RecipeReference);
+    int32 FindInputIndex(int32 Slot, const FDataTableRowHandle& ResourceReference) const;
+    int32 GetSlot(int32 FactoryId) const;
+    void ApplyLevel(int32 Slot);
+    void ResetProduction(int32 Slot);
+    void SimulateRange(int32 FirstSlot, int32 EndSlot, float StepSeconds, int32& OutCompletedCycles, double& OutEnergy,
+                       TArray<int32>& OutSlotsToPark);
+
+    // === SCHEDULING ===
+    void SwapSlots(int32 SlotA, int32 SlotB);
+    void WakeFactory(int32 FactoryId);
+    void ParkSlot(int32 Slot);
+    bool TryResolveWait(int32 Slot);
+    bool PullInputsFromStorage(int32 Slot);
+    bool PushOutputToStorage(int32 Slot);
+    bool HasAllInputs(int32 Slot) const;
+    bool HasOutputSpace(int32 Slot) const;
+    FName FindMissingInput(int32 Slot) const;
+    void EnqueueWait(int32 Slot);
+    void RemoveFromWaitQueue(int32 Slot);
+    void ProcessPendingWakes();
+
+    void SubscribeStorage(UResourceStorageComponent* Storage);
+    void UnsubscribeStorage(const UResourceStorageComponent* Storage);
+    void HandleStorageChanged(UResourceStorageComponent* Storage, const FDataTableRowHandle& ResourceType);
+
+    UPROPERTY()
+    UDataTableManager* DataTableManager;
+
+    // === SOA STATE (indexed by slot) ===
+    UPROPERTY()
+    TArray<UFactoryDefinition*> Definitions;
+
+    TArray<int32> FactoryIds;           // slot -> ID
+    TArray<int32> Levels;
+    TArray<int32> RecipeIndices;        // INDEX_NONE = no recipe
+    TArray<float> SpeedMultipliers;
+    TArray<float> EnergyMultipliers;
+    TArray<float> Progress;             // seconds of the current cycle at speed 1.0
+    TArray<uint8> CycleActive;          // inputs of the current cycle already consumed
+    TArray<int32> InputAmounts;         // MaxRecipeInputs entries per slot
+    TArray<int32> OutputAmounts;
+    TArray<int32> MaxInputStorage;
+    TArray<int32> MaxOutputStorage;
+    TArray<EFactoryProductionStatus> Statuses;
+    TArray<TWeakObjectPtr<UResourceStorageComponent>> InputStorages;
+    TArray<TWeakObjectPtr<UResourceStorageComponent>> OutputStorages;
+    TArray<const UResourceStorageComponent*> WaitingOnStorage;  // queue the parked factory is in, or nullptr
+    TArray<FName> WaitingOnResource;    // RowName of that queue's resource
+    TArray<uint8> WaitingForOutput;     // queued for output space rather than an input
+
+    int32 NumActiveSlots = 0;
+
+    // === ID MAPPING ===
+    TArray<int32> SlotByFactoryId;      // INDEX_NONE for free IDs
+    TArray<int32> FreeFactoryIds;
+
+    // === RECIPES ===
+    TArray<FCompiledRecipe> Recipes;
+    TMap<FDataTableRowHandle, int32> RecipeIndexByReference;
+
+    // === WAIT QUEUES ===
+    struct FStorageSubscription
+    {
+        TWeakObjectPtr<UResourceStorageComponent> Storage;
+        FDelegateHandle Handle;
+        int32 NumBindings = 0;
+
+        TMap<FName, TArray<int32>> FactoriesWaitingOnResource;  // factory IDs by resource RowName
+        int32 NumBlockedOutputs = 0;    // OutputBlocked factories in those queues
+    };
+
+    // (storage, resource RowName) - NAME_None stands for every queue of the storage
+    using FStorageWaitKey = TPair<const UResourceStorageComponent*, FName>;
+
+    TMap<const UResourceStorageComponent*, FStorageSubscription> StorageSubscriptions;
+    TSet<FStorageWaitKey> PendingWakes;                             // changed since the last Tick
+    TSet<const UResourceStorageComponent*> PendingOutputWakes;      // space freed for blocked factories
+
+    // === TIME ===
+    float FixedStepSeconds = 1.0f / 60.0f;
+    int32 MaxStepsPerTick = 4;          // prevents a spiral of death after a hitch - the rest is dropped
+    double StepAccumulator = 0.0;
+
+    // Slots per ParallelFor task - small worlds run inline
+    static constexpr int32 SlotsPerTask = 1024;
+
+    int32 LastCompletedCycleCount = 0;
+    float LastEnergyUsage = 0.0f;
+};
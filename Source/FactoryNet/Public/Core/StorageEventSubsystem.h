@@ -0,0 +1,54 @@
+// StorageEventSubsystem.h
+// Lokalizacja: Source/FactoryNet/Public/Core/StorageEventSubsystem.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "StorageEventSubsystem.generated.h"
+
+// Forward declarations
+class UResourceStorageComponent;
+
+/**
+ * End-of-frame event bus for storages with bDeferStorageEvents.
+ *
+ * Deferred storages record the amount each resource had before its first change and queue
+ * themselves here; Tick flushes one aggregated delta per (storage, resource) instead of one
+ * dynamic broadcast per AddResource/RemoveResource. FlushInterval > 0 throttles UI-facing
+ * events further (e.g. 0.25 s for HUD counters).
+ */
+UCLASS()
+class FACTORYNET_API UStorageEventSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    // USubsystem Interface
+    virtual void Deinitialize() override;
+
+    // FTickableGameObject Interface
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    // Called by a deferred storage on its first change since the last flush
+    void QueueStorage(UResourceStorageComponent* Storage);
+
+    UFUNCTION(BlueprintCallable, Category = "Storage Events")
+    void FlushNow();
+
+    // 0 = flush every frame
+    UFUNCTION(BlueprintCallable, Category = "Storage Events")
+    void SetFlushInterval(float NewFlushInterval) { FlushInterval = FMath::Max(0.0f, NewFlushInterval); }
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Storage Events")
+    float GetFlushInterval() const { return FlushInterval; }
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Storage Events")
+    int32 GetNumQueuedStorages() const { return QueuedStorages.Num(); }
+
+private:
+    TArray<TWeakObjectPtr<UResourceStorageComponent>> QueuedStorages;
+
+    float FlushInterval = 0.0f;
+    float TimeSinceLastFlush = 0.0f;
+};
@@ -0,0 +1,79 @@
+// TechUnlockSet.h
+// Lokalizacja: Source/FactoryNet/Public/Core/TechUnlockSet.h
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Compact set of technology IDs (dense integers assigned by UDataTableManager at load time).
+ * Stored as 64-bit words so "are all required techs unlocked" is a word-wide AND per 64 techs.
+ *
+ * The same type is used for both sides of a check: the player's unlocked techs and the
+ * precomputed requirement mask of a building/recipe/upgrade. A requirement that references
+ * a tech without an ID is flagged as unresolved and never satisfied by a bitset check.
+ */
+struct FACTORYNET_API FTechUnlockSet
+{
+public:
+    FTechUnlockSet() = default;
+
+    // === MODIFICATION ===
+    void Add(int32 TechId);
+    void Remove(int32 TechId);
+    void Reset();
+    void Append(const FTechUnlockSet& Other);
+
+    void MarkUnresolved() { bHasUnresolvedTechs = true; }
+
+    // === QUERIES ===
+    FORCEINLINE bool Contains(int32 TechId) const
+    {
+        if (TechId < 0)
+        {
+            return false;
+        }
+
+        const int32 WordIndex = TechId >> WordShift;
+        return Words.IsValidIndex(WordIndex) && (Words[WordIndex] & (1ULL << (TechId & WordMask))) != 0;
+    }
+
+    // True if every tech in Required is also in this set
+    FORCEINLINE bool ContainsAll(const FTechUnlockSet& Required) const
+    {
+        if (Required.bHasUnresolvedTechs)
+        {
+            return false;
+        }
+
+        const int32 NumWords = Words.Num();
+        for (int32 WordIndex = 0; WordIndex < Required.Words.Num(); ++WordIndex)
+        {
+            const uint64 OwnedWord = WordIndex < NumWords ? Words[WordIndex] : 0;
+            if ((Required.Words[WordIndex] & ~OwnedWord) != 0)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Tech IDs from Required that are missing in this set
+    void GetMissing(const FTechUnlockSet& Required, TArray<int32>& OutMissingTechIds) const;
+
+    // Iterates set tech IDs in ascending order
+    void GetTechIds(TArray<int32>& OutTechIds) const;
+
+    int32 Num() const;
+    bool IsEmpty() const;
+    bool HasUnresolvedTechs() const { return bHasUnresolvedTechs; }
+
+private:
+    static constexpr int32 WordShift = 6;
+    static constexpr int32 WordMask = 63;
+
+    // 4 words inline = 256 techs without a heap allocation
+    TArray<uint64, TInlineAllocator<4>> Words;
+
+    bool bHasUnresolvedTechs = false;
+};
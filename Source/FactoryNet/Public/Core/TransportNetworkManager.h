@@ -0,0 +1,171 @@
+// TransportNetworkManager.h
+// Lokalizacja: Source/FactoryNet/Public/Core/TransportNetworkManager.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Data/TransportData.h"
+#include "TransportNetworkManager.generated.h"
+
+// Forward declarations
+class UDataTableManager;
+class UHubDefinition;
+
+/**
+ * Hub-to-hub transport network compiled from FTransportRoute rows, with shortest-path queries for dispatch.
+ *
+ * Hubs get dense IDs (keyed by soft path, like the DataTableManager route indexes) and routes get stable
+ * route IDs. Every ETransportType has its own directed graph in CSR form (outgoing and incoming edges as
+ * flat arrays), so a search touches contiguous memory only.
+ *
+ * Queries run A* with ALT lower bounds: per graph a few landmarks are picked by farthest-point selection
+ * and the exact distance from/to every hub is stored (hub-major, all landmarks of a hub side by side).
+ * The triangle inequality over those distances gives a consistent heuristic, and proves unreachability
+ * without any search.
+ *
+ * Changes are repaired lazily, on the next query of the affected graph:
+ *  - SetRouteActive(false) only masks the edge - landmark distances can only get smaller than the truth,
+ *    so the bounds stay admissible and nothing is recomputed,
+ *  - AddRoute rebuilds the CSR of that transport type (O(routes)); inactive routes stay in the CSR,
+ *  - AddRoute / SetRouteActive(true) repair the landmark distances with a Dijkstra seeded at the new edge
+ *    that visits only hubs that got closer.
+ * The network is compiled from TransportDataTable at startup and again whenever the tables are reloaded.
+ * Search scratch buffers are reused between queries (epoch-stamped), so the manager is game-thread only.
+ */
+UCLASS()
+class FACTORYNET_API UTransportNetworkManager : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    UTransportNetworkManager();
+
+    // USubsystem Interface
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+    // Landmarks per transport type (fewer in graphs with fewer hubs)
+    static constexpr int32 MaxLandmarks = 8;
+
+    // === NETWORK ===
+    // Drops runtime routes and recompiles the network from TransportDataTable
+    UFUNCTION(BlueprintCallable, Category = "Transport Network")
+    void RebuildNetwork();
+
+    // Returns the new route ID or INDEX_NONE
+    UFUNCTION(BlueprintCallable, Category = "Transport Network")
+    int32 AddRoute(const FTransportRoute& Route);
+
+    UFUNCTION(BlueprintCallable, Category = "Transport Network")
+    bool SetRouteActive(int32 RouteId, bool bActive);
+
+    // === QUERIES ===
+    // Hubs from start to end (both included); false if no active path exists
+    UFUNCTION(BlueprintCallable, Category = "Transport Network")
+    bool FindPath(UHubDefinition* FromHub, UHubDefinition* ToHub, ETransportType TransportType,
+                  TArray<TSoftObjectPtr<UHubDefinition>>& OutHubs, float& OutDistance);
+
+    // -1 if ToHub is unreachable
+    UFUNCTION(BlueprintCallable, Category = "Transport Network")
+    float GetPathDistance(UHubDefinition* FromHub, UHubDefinition* ToHub, ETransportType TransportType);
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Transport Network")
+    int32 GetNumHubs() const { return HubPaths.Num(); }
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Transport Network")
+    int32 GetNumRoutes() const { return RouteTypes.Num(); }
+
+    // === QUERIES (C++ only) ===
+    int32 GetHubId(const FSoftObjectPath& HubPath) const;
+    FSoftObjectPath GetHubPath(int32 HubId) const;
+    int32 GetRouteStartHubId(int32 RouteId) const;
+    int32 GetRouteEndHubId(int32 RouteId) const;
+    bool IsRouteActive(int32 RouteId) const;
+
+    // OutHubIds has one more entry than OutRouteIds
+    bool FindPathByHubIds(int32 FromHubId, int32 ToHubId, ETransportType TransportType,
+                          TArray<int32>& OutHubIds, TArray<int32>& OutRouteIds, float& OutDistance);
+
+    // Admissible ALT estimate - 0 when nothing is known, -1 if ToHub is provably unreachable
+    float GetDistanceLowerBound(int32 FromHubId, int32 ToHubId, ETransportType TransportType);
+
+private:
+    // Route table reloaded (RefreshDataTables) - runtime routes are dropped with it
+    UFUNCTION()
+    void HandleDataTablesLoaded();
+
+    struct FTransportGraph
+    {
+        TArray<int32> RouteIds;                 // every route of this type, active or not
+
+        // CSR: edges of hub H are [Offsets[H], Offsets[H + 1])
+        TArray<int32> OutOffsets;
+        TArray<int32> OutRoutes;
+        TArray<int32> OutTargets;
+        TArray<float> OutCosts;
+        TArray<int32> InOffsets;
+        TArray<int32> InRoutes;
+        TArray<int32> InSources;
+        TArray<float> InCosts;
+
+        // ALT: [Hub * NumLandmarks + Landmark]
+        TArray<int32> Landmarks;
+        TArray<float> FromLandmark;
+        TArray<float> ToLandmark;
+        int32 NumLandmarks = 0;
+
+        int32 NumHubs = 0;
+        bool bAdjacencyDirty = false;
+        bool bLandmarksDirty = false;
+        TArray<int32> PendingRepairRoutes;      // added / reactivated since the landmarks were built
+    };
+
+    struct FSearchNode
+    {
+        float Priority;                         // cost + estimate (just cost for landmark searches)
+        float Cost;
+        int32 Hub;
+
+        bool operator<(const FSearchNode& Other) const { return Priority < Other.Priority; }
+    };
+
+    int32 AddRouteInternal(const FTransportRoute& Route);
+    int32 FindOrAddHub(const FSoftObjectPath& HubPath);
+    FTransportGraph* GetGraph(ETransportType TransportType);
+
+    // === GRAPH MAINTENANCE ===
+    void PrepareGraph(FTransportGraph& Graph);
+    void RebuildAdjacency(FTransportGraph& Graph);
+    void BuildLandmarks(FTransportGraph& Graph);
+    void RepairLandmarks(FTransportGraph& Graph);
+    void RelaxLandmarkDistances(const FTransportGraph& Graph, bool bReverse, int32 LandmarkIndex, TArray<float>& Distances,
+                                int32 SeedHub, float SeedDistance);
+    float EstimateDistance(const FTransportGraph& Graph, int32 Hub, int32 TargetHub) const;
+
+    void BeginSearch(int32 NumHubs);
+    bool IsSearchVisited(int32 Hub) const { return SearchStamps[Hub] == SearchEpoch; }
+
+    UPROPERTY()
+    UDataTableManager* DataTableManager;
+
+    // === HUBS ===
+    TArray<FSoftObjectPath> HubPaths;
+    TMap<FSoftObjectPath, int32> HubIdByPath;
+
+    // === ROUTES (SOA, indexed by route ID) ===
+    TArray<int32> RouteStartHubs;
+    TArray<int32> RouteEndHubs;
+    TArray<ETransportType> RouteTypes;
+    TArray<float> RouteCosts;
+    TArray<uint8> RouteActive;
+
+    // Indexed by ETransportType
+    TArray<FTransportGraph> Graphs;
+
+    // === SEARCH SCRATCH ===
+    TArray<float> SearchCosts;
+    TArray<int32> SearchParentRoutes;
+    TArray<uint32> SearchStamps;
+    TArray<FSearchNode> SearchHeap;
+    uint32 SearchEpoch = 0;
+};
@@ -73,7 +73,7 @@ struct FACTORYNET_API FDemandLevel
 };
 
 UCLASS(BlueprintType)
-class FACTORYNET_API UDemandDefinition : public UDataAsset
+class FACTORYNET_API UDemandDefinition : public UPrimaryDataAsset
 {
     GENERATED_BODY()
 
@@ -134,4 +134,6 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Requirements", 
               meta = (RowType = "UpgradeTableRow"))
     TArray<FDataTableRowHandle> RequiredTechnologies;
+
+    static const FPrimaryAssetType PrimaryAssetType;
 };
\ No newline at end of file
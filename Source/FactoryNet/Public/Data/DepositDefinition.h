@@ -43,7 +43,7 @@ struct FACTORYNET_API FDepositLevel
 };
 
 UCLASS(BlueprintType)
-class FACTORYNET_API UDepositDefinition : public UDataAsset
+class FACTORYNET_API UDepositDefinition : public UPrimaryDataAsset
 {
     GENERATED_BODY()
 
@@ -104,4 +104,12 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Requirements", 
               meta = (RowType = "UpgradeTableRow"))
     TArray<FDataTableRowHandle> RequiredTechnologies;
+
+    // Dane poziomu (od 1); poza zakresem DepositLevels - wartości domyślne
+    FDepositLevel GetLevelData(int32 Level) const;
+
+    // Mesh poziomu, a jeśli nie ustawiony - BaseMesh
+    TSoftObjectPtr<UStaticMesh> GetLevelMesh(int32 Level) const;
+
+    static const FPrimaryAssetType PrimaryAssetType;
 };
\ No newline at end of file
@@ -47,7 +47,7 @@ struct FACTORYNET_API FFactoryLevel
 };
 
 UCLASS(BlueprintType)
-class FACTORYNET_API UFactoryDefinition : public UDataAsset
+class FACTORYNET_API UFactoryDefinition : public UPrimaryDataAsset
 {
     GENERATED_BODY()
 
@@ -96,4 +96,9 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Requirements", 
               meta = (RowType = "UpgradeTableRow"))
     TArray<FDataTableRowHandle> RequiredTechnologies;
+
+    // Dane poziomu (od 1); poza zakresem FactoryLevels - wartości domyślne
+    FFactoryLevel GetLevelData(int32 Level) const;
+
+    static const FPrimaryAssetType PrimaryAssetType;
 };
\ No newline at end of file
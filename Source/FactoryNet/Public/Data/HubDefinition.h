@@ -48,7 +48,7 @@ struct FACTORYNET_API FHubLevel
 };
 
 UCLASS(BlueprintType)
-class FACTORYNET_API UHubDefinition : public UDataAsset
+class FACTORYNET_API UHubDefinition : public UPrimaryDataAsset
 {
     GENERATED_BODY()
 
@@ -96,4 +96,6 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Requirements", 
               meta = (RowType = "UpgradeTableRow"))
     TArray<FDataTableRowHandle> RequiredTechnologies;
+
+    static const FPrimaryAssetType PrimaryAssetType;
 };
\ No newline at end of file
@@ -12,7 +12,7 @@
 #include "RoadDefinition.generated.h"
 
 UCLASS(BlueprintType)
-class FACTORYNET_API URoadDefinition : public UDataAsset
+class FACTORYNET_API URoadDefinition : public UPrimaryDataAsset
 {
     GENERATED_BODY()
 
@@ -69,4 +69,6 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Requirements", 
               meta = (RowType = "UpgradeTableRow"))
     TArray<FDataTableRowHandle> RequiredTechnologies;
+
+    static const FPrimaryAssetType PrimaryAssetType;
 };
\ No newline at end of file
@@ -14,7 +14,7 @@
 class URoadDefinition;
 
 UCLASS(BlueprintType)
-class FACTORYNET_API UVehicleDefinition : public UDataAsset
+class FACTORYNET_API UVehicleDefinition : public UPrimaryDataAsset
 {
     GENERATED_BODY()
 
@@ -76,4 +76,6 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Requirements", 
               meta = (RowType = "UpgradeTableRow"))
     TArray<FDataTableRowHandle> RequiredTechnologies;
+
+    static const FPrimaryAssetType PrimaryAssetType;
 };
\ No newline at end of file